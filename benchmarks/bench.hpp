@@ -0,0 +1,31 @@
+#pragma once
+// Timing helpers shared by the micro-benchmarks in this directory.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int ROUNDS = 7;
+
+// ns per call of body(i); best of ROUNDS (the machine is shared)
+template <typename Body>
+double measure(size_t iterations, Body&& body) {
+    double best = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; i++) body(i);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() /
+                    static_cast<double>(iterations);
+        if (round == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+// Debug-build numbers say little about the code; flag them before printing any
+inline void warn_if_unoptimized() {
+#ifndef __OPTIMIZE__
+    std::printf("warning: unoptimized build, configure with -DCMAKE_BUILD_TYPE=Release\n");
+#endif
+}
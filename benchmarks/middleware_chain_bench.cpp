@@ -0,0 +1,111 @@
+// Cost of a route's middleware chain against the number of middlewares:
+// Request construction, MiddlewareChain::run_before(), the handler and
+// run_after(), the way the framework runs them for every request. A route
+// with an empty chain should cost the same as calling the handler alone.
+//
+// Build with -DCMAKE_BUILD_TYPE=Release and run:  ./bench_middleware_chain [iterations]
+
+#include "restapi.hpp"
+#include "http/request.hpp"
+#include "bench.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace RestAPI;
+
+namespace {
+
+constexpr int COUNTS[] = {0, 1, 2, 4, 8, 16};
+
+Response handler(const Request& req) {
+    Response res;
+    res.status = 200 + static_cast<int>(req.params.size());
+    return res;
+}
+
+// Same sequence as the framework's route wrappers
+Response run(const MiddlewareChain& chain, Request& req) {
+    if (chain.empty()) {
+        return handler(req);
+    }
+    Response res;
+    if (chain.run_before(req, res)) {
+        res = handler(req);
+    }
+    chain.run_after(req, res);
+    return res;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+
+    warn_if_unoptimized();
+
+    HttpRequest http_req;
+    http_req.method = "GET";
+    http_req.target = "/api/products/42?verbose=1";
+    http_req.path = "/api/products/42";
+    http_req.headers["Host"] = "localhost";
+    http_req.headers["Authorization"] = "Bearer token";
+    http_req.headers["Accept"] = "application/json";
+
+    long checksum = 0;
+    long touched = 0;
+
+    // Middlewares that do almost nothing, so the chain itself is measured
+    auto middleware = [&touched](Request&, Response&) {
+        touched++;
+        return true;
+    };
+    auto hook = [&touched](const Request&, Response& res) { touched += res.status; };
+
+    // A realistic check: one header lookup per request
+    auto auth = [](Request& req, Response& res) {
+        if (!req.header("authorization").empty()) return true;
+        res = Response::json(401, "{\"error\":\"Unauthorized\"}");
+        return false;
+    };
+
+    std::printf("%zu iterations, best of %d\n\n", iterations, ROUNDS);
+
+    double bare = measure(iterations, [&](size_t) {
+        Request req(http_req);
+        checksum += handler(req).status;
+    });
+    std::printf("%-40s %8.1f ns\n\n", "Request + handler, no chain", bare);
+
+    std::printf("%-14s %14s %18s %14s\n", "middlewares", "before (ns)", "before+after (ns)", "auth (ns)");
+    for (int count : COUNTS) {
+        MiddlewareChain before;
+        MiddlewareChain both;
+        MiddlewareChain checks;
+        for (int i = 0; i < count; i++) {
+            before.use(middleware);
+            both.use(middleware);
+            both.after(hook);
+            checks.use(auth);
+        }
+
+        double ns_before = measure(iterations, [&](size_t) {
+            Request req(http_req);
+            checksum += run(before, req).status;
+        });
+        double ns_both = measure(iterations, [&](size_t) {
+            Request req(http_req);
+            checksum += run(both, req).status;
+        });
+        double ns_auth = measure(iterations, [&](size_t) {
+            Request req(http_req);
+            checksum += run(checks, req).status;
+        });
+
+        std::printf("%-14d %14.1f %18.1f %14.1f\n", count, ns_before, ns_both, ns_auth);
+    }
+
+    std::printf("\n(checksum %ld, %ld)\n", checksum, touched);
+    return 0;
+}
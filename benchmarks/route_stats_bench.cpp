@@ -0,0 +1,103 @@
+// Cost of per-route instrumentation: RouteStats::record() alone, and the
+// full Router::recordRequest() (clock read, status parse, record) that the
+// worker runs once per request. Target: well under 50 ns per request.
+//
+// Build with -DCMAKE_BUILD_TYPE=Release and run:  ./bench_route_stats [iterations]
+
+#include "http/router.hpp"
+#include "http/routestats.hpp"
+#include "bench.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t ROUTES = 24;
+
+// measure() with `threads` threads of one worker recording into the same rows
+template <typename Body>
+double measure_threads(size_t iterations, int threads, Body&& body) {
+    double best = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        std::atomic<bool> go{false};
+        std::vector<std::thread> pool;
+        for (int t = 0; t < threads; t++) {
+            pool.emplace_back([&, t] {
+                while (!go.load()) std::this_thread::yield();
+                for (size_t i = 0; i < iterations; i++) body(i + static_cast<size_t>(t));
+            });
+        }
+        auto start = Clock::now();
+        go = true;
+        for (auto& thread : pool) thread.join();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() /
+                    static_cast<double>(iterations * static_cast<size_t>(threads));
+        if (round == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+
+    warn_if_unoptimized();
+
+    Router router;
+    for (size_t i = 0; i < ROUTES; i++) {
+        router.addRoute("GET", "/api/r" + std::to_string(i) + "/:id",
+                        [](const HttpRequest&, const RouteParams&) { return std::string(); });
+    }
+
+    RouteStats stats(router.routeCount(), 4);
+    stats.set_worker(1);
+    router.setStats(&stats);
+
+    const std::string response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                                 "Content-Length: 2\r\nConnection: close\r\n\r\n{}";
+
+    // Latencies spread over many histogram buckets
+    std::vector<uint64_t> latencies(1024);
+    for (size_t i = 0; i < latencies.size(); i++) {
+        latencies[i] = (i * 2654435761u) % 50000;
+    }
+
+    std::printf("%zu routes, %zu iterations, best of %d\n\n", ROUTES, iterations, ROUNDS);
+
+    double clock_only = measure(iterations, [&](size_t) {
+        auto t = Clock::now();
+        asm volatile("" : : "r"(&t) : "memory");
+    });
+
+    double record = measure(iterations, [&](size_t i) {
+        stats.record(i % ROUTES, 200, latencies[i & 1023], 180, response.size());
+    });
+
+    auto start = Clock::now();
+    double record_request = measure(iterations, [&](size_t i) {
+        router.recordRequest(&router.routeAt(i % ROUTES), response, start, 180);
+    });
+
+    double contended = measure_threads(iterations / 4, 4, [&](size_t i) {
+        stats.record(i % ROUTES, 200, latencies[i & 1023], 180, response.size());
+    });
+
+    std::printf("%-40s %8.1f ns\n", "steady_clock::now()", clock_only);
+    std::printf("%-40s %8.1f ns\n", "RouteStats::record", record);
+    std::printf("%-40s %8.1f ns\n", "Router::recordRequest (clock + record)", record_request);
+    std::printf("%-40s %8.1f ns\n", "RouteStats::record, 4 threads", contended);
+
+    RouteStatsSnapshot s = stats.snapshot(0);
+    std::printf("\n(route 0: %llu requests, p50 %llu us, p99 %llu us)\n",
+                static_cast<unsigned long long>(s.requests),
+                static_cast<unsigned long long>(s.percentile_us(0.50)),
+                static_cast<unsigned long long>(s.percentile_us(0.99)));
+    return 0;
+}
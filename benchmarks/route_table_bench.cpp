@@ -0,0 +1,212 @@
+// Route lookup + dispatch: dynamic Router (radix tree, std::function handlers)
+// against a compile-time RestAPI::RouteTable (perfect hash, direct calls).
+//
+// Build with -DCMAKE_BUILD_TYPE=Release and run:  ./bench_route_table [iterations]
+
+#include "restapi.hpp"
+#include "restapi_routes.hpp"
+#include "http/router.hpp"
+#include "bench.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace RestAPI;
+
+namespace {
+
+// Each handler returns a distinct status so the results can be checked
+template <int Status>
+Response handler(const Request& req) {
+    Response r;
+    r.status = Status + static_cast<int>(req.params.size());
+    return r;
+}
+
+struct RouteDef {
+    const char* method;
+    const char* pattern;
+    StaticHandler fn;
+};
+
+// A typical service: collections, items, nested resources, a few literals
+// next to parameters (precedence) and a deep path
+const RouteDef ROUTES[] = {
+    {"GET", "/", &handler<200>},
+    {"GET", "/health", &handler<201>},
+    {"GET", "/api/products", &handler<202>},
+    {"POST", "/api/products", &handler<203>},
+    {"GET", "/api/products/active", &handler<204>},
+    {"GET", "/api/products/:id", &handler<205>},
+    {"PUT", "/api/products/:id", &handler<206>},
+    {"DELETE", "/api/products/:id", &handler<207>},
+    {"PUT", "/api/products/:id/stock", &handler<208>},
+    {"GET", "/api/products/category/:category", &handler<209>},
+    {"GET", "/api/products/search/:keyword", &handler<210>},
+    {"GET", "/api/orders", &handler<211>},
+    {"POST", "/api/orders", &handler<212>},
+    {"GET", "/api/orders/:id", &handler<213>},
+    {"GET", "/api/orders/:id/items", &handler<214>},
+    {"GET", "/api/orders/:id/items/:item", &handler<215>},
+    {"GET", "/api/users", &handler<216>},
+    {"GET", "/api/users/me", &handler<217>},
+    {"GET", "/api/users/:id", &handler<218>},
+    {"PUT", "/api/users/:id", &handler<219>},
+    {"GET", "/api/users/:id/orders", &handler<220>},
+    {"GET", "/api/sensors/:id/readings/latest", &handler<221>},
+    {"GET", "/api/sensors/:id/readings/:from/:to", &handler<222>},
+    {"GET", "/api/v2/accounts/:account/transactions/:tx/receipt", &handler<223>},
+};
+
+constexpr auto TABLE = make_route_table(
+    routes::get("/", &handler<200>),
+    routes::get("/health", &handler<201>),
+    routes::get("/api/products", &handler<202>),
+    routes::post("/api/products", &handler<203>),
+    routes::get("/api/products/active", &handler<204>),
+    routes::get("/api/products/:id", &handler<205>),
+    routes::put("/api/products/:id", &handler<206>),
+    routes::del("/api/products/:id", &handler<207>),
+    routes::put("/api/products/:id/stock", &handler<208>),
+    routes::get("/api/products/category/:category", &handler<209>),
+    routes::get("/api/products/search/:keyword", &handler<210>),
+    routes::get("/api/orders", &handler<211>),
+    routes::post("/api/orders", &handler<212>),
+    routes::get("/api/orders/:id", &handler<213>),
+    routes::get("/api/orders/:id/items", &handler<214>),
+    routes::get("/api/orders/:id/items/:item", &handler<215>),
+    routes::get("/api/users", &handler<216>),
+    routes::get("/api/users/me", &handler<217>),
+    routes::get("/api/users/:id", &handler<218>),
+    routes::put("/api/users/:id", &handler<219>),
+    routes::get("/api/users/:id/orders", &handler<220>),
+    routes::get("/api/sensors/:id/readings/latest", &handler<221>),
+    routes::get("/api/sensors/:id/readings/:from/:to", &handler<222>),
+    routes::get("/api/v2/accounts/:account/transactions/:tx/receipt", &handler<223>));
+
+struct Probe {
+    const char* method;
+    const char* path;
+};
+
+const Probe PROBES[] = {
+    {"GET", "/health"},
+    {"GET", "/api/products"},
+    {"GET", "/api/products/active"},
+    {"GET", "/api/products/1842"},
+    {"DELETE", "/api/products/77"},
+    {"PUT", "/api/products/77/stock"},
+    {"GET", "/api/products/category/electronics"},
+    {"GET", "/api/orders/991/items/3"},
+    {"GET", "/api/users/me"},
+    {"GET", "/api/users/42/orders"},
+    {"GET", "/api/sensors/temp-7/readings/latest"},
+    {"GET", "/api/sensors/temp-7/readings/1700000000/1700003600"},
+    {"GET", "/api/v2/accounts/RO49AAAA/transactions/tx-19/receipt"},
+    {"GET", "/api/unknown/path"},                // miss
+    {"POST", "/api/users/42"},                   // miss (method)
+};
+
+constexpr size_t PROBE_COUNT = sizeof(PROBES) / sizeof(PROBES[0]);
+
+// ns per path for one pass of body over PROBES
+template <typename Body>
+double measure_probes(size_t iterations, Body&& body) {
+    return measure(iterations, [&](size_t) {
+        for (const auto& probe : PROBES) body(probe);
+    }) / static_cast<double>(PROBE_COUNT);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+
+    warn_if_unoptimized();
+
+    // Dynamic router, registered the way RestApiFramework::get() does it:
+    // RestAPI::RouteHandler (std::function) inside a Router handler (std::function)
+    Router router;
+    for (const auto& def : ROUTES) {
+        RestAPI::RouteHandler user_handler = def.fn;
+        router.addRoute(def.method, def.pattern,
+                        [user_handler](const HttpRequest&, const RouteParams& params) {
+                            Request req;
+                            for (const auto& param : params) req.params.set(param.name, param.value);
+                            return std::to_string(user_handler(req).status);
+                        });
+    }
+
+    const RouteTableDispatcher<TABLE> table;
+    const RouteTableBase& mounted = table;
+
+    // Both must agree before timing anything
+    for (const auto& probe : PROBES) {
+        RouteParams dynamic_params;
+        const Route* route = router.match(probe.method, probe.path, dynamic_params);
+        RouteMatch static_params;
+        int index = mounted.match(probe.method, probe.path, static_params);
+
+        bool same = (route == nullptr) == (index < 0);
+        if (same && route) {
+            same = route->pattern == std::string(TABLE.routes[index].pattern.text) &&
+                   dynamic_params.size() == static_params.size();
+            for (size_t i = 0; same && i < static_params.size(); i++) {
+                const auto& param = *(dynamic_params.begin() + i);
+                same = param.name == static_params.name(i) && param.value == static_params.value(i);
+            }
+        }
+        if (!same) {
+            std::fprintf(stderr, "mismatch for %s %s\n", probe.method, probe.path);
+            return 1;
+        }
+    }
+
+    std::printf("%zu routes, %zu paths, %zu iterations, best of %d\n\n", std::size(ROUTES), PROBE_COUNT, iterations, ROUNDS);
+    long checksum = 0;
+
+    // Lookup only
+    double dynamic_match = measure_probes(iterations, [&](const Probe& probe) {
+        RouteParams params;
+        const Route* route = router.match(probe.method, probe.path, params);
+        checksum += route ? static_cast<long>(params.size()) + 1 : 0;
+    });
+
+    double static_match = measure_probes(iterations, [&](const Probe& probe) {
+        RouteMatch params;
+        int index = mounted.match(probe.method, probe.path, params);
+        checksum += index >= 0 ? static_cast<long>(params.size()) + 1 : 0;
+    });
+
+    // Lookup + parameters + handler call, as each path runs inside the server
+    HttpRequest http_req;
+    double dynamic_dispatch = measure_probes(iterations, [&](const Probe& probe) {
+        RouteParams params;
+        const Route* route = router.match(probe.method, probe.path, params);
+        if (!route) return;
+        checksum += static_cast<long>(route->handler(http_req, params).size());
+    });
+
+    double static_dispatch = measure_probes(iterations, [&](const Probe& probe) {
+        RouteMatch params;
+        int index = mounted.match(probe.method, probe.path, params);
+        if (index < 0) return;
+        Request req;
+        for (size_t i = 0; i < params.size(); i++) {
+            req.params.set(params.name(i), params.value(i));
+        }
+        checksum += static_cast<long>(std::to_string(mounted.call(index, req).status).size());
+    });
+
+    std::printf("%-22s %12s %12s %9s\n", "", "dynamic", "table", "speedup");
+    std::printf("%-22s %9.1f ns %9.1f ns %8.2fx\n", "match", dynamic_match, static_match,
+                dynamic_match / static_match);
+    std::printf("%-22s %9.1f ns %9.1f ns %8.2fx\n", "match + dispatch", dynamic_dispatch, static_dispatch,
+                dynamic_dispatch / static_dispatch);
+    std::printf("\n(checksum %ld)\n", checksum);
+    return 0;
+}
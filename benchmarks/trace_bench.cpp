@@ -0,0 +1,83 @@
+// Cost of request tracing on the request path: a Trace::Scope span (what the
+// framework puts around middlewares, handlers and queries) with tracing off,
+// on for an unsampled request, and on for a sampled one (two clock reads plus
+// a ring buffer write). Off should cost about nothing.
+//
+// Build with -DCMAKE_BUILD_TYPE=Release and run:  ./bench_trace [iterations]
+
+#include "core/trace.hpp"
+#include "bench.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+// Stand-in for the traced work, kept out of line so the span has something to wrap
+__attribute__((noinline)) long work(size_t i) {
+    return static_cast<long>(i * 2654435761u >> 7);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000000;
+
+    warn_if_unoptimized();
+
+    long checksum = 0;
+    std::printf("%zu iterations, best of %d\n\n", iterations, ROUNDS);
+
+    double bare = measure(iterations, [&](size_t i) { checksum += work(i); });
+    std::printf("%-36s %8.1f ns\n", "no span", bare);
+
+    // Tracing not configured: Scope sees no current request
+    double off = measure(iterations, [&](size_t i) {
+        Trace::Scope span(SpanKind::Handler);
+        checksum += work(i);
+    });
+    std::printf("%-36s %8.1f ns\n", "span, tracing off", off);
+
+    TraceConfig config;
+    config.rings = 4;
+    config.events_per_ring = 4096;
+    Trace::configure(config);
+
+    TraceContext unsampled;
+    Trace::begin(unsampled, "bench");
+    unsampled.sampled = false;
+    double skipped = 0;
+    {
+        Trace::CurrentScope current(&unsampled);
+        skipped = measure(iterations, [&](size_t i) {
+            Trace::Scope span(SpanKind::Handler);
+            checksum += work(i);
+        });
+    }
+    std::printf("%-36s %8.1f ns\n", "span, request not sampled", skipped);
+
+    TraceContext sampled;
+    Trace::begin(sampled, "bench");
+    double recorded = 0;
+    {
+        Trace::CurrentScope current(&sampled);
+        recorded = measure(iterations, [&](size_t i) {
+            Trace::Scope span(SpanKind::Db, "SELECT 1");
+            checksum += work(i);
+        });
+    }
+    std::printf("%-36s %8.1f ns\n", "span, recorded", recorded);
+
+    double begin = measure(iterations / 10, [&](size_t) {
+        TraceContext ctx;
+        Trace::begin(ctx, std::string_view());
+        checksum += ctx.id[0];
+    });
+    std::printf("%-36s %8.1f ns\n", "begin() with a generated ID", begin);
+
+    size_t json = Trace::chrome_json().size();
+    std::printf("\n(checksum %ld, dump %zu bytes, dropped %llu)\n", checksum, json,
+                static_cast<unsigned long long>(Trace::dropped()));
+    return 0;
+}
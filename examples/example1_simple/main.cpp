@@ -38,23 +38,25 @@ int main() {
 
     // ===== ENDPOINT 3: Calculator - Addition =====
     app.get("/add/:a/:b", [](const Request& req) {
-        try {
-            int a = std::stoi(req.getParam("a"));
-            int b = std::stoi(req.getParam("b"));
-            int result = a + b;
-
-            std::ostringstream oss;
-            oss << R"({)"
-                << R"("operation": "addition",)"
-                << R"("a": )" << a << ","
-                << R"("b": )" << b << ","
-                << R"("result": )" << result
-                << R"(})";
-
-            return Response::json(200, oss.str());
-        } catch (...) {
+        auto a_param = req.param<int>("a");
+        auto b_param = req.param<int>("b");
+        if (!a_param || !b_param) {
             return Response::json(400, R"({"error": "Invalid numbers"})");
         }
+
+        int a = *a_param;
+        int b = *b_param;
+        int result = a + b;
+
+        std::ostringstream oss;
+        oss << R"({)"
+            << R"("operation": "addition",)"
+            << R"("a": )" << a << ","
+            << R"("b": )" << b << ","
+            << R"("result": )" << result
+            << R"(})";
+
+        return Response::json(200, oss.str());
     });
 
     // ===== ENDPOINT 4: Calculator - Subtraction =====
@@ -2,7 +2,7 @@
 #include "services/orderservice.hpp"
 #include "http/request.hpp"
 #include <string>
-#include <map>
+#include "http/router.hpp"
 
 class OrderController {
 private:
@@ -16,7 +16,7 @@ private:
 
     // Helper to extract user_id from request (from authentication token/session)
     // For now, we'll extract it from query params or body
-    int extractUserId(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    int extractUserId(const HttpRequest& req, const RouteParams& params);
     
     // Helper to check if user is admin (for now, hardcoded - in production use JWT)
     bool isAdmin(int user_id);
@@ -25,22 +25,22 @@ public:
     explicit OrderController(OrderService& service) : service(service) {}
     
     // POST /api/orders - Create new order (authenticated users)
-    std::string createOrder(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string createOrder(const HttpRequest& req, const RouteParams& params);
     
     // GET /api/orders - List user's orders (or all for admin)
-    std::string getOrders(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string getOrders(const HttpRequest& req, const RouteParams& params);
     
     // GET /api/orders/:id - Get order details with items
-    std::string getOrderById(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string getOrderById(const HttpRequest& req, const RouteParams& params);
     
     // PUT /api/orders/:id/status - Update order status (admin only)
-    std::string updateOrderStatus(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string updateOrderStatus(const HttpRequest& req, const RouteParams& params);
     
     // DELETE /api/orders/:id - Cancel order
-    std::string cancelOrder(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string cancelOrder(const HttpRequest& req, const RouteParams& params);
     
     // GET /api/orders/stats - Order statistics (admin only)
-    std::string getStatistics(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string getStatistics(const HttpRequest& req, const RouteParams& params);
 
     // Set raw request for parsing body
     void setRawRequest(const std::string& raw);
@@ -2,7 +2,7 @@
 #include "services/productservice.hpp"
 #include "http/request.hpp"
 #include <string>
-#include <map>
+#include "http/router.hpp"
 
 class ProductController {
 private:
@@ -21,34 +21,34 @@ public:
     explicit ProductController(ProductService& service) : service(service) {}
 
     // GET /api/products - Get all products (with pagination/filtering)
-    std::string getAll(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string getAll(const HttpRequest& req, const RouteParams& params);
 
     // GET /api/products/:id - Get product by ID
-    std::string getById(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string getById(const HttpRequest& req, const RouteParams& params);
 
     // GET /api/products/search?q=keyword - Search products
-    std::string search(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string search(const HttpRequest& req, const RouteParams& params);
 
     // GET /api/products/category/:category - Get products by category
-    std::string getByCategory(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string getByCategory(const HttpRequest& req, const RouteParams& params);
 
     // GET /api/products/low-stock - Get low stock products
-    std::string getLowStock(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string getLowStock(const HttpRequest& req, const RouteParams& params);
 
     // GET /api/products/active - Get active products
-    std::string getActive(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string getActive(const HttpRequest& req, const RouteParams& params);
 
     // POST /api/products - Create new product (admin only)
-    std::string create(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string create(const HttpRequest& req, const RouteParams& params);
 
     // PUT /api/products/:id - Update product (admin only)
-    std::string update(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string update(const HttpRequest& req, const RouteParams& params);
 
     // PATCH /api/products/:id/stock - Update product stock
-    std::string updateStock(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string updateStock(const HttpRequest& req, const RouteParams& params);
 
     // DELETE /api/products/:id - Delete product (admin only)
-    std::string remove(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string remove(const HttpRequest& req, const RouteParams& params);
 
     // Set raw request for parsing body
     void setRawRequest(const std::string& raw);
@@ -40,7 +40,7 @@ std::string UserController::jsonResponse(int status, const std::string& body) {
     return response.str();
 }
 
-std::string UserController::getAll(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string UserController::getAll(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[UserController] GET /api/users\n";
     
     try {
@@ -65,7 +65,7 @@ std::string UserController::getAll(const HttpRequest& req, const std::map<std::s
     }
 }
 
-std::string UserController::getById(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string UserController::getById(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[UserController] GET /api/users/:id\n";
     
     try {
@@ -75,7 +75,7 @@ std::string UserController::getById(const HttpRequest& req, const std::map<std::
             return jsonResponse(400, "{\"error\":\"ID lipsă\"}");
         }
         
-        int id = std::stoi(it->second);
+        int id = std::stoi(std::string(it->value));
         auto user = service.getUserById(id);
         
         if (!user.has_value()) {
@@ -96,7 +96,7 @@ std::string UserController::getById(const HttpRequest& req, const std::map<std::
     }
 }
 
-std::string UserController::create(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string UserController::create(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[UserController] POST /api/users\n";
     
     try {
@@ -126,7 +126,7 @@ std::string UserController::create(const HttpRequest& req, const std::map<std::s
     }
 }
 
-std::string UserController::update(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string UserController::update(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[UserController] PUT /api/users/:id\n";
     
     try {
@@ -135,7 +135,7 @@ std::string UserController::update(const HttpRequest& req, const std::map<std::s
         if (it == params.end()) {
             return jsonResponse(400, "{\"error\":\"ID lipsă\"}");
         }
-        int id = std::stoi(it->second);
+        int id = std::stoi(std::string(it->value));
         
         // Extrage body
         std::string body = extractBody(raw_request);
@@ -167,7 +167,7 @@ std::string UserController::update(const HttpRequest& req, const std::map<std::s
     }
 }
 
-std::string UserController::remove(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string UserController::remove(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[UserController] DELETE /api/users/:id\n";
 
     try {
@@ -176,7 +176,7 @@ std::string UserController::remove(const HttpRequest& req, const std::map<std::s
         if (it == params.end()) {
             return jsonResponse(400, "{\"error\":\"ID lipsă\"}");
         }
-        int id = std::stoi(it->second);
+        int id = std::stoi(std::string(it->value));
 
         // Șterge
         service.deleteUser(id);
@@ -195,7 +195,7 @@ std::string UserController::remove(const HttpRequest& req, const std::map<std::s
 
 // ========== AUTENTIFICARE ==========
 
-std::string UserController::registerUser(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string UserController::registerUser(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[UserController] POST /api/auth/register\n";
 
     try {
@@ -244,7 +244,7 @@ std::string UserController::registerUser(const HttpRequest& req, const std::map<
     }
 }
 
-std::string UserController::loginUser(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string UserController::loginUser(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[UserController] POST /api/auth/login\n";
 
     try {
@@ -2,7 +2,7 @@
 #include "services/userservice.hpp"
 #include "http/request.hpp"
 #include <string>
-#include <map>
+#include "http/router.hpp"
 
 class UserController {
 private:
@@ -18,25 +18,25 @@ public:
     explicit UserController(UserService& service) : service(service) {}
     
     // GET /api/users - Obține toți utilizatorii
-    std::string getAll(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string getAll(const HttpRequest& req, const RouteParams& params);
     
     // GET /api/users/:id - Obține un utilizator specific
-    std::string getById(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string getById(const HttpRequest& req, const RouteParams& params);
     
     // POST /api/users - Creează un utilizator nou
-    std::string create(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string create(const HttpRequest& req, const RouteParams& params);
     
     // PUT /api/users/:id - Actualizează un utilizator
-    std::string update(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string update(const HttpRequest& req, const RouteParams& params);
     
     // DELETE /api/users/:id - Șterge un utilizator
-    std::string remove(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string remove(const HttpRequest& req, const RouteParams& params);
 
     // POST /api/auth/register - Înregistrare user nou
-    std::string registerUser(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string registerUser(const HttpRequest& req, const RouteParams& params);
 
     // POST /api/auth/login - Autentificare user
-    std::string loginUser(const HttpRequest& req, const std::map<std::string, std::string>& params);
+    std::string loginUser(const HttpRequest& req, const RouteParams& params);
 
     // Setează raw request pentru parsing body
     void setRawRequest(const std::string& raw);
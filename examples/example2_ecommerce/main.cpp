@@ -21,6 +21,15 @@ int main() {
     // Enable CORS
     app.enable_cors(true);
 
+    // ETags for GET responses: unchanged payloads are answered with 304
+    app.enable_etags();
+
+    // Prometheus metrics on GET /metrics
+    app.enable_metrics();
+
+    // Probes on 127.0.0.1:9090 (/healthz, /readyz, /metrics), answered by the master
+    app.enable_admin(9090);
+
     std::cout << "\n";
     std::cout << "╔════════════════════════════════════════════════╗\n";
     std::cout << "║      EXAMPLE 2: E-COMMERCE API                 ║\n";
@@ -46,8 +55,21 @@ int main() {
 
     // ===== PRODUCT ENDPOINTS =====
 
+    // Catalog reads are cached in shared memory (all workers); the write
+    // endpoints below invalidate the "products" / "product/<id>" tags.
+    // single_flight: a burst of misses for the same product hits SQLite once.
+    CacheOptions listCache;
+    listCache.ttl_seconds = 30;
+    listCache.tags = {"products"};
+    listCache.single_flight = true;
+
+    CacheOptions itemCache;
+    itemCache.ttl_seconds = 30;
+    itemCache.tags = {"product/:id"};
+    itemCache.single_flight = true;
+
     // GET /api/products - Get all products
-    app.get("/api/products", [&productService](const Request& req) {
+    app.get_cached("/api/products", [&productService](const Request& req) {
         try {
             auto products = productService.getAllProducts();
 
@@ -63,10 +85,10 @@ int main() {
         } catch (const std::exception& e) {
             return Response::json(500, "{\"error\":\"" + std::string(e.what()) + "\"}");
         }
-    });
+    }, listCache);
 
     // GET /api/products/:id - Get product by ID
-    app.get("/api/products/:id", [&productService](const Request& req) {
+    app.get_cached("/api/products/:id", [&productService](const Request& req) {
         try {
             int id = std::stoi(req.getParam("id"));
             auto product = productService.getProduct(id);
@@ -79,25 +101,67 @@ int main() {
         } catch (const std::exception& e) {
             return Response::json(400, "{\"error\":\"" + std::string(e.what()) + "\"}");
         }
-    });
+    }, itemCache);
 
     // POST /api/products - Create new product
-    app.post("/api/products", [&productService](const Request& req) {
+    app.post("/api/products", [&productService, &app](const Request& req) {
         try {
             Product product = Product::fromJson(req.getBody());
             Product created = productService.createProduct(product);
+            app.invalidate_cache("products");
             return Response::json(201, created.toJson());
         } catch (const std::exception& e) {
             return Response::json(400, "{\"error\":\"" + std::string(e.what()) + "\"}");
         }
     });
 
+    // POST /api/products/import - Bulk import, one product JSON per line (NDJSON).
+    // The body is streamed: a multi-megabyte catalog is never held in memory.
+    app.post_stream("/api/products/import", [&productService, &app](const Request&, BodyStream& body) {
+        size_t imported = 0;
+        size_t failed = 0;
+        std::string pending;
+        std::string chunk;
+
+        auto importLine = [&](const std::string& line) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos) return;
+            try {
+                productService.createProduct(Product::fromJson(line));
+                imported++;
+            } catch (const std::exception&) {
+                failed++;
+            }
+        };
+
+        while (body.read(chunk)) {
+            pending += chunk;
+            size_t start = 0;
+            size_t nl;
+            while ((nl = pending.find('\n', start)) != std::string::npos) {
+                importLine(pending.substr(start, nl - start));
+                start = nl + 1;
+            }
+            pending.erase(0, start);
+        }
+        importLine(pending);
+        if (imported > 0) {
+            app.invalidate_cache("products");
+        }
+
+        std::ostringstream json;
+        json << "{\"imported\":" << imported << ",\"failed\":" << failed
+             << ",\"bytes\":" << body.bytes_read() << "}";
+        return Response::json(200, json.str());
+    });
+
     // PUT /api/products/:id - Update product
-    app.put("/api/products/:id", [&productService](const Request& req) {
+    app.put("/api/products/:id", [&productService, &app](const Request& req) {
         try {
             int id = std::stoi(req.getParam("id"));
             Product product = Product::fromJson(req.getBody());
             productService.updateProduct(id, product);
+            app.invalidate_cache("products");
+            app.invalidate_cache("product/" + std::to_string(id));
             return Response::json(200, "{\"message\":\"Product updated successfully\"}");
         } catch (const std::exception& e) {
             return Response::json(400, "{\"error\":\"" + std::string(e.what()) + "\"}");
@@ -105,10 +169,12 @@ int main() {
     });
 
     // DELETE /api/products/:id - Delete product
-    app.del("/api/products/:id", [&productService](const Request& req) {
+    app.del("/api/products/:id", [&productService, &app](const Request& req) {
         try {
             int id = std::stoi(req.getParam("id"));
             productService.deleteProduct(id);
+            app.invalidate_cache("products");
+            app.invalidate_cache("product/" + std::to_string(id));
             return Response::json(200, "{\"message\":\"Product deleted successfully\"}");
         } catch (const std::exception& e) {
             return Response::json(400, "{\"error\":\"" + std::string(e.what()) + "\"}");
@@ -175,7 +241,7 @@ int main() {
     });
 
     // PUT /api/products/:id/stock - Update product stock
-    app.put("/api/products/:id/stock", [&productService](const Request& req) {
+    app.put("/api/products/:id/stock", [&productService, &app](const Request& req) {
         try {
             int id = std::stoi(req.getParam("id"));
             // Extract quantity from JSON body
@@ -188,6 +254,8 @@ int main() {
             int quantity = std::stoi(body.substr(pos));
 
             productService.updateStock(id, quantity);
+            app.invalidate_cache("products");
+            app.invalidate_cache("product/" + std::to_string(id));
             return Response::json(200, "{\"message\":\"Stock updated successfully\"}");
         } catch (const std::exception& e) {
             return Response::json(400, "{\"error\":\"" + std::string(e.what()) + "\"}");
@@ -225,10 +293,12 @@ int main() {
     std::cout << "\n📍 Available Endpoints:\n";
     std::cout << "  GET    /                              - API Info\n";
     std::cout << "  GET    /health                        - Health check\n";
+    std::cout << "  GET    /metrics                       - Prometheus metrics\n";
     std::cout << "\n  Products:\n";
     std::cout << "  GET    /api/products                  - Get all products\n";
     std::cout << "  GET    /api/products/:id              - Get product by ID\n";
     std::cout << "  POST   /api/products                  - Create new product\n";
+    std::cout << "  POST   /api/products/import           - Bulk import (NDJSON, streamed)\n";
     std::cout << "  PUT    /api/products/:id              - Update product\n";
     std::cout << "  DELETE /api/products/:id              - Delete product\n";
     std::cout << "  GET    /api/products/category/:cat    - Get products by category\n";
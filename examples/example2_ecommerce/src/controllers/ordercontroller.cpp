@@ -42,12 +42,12 @@ std::string OrderController::jsonResponse(int status, const std::string& body) {
     return response.str();
 }
 
-int OrderController::extractUserId(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+int OrderController::extractUserId(const HttpRequest& req, const RouteParams& params) {
     // In production, extract from JWT token
     // For now, check params for user_id
     auto it = params.find("user_id");
     if (it != params.end()) {
-        return std::stoi(it->second);
+        return std::stoi(std::string(it->value));
     }
 
     // Check target for query string (e.g., /api/orders?user_id=123)
@@ -73,7 +73,7 @@ bool OrderController::isAdmin(int user_id) {
 }
 
 // POST /api/orders - Create new order
-std::string OrderController::createOrder(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string OrderController::createOrder(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[OrderController] POST /api/orders\n";
     
     try {
@@ -112,7 +112,7 @@ std::string OrderController::createOrder(const HttpRequest& req, const std::map<
 }
 
 // GET /api/orders - List orders
-std::string OrderController::getOrders(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string OrderController::getOrders(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[OrderController] GET /api/orders\n";
     
     try {
@@ -149,7 +149,7 @@ std::string OrderController::getOrders(const HttpRequest& req, const std::map<st
 }
 
 // GET /api/orders/:id - Get order by ID
-std::string OrderController::getOrderById(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string OrderController::getOrderById(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[OrderController] GET /api/orders/:id\n";
     
     try {
@@ -159,7 +159,7 @@ std::string OrderController::getOrderById(const HttpRequest& req, const std::map
             return jsonResponse(400, "{\"error\":\"Order ID is required\"}");
         }
         
-        int order_id = std::stoi(it->second);
+        int order_id = std::stoi(std::string(it->value));
         int user_id = extractUserId(req, params);
         bool admin = isAdmin(user_id);
         
@@ -189,7 +189,7 @@ std::string OrderController::getOrderById(const HttpRequest& req, const std::map
 }
 
 // PUT /api/orders/:id/status - Update order status
-std::string OrderController::updateOrderStatus(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string OrderController::updateOrderStatus(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[OrderController] PUT /api/orders/:id/status\n";
     
     try {
@@ -205,7 +205,7 @@ std::string OrderController::updateOrderStatus(const HttpRequest& req, const std
         if (it == params.end()) {
             return jsonResponse(400, "{\"error\":\"Order ID is required\"}");
         }
-        int order_id = std::stoi(it->second);
+        int order_id = std::stoi(std::string(it->value));
         
         // Extract body
         std::string body = extractBody(raw_request);
@@ -251,7 +251,7 @@ std::string OrderController::updateOrderStatus(const HttpRequest& req, const std
 }
 
 // DELETE /api/orders/:id - Cancel order
-std::string OrderController::cancelOrder(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string OrderController::cancelOrder(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[OrderController] DELETE /api/orders/:id\n";
     
     try {
@@ -260,7 +260,7 @@ std::string OrderController::cancelOrder(const HttpRequest& req, const std::map<
         if (it == params.end()) {
             return jsonResponse(400, "{\"error\":\"Order ID is required\"}");
         }
-        int order_id = std::stoi(it->second);
+        int order_id = std::stoi(std::string(it->value));
         
         int user_id = extractUserId(req, params);
         bool admin = isAdmin(user_id);
@@ -286,7 +286,7 @@ std::string OrderController::cancelOrder(const HttpRequest& req, const std::map<
 }
 
 // GET /api/orders/stats - Get order statistics
-std::string OrderController::getStatistics(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string OrderController::getStatistics(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[OrderController] GET /api/orders/stats\n";
     
     try {
@@ -65,7 +65,7 @@ std::string ProductController::getQueryParam(const HttpRequest& req, const std::
     return query.substr(param_pos, end_pos - param_pos);
 }
 
-std::string ProductController::getAll(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string ProductController::getAll(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[ProductController] GET /api/products\n";
 
     try {
@@ -115,7 +115,7 @@ std::string ProductController::getAll(const HttpRequest& req, const std::map<std
     }
 }
 
-std::string ProductController::getById(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string ProductController::getById(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[ProductController] GET /api/products/:id\n";
 
     try {
@@ -124,7 +124,7 @@ std::string ProductController::getById(const HttpRequest& req, const std::map<st
             return jsonResponse(400, "{\"error\":\"Missing ID\"}");
         }
 
-        int id = std::stoi(it->second);
+        int id = std::stoi(std::string(it->value));
         auto product = service.getProduct(id);
 
         if (!product.has_value()) {
@@ -145,7 +145,7 @@ std::string ProductController::getById(const HttpRequest& req, const std::map<st
     }
 }
 
-std::string ProductController::search(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string ProductController::search(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[ProductController] GET /api/products/search\n";
 
     try {
@@ -180,7 +180,7 @@ std::string ProductController::search(const HttpRequest& req, const std::map<std
     }
 }
 
-std::string ProductController::getByCategory(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string ProductController::getByCategory(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[ProductController] GET /api/products/category/:category\n";
 
     try {
@@ -189,7 +189,7 @@ std::string ProductController::getByCategory(const HttpRequest& req, const std::
             return jsonResponse(400, "{\"error\":\"Missing category\"}");
         }
 
-        std::string category = it->second;
+        std::string category(it->value);
         auto products = service.getProductsByCategory(category);
 
         // Build JSON array
@@ -215,7 +215,7 @@ std::string ProductController::getByCategory(const HttpRequest& req, const std::
     }
 }
 
-std::string ProductController::getLowStock(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string ProductController::getLowStock(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[ProductController] GET /api/products/low-stock\n";
 
     try {
@@ -247,7 +247,7 @@ std::string ProductController::getLowStock(const HttpRequest& req, const std::ma
     }
 }
 
-std::string ProductController::getActive(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string ProductController::getActive(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[ProductController] GET /api/products/active\n";
 
     try {
@@ -272,7 +272,7 @@ std::string ProductController::getActive(const HttpRequest& req, const std::map<
     }
 }
 
-std::string ProductController::create(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string ProductController::create(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[ProductController] POST /api/products\n";
 
     try {
@@ -302,7 +302,7 @@ std::string ProductController::create(const HttpRequest& req, const std::map<std
     }
 }
 
-std::string ProductController::update(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string ProductController::update(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[ProductController] PUT /api/products/:id\n";
 
     try {
@@ -311,7 +311,7 @@ std::string ProductController::update(const HttpRequest& req, const std::map<std
         if (it == params.end()) {
             return jsonResponse(400, "{\"error\":\"Missing ID\"}");
         }
-        int id = std::stoi(it->second);
+        int id = std::stoi(std::string(it->value));
 
         // Extract body
         std::string body = extractBody(raw_request);
@@ -343,7 +343,7 @@ std::string ProductController::update(const HttpRequest& req, const std::map<std
     }
 }
 
-std::string ProductController::updateStock(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string ProductController::updateStock(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[ProductController] PATCH /api/products/:id/stock\n";
 
     try {
@@ -352,7 +352,7 @@ std::string ProductController::updateStock(const HttpRequest& req, const std::ma
         if (it == params.end()) {
             return jsonResponse(400, "{\"error\":\"Missing ID\"}");
         }
-        int id = std::stoi(it->second);
+        int id = std::stoi(std::string(it->value));
 
         // Extract body
         std::string body = extractBody(raw_request);
@@ -393,7 +393,7 @@ std::string ProductController::updateStock(const HttpRequest& req, const std::ma
     }
 }
 
-std::string ProductController::remove(const HttpRequest& req, const std::map<std::string, std::string>& params) {
+std::string ProductController::remove(const HttpRequest& req, const RouteParams& params) {
     std::cout << "[ProductController] DELETE /api/products/:id\n";
 
     try {
@@ -402,7 +402,7 @@ std::string ProductController::remove(const HttpRequest& req, const std::map<std
         if (it == params.end()) {
             return jsonResponse(400, "{\"error\":\"Missing ID\"}");
         }
-        int id = std::stoi(it->second);
+        int id = std::stoi(std::string(it->value));
 
         // Delete
         service.deleteProduct(id);
@@ -5,6 +5,7 @@
 #include <vector>
 #include <ctime>
 #include <algorithm>
+#include <mutex>
 
 using namespace RestAPI;
 
@@ -20,6 +21,10 @@ struct SensorReading {
 // In-memory storage
 std::vector<SensorReading> readings;
 
+// Live streams per sensor (Server-Sent Events), one per worker process
+std::map<std::string, EventStream> sensorStreams;
+std::mutex streamsMutex;
+
 // ===== HELPER FUNCTIONS =====
 std::string getCurrentTimestamp() {
     return std::to_string(std::time(nullptr));
@@ -32,6 +37,30 @@ double calculateAverage(const std::vector<double>& values) {
     return sum / values.size();
 }
 
+std::string readingToJson(const SensorReading& r) {
+    std::ostringstream oss;
+    oss << R"({"sensor_id": ")" << r.sensor_id << R"(",)"
+        << R"("temperature": )" << r.temperature << ","
+        << R"("humidity": )" << r.humidity << ","
+        << R"("timestamp": )" << r.timestamp << ","
+        << R"("location": ")" << r.location << R"("})";
+    return oss.str();
+}
+
+// Push a reading to everyone watching that sensor
+void publishReading(const SensorReading& r) {
+    EventStream stream;
+    {
+        std::lock_guard<std::mutex> lock(streamsMutex);
+        auto it = sensorStreams.find(r.sensor_id);
+        if (it == sensorStreams.end()) {
+            it = sensorStreams.emplace(r.sensor_id, EventStream::create()).first;
+        }
+        stream = it->second;
+    }
+    stream.publish(readingToJson(r), "reading");
+}
+
 int main() {
     RestApiFramework app(8082, 2);
     app.enable_cors(true);
@@ -47,10 +76,13 @@ int main() {
     readings.push_back({"SENS001", 22.5, 55.2, std::time(nullptr) - 3600, "Living Room"});
     readings.push_back({"SENS002", 24.1, 60.5, std::time(nullptr) - 3600, "Bedroom"});
     readings.push_back({"SENS003", 21.8, 52.8, std::time(nullptr) - 3600, "Kitchen"});
+    for (const auto& r : readings) {
+        sensorStreams.emplace(r.sensor_id, EventStream::create());
+    }
 
     // ===== ENDPOINT 1: Submit sensor data =====
     app.post("/api/sensors/data", [](const Request& req) {
-        // In a real app, parse JSON from req.body
+        // In a real app, parse JSON from req.getBody()
         // For demo, we'll create a sample reading
         SensorReading reading;
         reading.sensor_id = "SENS00" + std::to_string(readings.size() + 1);
@@ -60,6 +92,7 @@ int main() {
         reading.location = "Demo Location";
 
         readings.push_back(reading);
+        publishReading(reading);
 
         std::ostringstream oss;
         oss << R"({)"
@@ -207,6 +240,60 @@ int main() {
         })");
     });
 
+    // ===== ENDPOINT 8: Streaming ingest over WebSocket =====
+    // Each text message is one reading: "sensor_id,temperature,humidity[,location]"
+    WebSocketHandlers stream;
+    stream.on_open = [](WebSocket ws, const Request& req) {
+        (void)req;
+        ws.send_text(R"({"status": "connected"})");
+    };
+    stream.on_message = [](WebSocket ws, const std::string& message, bool binary) {
+        if (binary) {
+            ws.close(1003, "Text readings only");
+            return;
+        }
+
+        std::istringstream iss(message);
+        SensorReading reading;
+        std::string temperature, humidity;
+        if (!std::getline(iss, reading.sensor_id, ',') ||
+            !std::getline(iss, temperature, ',') ||
+            !std::getline(iss, humidity, ',')) {
+            ws.send_text(R"({"error": "Expected sensor_id,temperature,humidity[,location]"})");
+            return;
+        }
+        std::getline(iss, reading.location);
+
+        try {
+            reading.temperature = std::stod(temperature);
+            reading.humidity = std::stod(humidity);
+        } catch (const std::exception&) {
+            ws.send_text(R"({"error": "Invalid number"})");
+            return;
+        }
+        reading.timestamp = std::time(nullptr);
+        readings.push_back(reading);
+        publishReading(reading);
+
+        // Acknowledgements stop when the client is not reading (backpressure)
+        if (ws.buffered_amount() == 0) {
+            ws.send_text(R"({"ack": )" + std::to_string(readings.size()) + "}");
+        }
+    };
+
+    WebSocketOptions streamOptions;
+    streamOptions.max_message_size = 4096;  // Readings are small
+    app.websocket("/api/sensors/stream", stream, streamOptions);
+
+    // ===== ENDPOINT 9: Live readings (Server-Sent Events) =====
+    // Dashboards subscribe once instead of polling /latest every second;
+    // reconnecting clients get missed readings replayed via Last-Event-ID
+    app.sse("/api/sensors/:id/events", [](const Request& req) {
+        std::lock_guard<std::mutex> lock(streamsMutex);
+        auto it = sensorStreams.find(req.getParam("id"));
+        return it != sensorStreams.end() ? it->second : EventStream();
+    });
+
     // Print available endpoints
     std::cout << "\n📍 Available Endpoints:\n";
     std::cout << "  POST /api/sensors/data           - Submit sensor reading\n";
@@ -215,6 +302,8 @@ int main() {
     std::cout << "  GET  /api/sensors/:id/history    - All readings for sensor\n";
     std::cout << "  GET  /api/sensors/stats          - Statistics (all sensors)\n";
     std::cout << "  GET  /api/sensors/alerts         - High temperature alerts\n";
+    std::cout << "  WS   /api/sensors/stream         - Stream readings (WebSocket)\n";
+    std::cout << "  GET  /api/sensors/:id/events     - Live readings (Server-Sent Events)\n";
     std::cout << "  GET  /health                     - Health check\n";
     std::cout << "\n";
     std::cout << "💡 Examples:\n";
@@ -222,6 +311,8 @@ int main() {
     std::cout << "  curl http://localhost:8082/api/sensors/SENS001/latest\n";
     std::cout << "  curl http://localhost:8082/api/sensors/stats\n";
     std::cout << "  curl -X POST http://localhost:8082/api/sensors/data\n";
+    std::cout << "  curl -N http://localhost:8082/api/sensors/SENS001/events\n";
+    std::cout << "  websocat ws://localhost:8082/api/sensors/stream   (send: SENS001,22.5,55.2,Kitchen)\n";
     std::cout << "\n";
 
     app.start();
@@ -127,7 +127,7 @@ int main() {
             return Response::json(404, R"({"error": "Account not found"})");
         }
 
-        // In real app, parse amount from req.body
+        // In real app, parse amount from req.getBody()
         double amount = 100.00; // Demo amount
 
         it->second.balance += amount;
@@ -153,7 +153,7 @@ int main() {
             return Response::json(404, R"({"error": "Account not found"})");
         }
 
-        // In real app, parse amount from req.body
+        // In real app, parse amount from req.getBody()
         double amount = 50.00; // Demo amount
 
         if (it->second.balance < amount) {
@@ -176,7 +176,7 @@ int main() {
 
     // ===== ENDPOINT 6: Transfer money =====
     app.post("/api/transfer", [](const Request& req) {
-        // In real app, parse from/to/amount from req.body
+        // In real app, parse from/to/amount from req.getBody()
         std::string from = "ACC001";
         std::string to = "ACC002";
         double amount = 200.00;
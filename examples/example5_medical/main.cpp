@@ -5,6 +5,7 @@
 #include <map>
 #include <vector>
 #include <ctime>
+#include <sys/stat.h>
 
 using namespace RestAPI;
 
@@ -36,12 +37,23 @@ struct MedicalRecord {
     std::string doctor;
 };
 
+struct Attachment {
+    std::string attachment_id;
+    std::string patient_id;
+    std::string filename;
+    std::string content_type;
+    size_t size;
+    bool spooled;   // Large scans arrive as a temp file instead of in memory
+};
+
 // In-memory storage
 std::map<std::string, Patient> patients;
 std::vector<Appointment> appointments;
 std::vector<MedicalRecord> records;
+std::vector<Attachment> attachments;
 int next_appointment_id = 1;
 int next_record_id = 1;
+int next_attachment_id = 1;
 
 // ===== HELPER FUNCTIONS =====
 std::string generateAppointmentId() {
@@ -140,7 +152,7 @@ int main() {
 
     // ===== ENDPOINT 4: Create appointment =====
     app.post("/api/appointments", [](const Request& req) {
-        // In real app, parse patient_id, doctor, date, time from req.body
+        // In real app, parse patient_id, doctor, date, time from req.getBody()
         Appointment apt;
         apt.appointment_id = generateAppointmentId();
         apt.patient_id = "P001";
@@ -212,7 +224,7 @@ int main() {
 
     // ===== ENDPOINT 7: Add medical record =====
     app.post("/api/records", [](const Request& req) {
-        // In real app, parse from req.body
+        // In real app, parse from req.getBody()
         MedicalRecord rec;
         rec.record_id = generateRecordId();
         rec.patient_id = "P001";
@@ -257,6 +269,45 @@ int main() {
         return Response::json(200, oss.str());
     });
 
+    // ===== ENDPOINT 8b: Upload attachment (X-ray, scan, PDF) =====
+    // Bodies above 1 MB are spooled to disk, so multi-megabyte scans never sit in RAM
+    UploadOptions uploadOptions;
+    uploadOptions.max_size = 100 * 1024 * 1024;
+    app.post_upload("/api/patients/:id/attachments", [](const Request& req) {
+        std::string id = req.getParam("id");
+        if (patients.find(id) == patients.end()) {
+            return Response::json(404, R"({"error": "Patient not found"})");
+        }
+
+        Attachment att;
+        att.attachment_id = "ATT" + std::to_string(next_attachment_id++);
+        att.patient_id = id;
+        att.filename = req.getQuery("filename").empty() ? att.attachment_id : req.getQuery("filename");
+        att.content_type = req.getHeader("Content-Type");
+        att.spooled = req.hasBodyFile();
+
+        if (att.spooled) {
+            // In real app, rename req.getBodyFile() into the document store before returning
+            struct stat st;
+            att.size = (stat(req.getBodyFile().c_str(), &st) == 0) ? static_cast<size_t>(st.st_size) : 0;
+        } else {
+            att.size = req.getBody().size();
+        }
+
+        attachments.push_back(att);
+
+        std::ostringstream oss;
+        oss << R"({)"
+            << R"("status": "success",)"
+            << R"("attachment_id": ")" << att.attachment_id << R"(",)"
+            << R"("filename": ")" << att.filename << R"(",)"
+            << R"("size": )" << att.size << ","
+            << R"("spooled": )" << (att.spooled ? "true" : "false")
+            << R"(})";
+
+        return Response::json(201, oss.str());
+    }, uploadOptions);
+
     // ===== ENDPOINT 9: Search patients by name =====
     app.get("/api/patients/search/:name", [](const Request& req) {
         std::string name = req.getParam("name");
@@ -301,6 +352,7 @@ int main() {
     std::cout << "  POST /api/appointments               - Create appointment\n";
     std::cout << "  GET  /api/appointments               - List appointments\n";
     std::cout << "  POST /api/records                    - Add medical record\n";
+    std::cout << "  POST /api/patients/:id/attachments   - Upload attachment (spooled)\n";
     std::cout << "  GET  /health                         - Health check\n";
     std::cout << "\n";
     std::cout << "💡 Examples:\n";
@@ -0,0 +1,82 @@
+#include "../../framework/include/restapi_coro.hpp"
+#include <iostream>
+#include <string>
+#include <sstream>
+
+using namespace RestAPI;
+
+// Deliberately slow computation, executed on the blocking pool
+static long slowFibonacci(int n) {
+    return n < 2 ? n : slowFibonacci(n - 1) + slowFibonacci(n - 2);
+}
+
+int main() {
+    // Create framework instance
+    RestApiFramework app(8085, 2);
+    app.enable_cors(true);
+
+    std::cout << "\n";
+    std::cout << "╔════════════════════════════════════════════════╗\n";
+    std::cout << "║      EXAMPLE 6: COROUTINE HANDLERS (C++20)     ║\n";
+    std::cout << "║      co_await timers, blocking work, HTTP      ║\n";
+    std::cout << "╚════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    // ===== ENDPOINT 1: Timer =====
+    coro::get(app, "/delay/:ms", [](Request req) -> coro::Task<Response> {
+        int ms = std::stoi(req.getParam("ms"));
+
+        // No thread is held while waiting
+        co_await coro::sleep_for(std::chrono::milliseconds(ms));
+
+        co_return Response::json(200, R"({"waited_ms": )" + std::to_string(ms) + "}");
+    });
+
+    // ===== ENDPOINT 2: Blocking work off the event loop =====
+    coro::get(app, "/fib/:n", [](Request req) -> coro::Task<Response> {
+        int n = std::stoi(req.getParam("n"));
+        if (n < 0 || n > 40) {
+            co_return Response::json(400, R"({"error": "n must be between 0 and 40"})");
+        }
+
+        long result = co_await coro::run_blocking([n]() { return slowFibonacci(n); });
+
+        std::ostringstream oss;
+        oss << R"({"n": )" << n << R"(, "fibonacci": )" << result << "}";
+        co_return Response::json(200, oss.str());
+    });
+
+    // ===== ENDPOINT 3: Outbound call =====
+    coro::get(app, "/proxy/health", [](Request req) -> coro::Task<Response> {
+        (void)req;
+
+        std::string raw = co_await coro::http_request("localhost", 8080, "GET", "/health");
+        if (raw.empty()) {
+            co_return Response::json(502, R"({"error": "Upstream unavailable"})");
+        }
+
+        auto pos = raw.find("\r\n\r\n");
+        co_return Response::json(200, pos == std::string::npos ? raw : raw.substr(pos + 4));
+    });
+
+    // ===== ENDPOINT 4: Health check =====
+    app.get("/health", [](const Request& req) {
+        (void)req;
+        return Response::json(200, R"({"status": "healthy", "domain": "Coroutines"})");
+    });
+
+    // Print available endpoints
+    std::cout << "\n📍 Available Endpoints:\n";
+    std::cout << "  GET /delay/:ms       - Respond after a timer (co_await sleep_for)\n";
+    std::cout << "  GET /fib/:n          - Blocking work on the blocking pool\n";
+    std::cout << "  GET /proxy/health    - Outbound HTTP call to localhost:8080\n";
+    std::cout << "  GET /health          - Health check\n";
+    std::cout << "\n";
+    std::cout << "💡 Examples:\n";
+    std::cout << "  curl http://localhost:8085/delay/250\n";
+    std::cout << "  curl http://localhost:8085/fib/30\n";
+    std::cout << "\n";
+
+    app.start();
+    return 0;
+}
@@ -1,53 +1,286 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <string>
+#include <string_view>
 #include <map>
+#include <vector>
 #include <memory>
+#include <optional>
+#include <charconv>
+#include <cstring>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+// Infrastructure types behind RestAPI::WebSocket, EventStream and BodyStream
+class WebSocketConnection;
+class SseChannel;
+class BodyReader;
+class HttpRequest;      // The parsed request a RestAPI::Request views
+class ConnectionPool;   // Reported by enable_metrics() (add_metrics_pool)
+class CancellationState;  // Behind RestAPI::CancellationToken
 
 namespace RestAPI {
 
 // Forward declarations
 class Request;
 class Response;
+class AsyncResponse;
 class RestApiFrameworkImpl;
+class RouteTableBase;   // restapi_routes.hpp
 
-// ===== REQUEST CLASS =====
-class Request {
+// ===== PATH PARAMETERS =====
+// Flat name/value list for route parameters (:id). Names and values are
+// stored inline, so the usual one or two parameters cost no heap allocation;
+// only values that outgrow the inline buffer spill into a string.
+class PathParams {
 public:
-    std::string method;         // GET, POST, PUT, DELETE
-    std::string path;           // /api/resource
-    std::string target;         // /api/resource?key=value
-    std::string body;           // Request body
+    static constexpr size_t MAX_PARAMS = 16;
+    static constexpr size_t INLINE_BYTES = 192;
+
+    PathParams() : count_(0), used_(0) {}
+    PathParams(const PathParams& other) : count_(0), used_(0) { *this = other; }
+
+    PathParams& operator=(const PathParams& other) {
+        if (this == &other) return *this;
+        count_ = other.count_;
+        used_ = other.used_;
+        std::memcpy(slots_, other.slots_, count_ * sizeof(Slot));
+        std::memcpy(inline_, other.inline_, used_);
+        overflow_ = other.overflow_;
+        return *this;
+    }
+
+    // Adds or replaces a parameter; false once MAX_PARAMS are set
+    bool set(std::string_view name, std::string_view value) {
+        for (size_t i = 0; i < count_; i++) {
+            if (this->name(i) == name) {
+                slots_[i].value = store(value);
+                return true;
+            }
+        }
+        if (count_ == MAX_PARAMS) return false;
+        Slot& slot = slots_[count_++];
+        slot.name = store(name);
+        slot.value = store(value);
+        return true;
+    }
+
+    void clear() {
+        count_ = 0;
+        used_ = 0;
+        overflow_.clear();
+    }
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    std::string_view name(size_t i) const { return view(slots_[i].name); }
+    std::string_view value(size_t i) const { return view(slots_[i].value); }
 
-    std::map<std::string, std::string> params;   // Path parameters (:id)
-    std::map<std::string, std::string> query;    // Query parameters (?key=value)
-    std::map<std::string, std::string> headers;  // HTTP headers
+    bool has(std::string_view name) const { return index_of(name) >= 0; }
 
-    std::string raw;            // Raw request (for advanced use)
+    // Raw value, empty if the parameter is missing
+    std::string_view get(std::string_view name) const {
+        int i = index_of(name);
+        return i >= 0 ? value(static_cast<size_t>(i)) : std::string_view();
+    }
+
+    // Typed value: nullopt if missing or if the whole value does not parse as T.
+    // Numbers go through std::from_chars (no locale, no exceptions).
+    template <typename T>
+    std::optional<T> get(std::string_view name) const {
+        int i = index_of(name);
+        if (i < 0) return std::nullopt;
+        return parse<T>(value(static_cast<size_t>(i)));
+    }
+
+    template <typename T>
+    static std::optional<T> parse(std::string_view text) {
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            return text;
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return std::string(text);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            if (text == "true" || text == "1") return true;
+            if (text == "false" || text == "0") return false;
+            return std::nullopt;
+        } else {
+            static_assert(std::is_arithmetic_v<T>, "PathParams::get<T>: unsupported type");
+            T out{};
+            const char* end = text.data() + text.size();
+            auto result = std::from_chars(text.data(), end, out);
+            if (result.ec != std::errc() || result.ptr != end || text.empty()) return std::nullopt;
+            return out;
+        }
+    }
 
-    // Helper methods
-    const std::string& getMethod() const { return method; }
-    const std::string& getPath() const { return path; }
-    const std::string& getBody() const { return body; }
+private:
+    // Where a string lives: inline_ or overflow_ (high bit of offset)
+    struct Ref {
+        uint32_t offset;
+        uint32_t size;
+    };
+    struct Slot {
+        Ref name;
+        Ref value;
+    };
+
+    static constexpr uint32_t OVERFLOW_BIT = 0x80000000u;
+
+    Ref store(std::string_view text) {
+        Ref ref{0, static_cast<uint32_t>(text.size())};
+        if (used_ + text.size() <= INLINE_BYTES) {
+            ref.offset = static_cast<uint32_t>(used_);
+            std::memcpy(inline_ + used_, text.data(), text.size());
+            used_ += text.size();
+        } else {
+            ref.offset = static_cast<uint32_t>(overflow_.size()) | OVERFLOW_BIT;
+            overflow_.append(text.data(), text.size());
+        }
+        return ref;
+    }
 
-    // Get header value
-    std::string getHeader(const std::string& key) const {
-        auto it = headers.find(key);
-        return (it != headers.end()) ? it->second : "";
+    std::string_view view(const Ref& ref) const {
+        if (ref.offset & OVERFLOW_BIT) {
+            return std::string_view(overflow_.data() + (ref.offset & ~OVERFLOW_BIT), ref.size);
+        }
+        return std::string_view(inline_ + ref.offset, ref.size);
     }
 
-    // Get query parameter
-    std::string getQuery(const std::string& key) const {
-        auto it = query.find(key);
-        return (it != query.end()) ? it->second : "";
+    int index_of(std::string_view name) const {
+        for (size_t i = 0; i < count_; i++) {
+            if (this->name(i) == name) return static_cast<int>(i);
+        }
+        return -1;
     }
 
+    Slot slots_[MAX_PARAMS];
+    size_t count_;
+    size_t used_;
+    char inline_[INLINE_BYTES];
+    std::string overflow_;
+};
+
+// ===== CONDITIONAL REQUESTS =====
+// Validator of a representation, declared by the handler from what it
+// already knows (a version column, updated_at) before building the body.
+// Responses carrying one are answered with 304 Not Modified when the
+// client's If-None-Match / If-Modified-Since shows its copy is current.
+struct Validator {
+    std::string etag;                // Opaque tag, without quotes ("" = none)
+    bool weak = false;               // W/"tag": equivalent content, not byte-identical
+    std::time_t last_modified = 0;   // Seconds since the epoch (0 = none)
+};
+
+// ===== CANCELLATION =====
+// Whether a request is still worth finishing: cancelled once its deadline has
+// passed or its client disconnected (see RouteHandle::deadline and
+// enable_cancellation). Check it between the expensive steps of a handler;
+// SQLite queries run on the handler's thread are interrupted on their own.
+// Cheap to copy, and safe to check from any thread.
+class CancellationToken {
+public:
+    CancellationToken() = default;              // Never cancelled
+
+    bool cancelled() const;
+    bool deadlineExceeded() const;
+    bool clientDisconnected() const;
+
+    bool hasDeadline() const;
+    std::chrono::milliseconds timeLeft() const; // 0 once passed; milliseconds::max() without a deadline
+
+private:
+    friend class Request;
+    std::shared_ptr<const ::CancellationState> state_;
+};
+
+// ===== REQUEST CLASS =====
+// A view over the request parsed by the worker: method, path, headers and
+// body are not copied, and the query string is only split on the first
+// query()/getQuery() call. The view is valid during the handler call;
+// copying a Request (e.g. into an async callback) makes a copy that owns
+// its data and stays valid on its own.
+class Request {
+public:
+    PathParams params;          // Path parameters (:id)
+
+    Request();                                  // Empty request
+    explicit Request(const ::HttpRequest& http); // View (framework internal)
+
+    Request(const Request& other);
+    Request(Request&& other);
+    Request& operator=(const Request& other);
+    Request& operator=(Request&& other);
+    ~Request();
+
+    const std::string& getMethod() const { return *method_; }   // GET, POST, PUT, DELETE
+    const std::string& getPath() const { return *path_; }       // /api/resource
+    const std::string& getTarget() const { return *target_; }   // /api/resource?key=value
+    const std::string& getBody() const { return *body_; }
+    const std::string& getRaw() const { return *raw_; }         // Request line + headers (+ start of body)
+    const std::map<std::string, std::string>& getHeaders() const { return *headers_; }
+
+    // Upload routes: large bodies are spooled to this temp file (getBody() is empty)
+    const std::string& getBodyFile() const { return body_file_; }
+    bool hasBodyFile() const { return !body_file_.empty(); }
+
+    // Header value, case-insensitive ("" if missing); header() avoids the copy
+    std::string getHeader(const std::string& key) const { return std::string(header(key)); }
+    std::string_view header(std::string_view key) const;
+
+    // Query parameter (?key=value), raw as sent ("" if missing); query() avoids the copy
+    std::string getQuery(const std::string& key) const { return std::string(query(key)); }
+    std::string_view query(std::string_view key) const;
+    bool hasQuery(std::string_view key) const;
+
     // Get path parameter
     std::string getParam(const std::string& key) const {
-        auto it = params.find(key);
-        return (it != params.end()) ? it->second : "";
+        return std::string(params.get(key));
     }
+
+    // Path parameter without a copy (valid while the Request lives)
+    std::string_view param(std::string_view key) const { return params.get(key); }
+
+    // Typed path parameter: req.param<int>("id"), nullopt if missing or malformed
+    template <typename T>
+    std::optional<T> param(std::string_view key) const { return params.get<T>(key); }
+
+    // True for a GET whose If-None-Match (or, without it, If-Modified-Since)
+    // matches the validator: return Response::notModified(v) without building the body
+    bool notModified(const Validator& validator) const;
+
+    // Deadline / client disconnect of this request (also valid in copies)
+    CancellationToken cancellation() const;
+    bool cancelled() const;
+
+private:
+    friend class RestApiFrameworkImpl;
+
+    struct Owned;                                 // Data of a copied Request
+    std::shared_ptr<const Owned> owned_;
+    std::shared_ptr<const std::string> body_owned_;   // Body assembled by upload routes
+    std::shared_ptr<const ::CancellationState> cancellation_;
+
+    const std::string* method_;
+    const std::string* path_;
+    const std::string* target_;
+    const std::string* body_;
+    const std::string* raw_;
+    const std::map<std::string, std::string>* headers_;
+    std::string body_file_;
+
+    // key/value views into *target_, filled on first use
+    mutable std::vector<std::pair<std::string_view, std::string_view>> query_;
+    mutable bool query_parsed_ = false;
+
+    void parseQuery() const;
+    void detach(const Request& from);             // Copy from's data into owned_
+    void setBody(std::string body);
+    void setBodyFile(std::string path) { body_file_ = std::move(path); }
 };
 
 // ===== RESPONSE CLASS =====
@@ -84,12 +317,300 @@ public:
         headers[key] = value;
         return *this;
     }
+
+    // Validators (ETag: "tag" or W/"tag", Last-Modified as an HTTP date)
+    Response& setETag(const std::string& tag, bool weak = false);
+    Response& setLastModified(std::time_t time);
+    Response& setValidator(const Validator& validator);
+
+    // 304 carrying the validator, no body
+    static Response notModified(const Validator& validator);
+};
+
+// ===== ASYNC RESPONSE CLASS =====
+// Completion handle passed to async handlers. It can be copied, stored and
+// completed later from any thread; only the first send() reaches the client.
+// If every copy is dropped without send(), the client receives a 500.
+class AsyncResponse {
+public:
+    AsyncResponse() = default;
+
+    // Complete the request (returns false if it was already completed)
+    bool send(const Response& response) const;
+
+    // Check if a response was already sent
+    bool is_sent() const;
+
+private:
+    friend class RestApiFrameworkImpl;
+    struct State;
+    std::shared_ptr<State> state_;
+};
+
+// ===== BODY STREAM CLASS =====
+// Incremental access to the request body for streaming routes. Each read()
+// pulls the next chunk from the socket, so a slow consumer slows the client
+// down (TCP backpressure) instead of buffering the upload in memory.
+// Only valid during the handler call.
+class BodyStream {
+public:
+    // Next chunk (at most max_chunk bytes); false at the end of the body.
+    // Throws on a malformed body or a stalled client (answered with 400/408)
+    bool read(std::string& chunk, size_t max_chunk = 64 * 1024);
+
+    // Read and drop the rest of the body
+    void discard();
+
+    size_t bytes_read() const;
+    int64_t content_length() const;   // -1 for chunked uploads
+
+private:
+    friend class RestApiFrameworkImpl;
+    ::BodyReader* reader_ = nullptr;
+};
+
+// Upload routes keep small bodies in Request::body and spool larger ones to a temp file
+struct UploadOptions {
+    size_t spool_threshold = 1024 * 1024;            // Above this the body goes to body_file
+    size_t max_size = 1024ULL * 1024 * 1024;         // Larger uploads get 413
+    std::string spool_dir = "/tmp";                  // Where body_file is created
+};
+
+// Cached GET routes: only 200 responses without Set-Cookie or
+// Cache-Control: no-store/private are stored
+struct CacheOptions {
+    int ttl_seconds = 60;                 // How long a stored response is served
+    std::vector<std::string> query;       // Query parameters that select a different response
+    std::vector<std::string> vary;        // Request headers that do (also sent back as Vary)
+    std::vector<std::string> tags;        // For invalidate_cache(); ":name" takes the path parameter
+    bool single_flight = false;           // Concurrent misses for the same key share one handler call
+};
+
+// Admin port served by the master process (see enable_admin)
+struct AdminOptions {
+    std::string host = "127.0.0.1";          // Local only by default
+    std::string health_path = "/healthz";    // Liveness: 200 while the master runs
+    std::string ready_path = "/readyz";      // Readiness: 200 or 503
+    std::string metrics_path = "/metrics";   // Prometheus text format
+    int check_interval_seconds = 5;          // How often health checks run
+};
+
+// Requests per client admitted in a sliding window (see rate_limit). A client
+// may burst up to `requests` at once; after that, one more is admitted every
+// window_seconds / requests seconds.
+struct RateLimitOptions {
+    int requests = 100;
+    int window_seconds = 60;
+    std::string key_header;              // e.g. "X-API-Key": one bucket per key (address when missing)
+    bool trust_forwarded_for = false;    // Key on X-Forwarded-For; only behind a proxy that sets it
+};
+
+// Adaptive concurrency limit per worker (see concurrency_limit). The limit
+// grows while request latency stays within `tolerance` times the lowest
+// latency seen recently, and shrinks when it climbs past that.
+struct ConcurrencyLimitOptions {
+    int initial_limit = 20;              // Concurrent requests per worker at start
+    int min_limit = 1;
+    int max_limit = 200;
+    double tolerance = 2.0;              // Latency allowed over the baseline before the limit drops
+    size_t max_queue = 16;               // Requests that may wait for room; the rest get 503
+    int queue_timeout_ms = 50;           // Longest wait for room before 503
+};
+
+// Request cancellation (see enable_cancellation)
+struct CancellationOptions {
+    bool watch_disconnects = false;                     // Cancel when the client closes the connection (see below)
+    std::string deadline_header = "X-Request-Timeout";  // Milliseconds the client will wait ("" = ignored)
+    int default_deadline_ms = 0;                        // For routes without .deadline() (0 = none)
+};
+
+// Request tracing (see enable_tracing)
+struct TracingOptions {
+    double sample_rate = 1.0;                // Fraction of requests whose spans are recorded
+    std::string header = "X-Request-Id";     // Taken from the request or generated; echoed in the response
+    std::string path;                        // GET: recent spans as Chrome trace JSON ("" = no route; see below)
+    std::string dump_file = "trace.json";    // Written by the master process on SIGUSR2
+    size_t buffer_events = 4096;             // Spans kept per thread; the oldest are overwritten
+};
+
+// Per-route counters, summed over all worker processes
+struct RouteMetrics {
+    std::string method;
+    std::string path;                     // Route pattern; "*" = no registered route (404, route tables)
+    uint64_t requests = 0;
+    uint64_t status[5] = {0, 0, 0, 0, 0}; // Responses per class: [0] = 1xx ... [4] = 5xx
+    uint64_t bytes_in = 0;                // Request headers + declared body
+    uint64_t bytes_out = 0;
+    double mean_us = 0;
+    uint64_t p50_us = 0;                  // Percentiles from a log-linear histogram (~12% precision)
+    uint64_t p90_us = 0;
+    uint64_t p99_us = 0;
+    uint64_t max_us = 0;
+};
+
+// ===== WEBSOCKET CLASS =====
+// Handle to an upgraded connection. It can be copied and stored (e.g. in a
+// subscriber list) and used from any thread; I/O runs on the worker's event loop.
+class WebSocket {
+public:
+    WebSocket() = default;
+
+    // Queue a message; returns false when the send buffer is above the
+    // high-water mark (wait for on_drain) or the connection is closed
+    bool send_text(const std::string& message) const;
+    bool send_binary(const std::string& data) const;
+
+    // Start the close handshake
+    void close(int code = 1000, const std::string& reason = "") const;
+
+    bool is_open() const;
+
+    // Bytes queued but not yet written to the socket
+    size_t buffered_amount() const;
+
+    // Unique per worker process
+    uint64_t id() const;
+
+private:
+    friend class RestApiFrameworkImpl;
+    std::shared_ptr<::WebSocketConnection> conn_;
+};
+
+// Callbacks run on the worker's event loop: keep them short
+struct WebSocketHandlers {
+    std::function<void(WebSocket, const Request&)> on_open;
+    std::function<void(WebSocket, const std::string& message, bool binary)> on_message;
+    std::function<void(WebSocket, int code)> on_close;
+    std::function<void(WebSocket)> on_drain;   // buffer fell back below the low-water mark
+};
+
+struct WebSocketOptions {
+    size_t max_message_size = 1024 * 1024;     // Reassembled message limit (close 1009)
+    size_t high_water_mark = 1024 * 1024;      // send_*() starts reporting backpressure
+    size_t low_water_mark = 256 * 1024;        // on_drain fires below this
+    size_t max_buffered = 8 * 1024 * 1024;     // Slow client is disconnected above this
+    int ping_interval_seconds = 30;            // 0 disables server pings
+};
+
+// ===== EVENT STREAM (SERVER-SENT EVENTS) =====
+
+struct EventStreamOptions {
+    size_t replay_capacity = 256;              // Events kept for Last-Event-ID replay
+    size_t max_queued_bytes = 1024 * 1024;     // Per subscriber; slower clients are evicted
+    int heartbeat_seconds = 15;                // Keep-alive comment on idle streams (0 = off)
+    int retry_ms = 3000;                       // Reconnect delay advertised to EventSource
+};
+
+// A channel that many SSE clients subscribe to. Each published event is
+// serialized once and the same buffer is written to every subscriber.
+// Streams live in the worker process: publish from handlers running there.
+class EventStream {
+public:
+    EventStream() = default;   // Empty handle (no stream)
+
+    static EventStream create(const EventStreamOptions& options = EventStreamOptions());
+
+    // Send an event to all subscribers; returns its id
+    uint64_t publish(const std::string& data, const std::string& event = "") const;
+
+    size_t subscriber_count() const;
+    uint64_t evicted_count() const;   // Subscribers dropped for falling behind
+    void close_all() const;
+
+    bool valid() const { return channel_ != nullptr; }
+
+private:
+    friend class RestApiFrameworkImpl;
+    std::shared_ptr<::SseChannel> channel_;
 };
 
+// Picks the stream for a request (e.g. per :id); an empty EventStream gives 404
+using EventStreamSelector = std::function<EventStream(const Request&)>;
+
 // Type aliases for handler functions
 using RouteHandler = std::function<Response(const Request&)>;
 using MiddlewareHandler = std::function<bool(Request&, Response&)>;
 
+// Runs once the response exists (from the handler or a rejecting middleware),
+// before it is serialized: add headers, log, record timings
+using AfterResponseHandler = std::function<void(const Request&, Response&)>;
+
+// ===== MIDDLEWARE CHAINS =====
+
+// The middlewares of one route as flat lists. The framework builds one per
+// route at start(): global middlewares, then those of every prefix the route
+// pattern falls under, then the route's own. Requests only walk the lists; a
+// route that ends up with no middlewares skips them entirely.
+class MiddlewareChain {
+public:
+    void use(MiddlewareHandler middleware);
+    void after(AfterResponseHandler hook);
+
+    // Append other's middlewares and hooks after this chain's own
+    void append(const MiddlewareChain& other);
+    void clear();
+
+    bool empty() const { return before_.empty() && after_.empty(); }
+    bool has_before() const { return !before_.empty(); }
+    bool has_after() const { return !after_.empty(); }
+    size_t size() const { return before_.size() + after_.size(); }
+
+    // Run the middlewares in order; false when one rejected the request
+    // (res then holds its response)
+    bool run_before(Request& req, Response& res) const {
+        for (const auto& middleware : before_) {
+            if (!middleware(req, res)) return false;
+        }
+        return true;
+    }
+
+    // Run the hooks in reverse order: the route's own first, global ones last
+    void run_after(const Request& req, Response& res) const {
+        for (auto it = after_.rbegin(); it != after_.rend(); ++it) {
+            (*it)(req, res);
+        }
+    }
+
+private:
+    std::vector<MiddlewareHandler> before_;
+    std::vector<AfterResponseHandler> after_;
+};
+
+// Returned by route registration to attach middlewares to that route only.
+// Configure before start(); the handle may be dropped afterwards.
+class RouteHandle {
+public:
+    RouteHandle& use(MiddlewareHandler middleware);
+    RouteHandle& after(AfterResponseHandler hook);
+
+    // Run the route in a thread pool added with add_thread_pool()
+    RouteHandle& pool(const std::string& name);
+
+    // Cancel the request this long after it arrived (see CancellationToken):
+    // a request still queued then gets 504 without running the handler
+    RouteHandle& deadline(std::chrono::milliseconds timeout);
+
+private:
+    friend class RestApiFrameworkImpl;
+
+    struct Settings {
+        std::string pool;
+        std::chrono::milliseconds deadline{0};
+    };
+
+    std::shared_ptr<MiddlewareChain> chain_;
+    std::shared_ptr<Settings> settings_;
+};
+
+// Async handler: the Request is only valid during the call, copy what you need
+using AsyncRouteHandler = std::function<void(const Request&, AsyncResponse)>;
+
+// Streaming handler: Request::body is empty, the body is read from the stream
+using StreamingRouteHandler = std::function<Response(const Request&, BodyStream&)>;
+
+// Health check: return false (or throw, the message is reported) when the component is down
+using HealthCheckHandler = std::function<bool()>;
+
 // ===== MAIN FRAMEWORK CLASS =====
 class RestApiFramework {
 public:
@@ -106,22 +627,103 @@ public:
     // ===== ROUTE REGISTRATION =====
 
     // Register GET route
-    void get(const std::string& path, RouteHandler handler);
+    RouteHandle get(const std::string& path, RouteHandler handler);
 
     // Register POST route
-    void post(const std::string& path, RouteHandler handler);
+    RouteHandle post(const std::string& path, RouteHandler handler);
 
     // Register PUT route
-    void put(const std::string& path, RouteHandler handler);
+    RouteHandle put(const std::string& path, RouteHandler handler);
 
     // Register DELETE route
-    void del(const std::string& path, RouteHandler handler);
+    RouteHandle del(const std::string& path, RouteHandler handler);
+
+    // ===== ASYNC ROUTE REGISTRATION =====
+    // The handler returns immediately and completes the AsyncResponse later,
+    // so the worker thread is not held while waiting (e.g. on the database)
+
+    // Register async GET route
+    RouteHandle get_async(const std::string& path, AsyncRouteHandler handler);
+
+    // Register async POST route
+    RouteHandle post_async(const std::string& path, AsyncRouteHandler handler);
+
+    // Register async PUT route
+    RouteHandle put_async(const std::string& path, AsyncRouteHandler handler);
+
+    // Register async DELETE route
+    RouteHandle del_async(const std::string& path, AsyncRouteHandler handler);
+
+    // ===== STREAMING BODIES =====
+    // For large uploads: middlewares run before any of the body is read
+
+    // Register POST route that reads the body incrementally
+    RouteHandle post_stream(const std::string& path, StreamingRouteHandler handler);
+
+    // Register PUT route that reads the body incrementally
+    RouteHandle put_stream(const std::string& path, StreamingRouteHandler handler);
+
+    // Register POST route whose body is spooled to body_file past the threshold
+    // (the file is removed after the handler returns)
+    RouteHandle post_upload(const std::string& path, RouteHandler handler, UploadOptions options = UploadOptions());
+
+    // Register PUT route whose body is spooled to body_file past the threshold
+    RouteHandle put_upload(const std::string& path, RouteHandler handler, UploadOptions options = UploadOptions());
+
+    // ===== WEBSOCKET =====
+
+    // Register a WebSocket endpoint (RFC 6455 upgrade on GET path).
+    // Middlewares run on the upgrade request; a rejection closes with code 1008.
+    void websocket(const std::string& path, WebSocketHandlers handlers,
+                   WebSocketOptions options = WebSocketOptions());
+
+    // ===== SERVER-SENT EVENTS =====
+
+    // Serve one stream on a GET path (text/event-stream)
+    void sse(const std::string& path, EventStream stream);
+
+    // Choose the stream per request; middlewares run first and may reject
+    void sse(const std::string& path, EventStreamSelector selector);
+
+    // ===== RESPONSE CACHE =====
+    // Responses of cached routes live in shared memory, so a response computed
+    // by one worker process is served by all of them until it expires or is
+    // invalidated. Middlewares still run on every request.
+
+    // Register GET route whose responses are cached
+    RouteHandle get_cached(const std::string& path, RouteHandler handler, CacheOptions options = CacheOptions());
+
+    // Drop every cached response carrying the tag (e.g. from a write handler).
+    // Returns the number of responses removed.
+    size_t invalidate_cache(const std::string& tag);
+
+    // Drop every cached response
+    void clear_cache();
+
+    // ===== COMPILE-TIME ROUTE TABLES =====
+
+    // Serve the routes of a constexpr table built with make_route_table
+    // (include restapi_routes.hpp). Tables are consulted after the routes
+    // registered above; middlewares and CORS apply as usual.
+    template <const auto& Table>
+    void mount();
 
     // ===== MIDDLEWARE =====
 
     // Add middleware (executed before route handlers)
     void use(MiddlewareHandler middleware);
 
+    // Add middleware for the routes under a path prefix ("/admin" covers
+    // "/admin" and "/admin/...", not "/administrators"). Prefixes are matched
+    // against route patterns when the server starts, not per request.
+    void use(const std::string& prefix, MiddlewareHandler middleware);
+
+    // Add a hook run after every route handler
+    void after(AfterResponseHandler hook);
+
+    // Add a hook run after the handlers of the routes under a path prefix
+    void after(const std::string& prefix, AfterResponseHandler hook);
+
     // ===== STATIC FILES =====
 
     // Serve static files from a directory
@@ -140,18 +742,47 @@ public:
 
     // ===== CONFIGURATION =====
 
+    // Listen on a TCP address. Without any listen_* call the server
+    // listens on the constructor port (all interfaces).
+    void listen_tcp(int port, const std::string& host = "0.0.0.0");
+
+    // Listen on a Unix domain socket (e.g. behind a local proxy).
+    // mode sets the socket file permissions; the file is removed on shutdown.
+    void listen_unix(const std::string& path, unsigned int mode = 0660);
+
+    // Listen for HTTPS (TLS 1.3 only). cert_file holds the PEM certificate
+    // chain, key_file the PEM private key; both are loaded at start().
+    void listen_tls(int port, const std::string& cert_file, const std::string& key_file,
+                    const std::string& host = "0.0.0.0");
+
     // Set number of worker processes
     void set_workers(int count);
 
-    // Set thread pool size per worker
+    // Set thread pool size per worker (the default pool: reads every request,
+    // then runs the routes that have no pool of their own)
     void set_thread_pool_size(int size);
 
+    // Add a named pool per worker (bulkhead). Routes assigned to it run their
+    // body read, handler and send on its threads, so a slow group of endpoints
+    // cannot take the threads of the others. At most queue_limit requests wait
+    // for a thread; past that they get 503 with Retry-After. Up to 7 pools;
+    // adding a name again replaces it.
+    void add_thread_pool(const std::string& name, int threads, size_t queue_limit = 64);
+
+    // Run the routes under a path prefix in a named pool. A route's own
+    // pool() wins; otherwise the longest prefix applies.
+    void assign_pool(const std::string& prefix, const std::string& pool);
+
     // Enable/disable CORS
     void enable_cors(bool enable = true);
 
-    // Set CORS allowed origins
+    // Set CORS allowed origins: "*", one origin, or a comma-separated list
+    // (the request's Origin is echoed back when it is in the list)
     void set_cors_origins(const std::string& origins);
 
+    // How long browsers may cache a preflight (Access-Control-Max-Age)
+    void set_cors_max_age(int seconds);
+
     // Enable logging to file
     void enable_logging(const std::string& log_file = "server.log");
 
@@ -161,6 +792,98 @@ public:
     // Set shutdown timeout
     void set_shutdown_timeout(int seconds);
 
+    // Give 200 GET responses without an ETag of their own a strong ETag hashed
+    // from the body, so unchanged payloads are answered with 304. The body is
+    // still built; declare a Validator in the handler to skip that too.
+    void enable_etags(bool enable = true);
+
+    // Limit every route to options.requests per client per window. Over the
+    // limit the request gets 429 with Retry-After before its body is read or
+    // its handler runs; admitted responses carry RateLimit-Limit/-Remaining/
+    // -Reset headers. Buckets live in shared memory, so the limit holds across
+    // all workers.
+    void rate_limit(RateLimitOptions options);
+
+    // Same, for the routes under a path prefix ("/api" covers "/api" and
+    // "/api/...", not "/apis"). The longest matching prefix applies; calling
+    // it again for the same prefix replaces the earlier limit.
+    void rate_limit(const std::string& prefix, RateLimitOptions options);
+
+    // Number of client buckets shared by all policies (default 65536, rounded up
+    // to a power of two). When every bucket near a client's slot is in use the
+    // request is let through and counted in rest_api_rate_limit_saturated_total.
+    void set_rate_limit_capacity(size_t buckets);
+
+    // Bound how many requests run at once in each worker, with a limit that
+    // adapts to observed latency: when a dependency slows down (e.g. SQLite)
+    // the limit drops and excess requests wait briefly or get 503 with
+    // Retry-After, instead of piling up behind it.
+    void concurrency_limit(ConcurrencyLimitOptions options = ConcurrencyLimitOptions());
+
+    // Same, for the routes under a path prefix, with a limit of their own. The
+    // longest matching prefix applies; up to 8 prefixes.
+    void concurrency_limit(const std::string& prefix, ConcurrencyLimitOptions options);
+
+    // Cancel requests whose deadline has passed and, with watch_disconnects,
+    // whose client is gone. The deadline is the route's (or
+    // options.default_deadline_ms), shortened by the client's deadline_header.
+    // Handlers see it through Request::cancellation(), SQLite queries are
+    // interrupted, and a request cancelled before its handler runs gets 504
+    // (deadline) or 499 (disconnect). Route deadlines work without this call.
+    // watch_disconnects treats a client that half-closes after sending its
+    // request (legal HTTP) as gone and drops its response, so it is opt-in.
+    void enable_cancellation(CancellationOptions options = CancellationOptions());
+
+    // Largest body accepted by regular routes (read fully into Request::body).
+    // Larger requests get 413; use streaming or upload routes for big bodies.
+    void set_max_body_size(size_t bytes);
+
+    // Size of the shared response cache (created at start() when a cached
+    // route exists). Least recently used responses are evicted past either limit.
+    void set_response_cache_size(size_t max_bytes, size_t max_entries = 4096);
+
+    // Per-route request counts, status classes, bytes and latency percentiles,
+    // merged over all workers. Available once the server runs (also from handlers).
+    std::vector<RouteMetrics> route_metrics() const;
+
+    // Serve Prometheus metrics (text exposition format) on GET path: connections,
+    // worker state and restarts, queue depths, the per-route counters and latency
+    // histograms above, and the pools added below. A scrape only reads atomics
+    // in shared memory; it never takes a lock used by request processing.
+    void enable_metrics(const std::string& path = "/metrics");
+
+    // Give every request an ID (options.header, generated when the client sent
+    // none, echoed in the response) and record where its time goes: accept,
+    // queue, read, parse, middleware, handler, after hooks, database queries and
+    // send. Spans go to per-thread ring buffers in shared memory; SIGUSR2 to the
+    // master dumps them from all workers as Chrome trace-event JSON
+    // (chrome://tracing, Perfetto). Without this call the request path only
+    // tests a flag.
+    //
+    // options.path, off by default, also serves the dump over HTTP (?request_id=
+    // to filter). The route has no authentication and sits on the public
+    // listener: it returns every recorded span, with other clients' request
+    // IDs, paths and the first 48 bytes of each SQL statement. Check
+    // credentials for it in a global middleware, or leave it off and use SIGUSR2.
+    void enable_tracing(TracingOptions options = TracingOptions());
+
+    // Report a database pool under /metrics (label pool="name"). Pools are
+    // per process: the values are those of the worker answering the scrape.
+    // The pool must outlive the server.
+    void add_metrics_pool(const std::string& name, const ConnectionPool& pool);
+
+    // ===== ADMIN PORT =====
+    // Health probes and metrics on a separate port, answered by a thread of
+    // the master process from shared memory. They never wait behind user
+    // traffic for a worker thread, so probes keep answering under overload.
+    // Readiness is 200 when every worker is alive, none is draining and no
+    // health check failed; it turns 503 as soon as a graceful shutdown starts.
+    void enable_admin(int port, AdminOptions options = AdminOptions());
+
+    // Component check run periodically by the master process and reported on
+    // the readiness path and in the admin metrics
+    void add_health_check(const std::string& name, HealthCheckHandler check);
+
     // Get server port
     int get_port() const;
 
@@ -168,6 +891,8 @@ public:
     int get_workers() const;
 
 private:
+    void mount_table(std::shared_ptr<const RouteTableBase> table);
+
     // pImpl pattern - hide implementation details
     std::unique_ptr<RestApiFrameworkImpl> pImpl;
 };
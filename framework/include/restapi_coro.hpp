@@ -0,0 +1,272 @@
+#pragma once
+
+// C++20 coroutine layer for the REST API Framework (target: restapi_coro).
+// Build with -DRESTAPI_BUILD_COROUTINES=ON; the core library stays C++17.
+
+#if __cplusplus < 202002L
+#error "restapi_coro.hpp requires C++20 (link against the restapi_coro target)"
+#endif
+
+#include "restapi.hpp"
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class ConnectionPool;
+
+namespace RestAPI {
+namespace coro {
+
+// ===== TASK =====
+// Lazy coroutine result: starts when awaited and resumes the awaiting
+// coroutine when it finishes (symmetric transfer, no extra stack depth).
+
+template <typename T>
+class Task;
+
+namespace detail {
+
+struct FinalAwaiter {
+    bool await_ready() noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+        auto continuation = h.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+
+    void await_resume() noexcept {}
+};
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+} // namespace detail
+
+template <typename T>
+class Task {
+public:
+    struct promise_type : detail::PromiseBase {
+        std::optional<T> value;
+
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        template <typename U>
+        void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+
+    T await_resume() {
+        auto& promise = handle_.promise();
+        if (promise.error) std::rethrow_exception(promise.error);
+        return std::move(*promise.value);
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> h) : handle_(h) {}
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template <>
+class Task<void> {
+public:
+    struct promise_type : detail::PromiseBase {
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        void return_void() {}
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+
+    void await_resume() {
+        if (handle_.promise().error) std::rethrow_exception(handle_.promise().error);
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> h) : handle_(h) {}
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// ===== EVENT LOOP HOOKS (implemented in restapi_coro.cpp) =====
+
+namespace detail {
+
+// Resume a coroutine on the worker's event loop
+void resume_on_loop(std::coroutine_handle<> h);
+
+// Resume after a delay, on the worker's event loop
+void resume_after(std::chrono::milliseconds delay, std::coroutine_handle<> h);
+
+// Resume when fd is ready; `events` receives the epoll result
+void resume_when_ready(int fd, uint32_t interest, uint32_t* events, std::coroutine_handle<> h);
+
+// Run a job on the blocking pool (DB queries, DNS, file I/O)
+void submit_blocking(std::function<void()> job);
+
+} // namespace detail
+
+// ===== AWAITABLES =====
+
+// co_await sleep_for(100ms);
+struct SleepAwaiter {
+    std::chrono::milliseconds delay;
+
+    bool await_ready() const noexcept { return delay.count() <= 0; }
+    void await_suspend(std::coroutine_handle<> h) { detail::resume_after(delay, h); }
+    void await_resume() const noexcept {}
+};
+
+inline SleepAwaiter sleep_for(std::chrono::milliseconds delay) {
+    return SleepAwaiter{delay};
+}
+
+// co_await readable(fd) / writable(fd); returns the epoll events
+struct ReadyAwaiter {
+    int fd;
+    uint32_t interest;
+    uint32_t events = 0;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) {
+        detail::resume_when_ready(fd, interest, &events, h);
+    }
+    uint32_t await_resume() const noexcept { return events; }
+};
+
+ReadyAwaiter readable(int fd);
+ReadyAwaiter writable(int fd);
+
+// co_await run_blocking([] { return slow_call(); });
+// Runs the callable on the blocking pool, resumes on the event loop.
+// If the callable captures strings or containers, keep the awaiter in a named
+// local (auto job = run_blocking(...); co_await job;) - GCC 12 can corrupt
+// such prvalue co_await operands.
+template <typename F>
+class BlockingAwaiter {
+public:
+    using Result = std::invoke_result_t<F>;
+
+    explicit BlockingAwaiter(F fn) : fn_(std::move(fn)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> h) {
+        detail::submit_blocking([this, h]() {
+            try {
+                if constexpr (std::is_void_v<Result>) {
+                    fn_();
+                } else {
+                    result_.emplace(fn_());
+                }
+            } catch (...) {
+                error_ = std::current_exception();
+            }
+            detail::resume_on_loop(h);
+        });
+    }
+
+    Result await_resume() {
+        if (error_) std::rethrow_exception(error_);
+        if constexpr (!std::is_void_v<Result>) {
+            return std::move(*result_);
+        }
+    }
+
+private:
+    using Storage = std::conditional_t<std::is_void_v<Result>, bool, Result>;
+
+    F fn_;
+    std::optional<Storage> result_;
+    std::exception_ptr error_;
+};
+
+template <typename F>
+BlockingAwaiter<F> run_blocking(F fn) {
+    return BlockingAwaiter<F>(std::move(fn));
+}
+
+// ===== FRAMEWORK I/O =====
+
+using Rows = std::vector<std::map<std::string, std::string>>;
+
+// SELECT through a connection pool, without holding a worker thread
+Task<Rows> query(ConnectionPool& pool, std::string sql);
+
+// INSERT/UPDATE/DDL through a connection pool
+Task<bool> execute(ConnectionPool& pool, std::string sql);
+
+// Non-blocking socket helpers (fd must be O_NONBLOCK)
+Task<long> recv_some(int fd, char* buffer, size_t size);
+Task<bool> send_all(int fd, std::string data);
+
+// Outbound TCP connection; returns a non-blocking fd or -1
+Task<int> connect_tcp(std::string host, int port,
+                      std::chrono::milliseconds timeout = std::chrono::milliseconds(5000));
+
+// Minimal outbound HTTP/1.1 request; returns the raw response ("" on failure)
+Task<std::string> http_request(std::string host, int port, std::string method,
+                               std::string target, std::string body = "");
+
+// ===== ROUTE REGISTRATION =====
+
+// Coroutine handlers take the Request by value: it must outlive suspensions
+using CoroHandler = std::function<Task<Response>(Request)>;
+
+RouteHandle get(RestApiFramework& app, const std::string& path, CoroHandler handler);
+RouteHandle post(RestApiFramework& app, const std::string& path, CoroHandler handler);
+RouteHandle put(RestApiFramework& app, const std::string& path, CoroHandler handler);
+RouteHandle del(RestApiFramework& app, const std::string& path, CoroHandler handler);
+
+} // namespace coro
+} // namespace RestAPI
@@ -0,0 +1,606 @@
+#pragma once
+
+// Compile-time route tables.
+//
+// For services whose routes are fixed at build time: patterns are parsed and
+// validated by the compiler, a perfect hash over the routes is built at compile
+// time, and handlers are plain functions called directly (no std::function).
+//
+//   Response getUser(const Request& req);
+//
+//   static constexpr auto api_routes = RestAPI::make_route_table(
+//       RestAPI::routes::get("/api/users", &listUsers),
+//       RestAPI::routes::get("/api/users/:id", &getUser),
+//       RestAPI::routes::post("/api/users", +[](const Request& req) {
+//           return Response::json(201, req.getBody());
+//       }));
+//
+//   app.mount<api_routes>();
+//
+// A malformed pattern ("users", "/a//b", "/:", "/x/:id/:id") or two routes that
+// always match the same requests fail to compile.
+
+#include "restapi.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace RestAPI {
+
+enum class HttpMethod : uint8_t { GET, POST, PUT, DELETE, PATCH };
+
+// Plain function (or captureless lambda with unary +)
+using StaticHandler = Response (*)(const Request&);
+
+template <size_t N>
+class RouteTable;
+
+// Path parameters of a table match: views into the request path and the pattern.
+// Storage is left uninitialized until a match fills it, so it is free to declare.
+class RouteMatch {
+public:
+    static constexpr size_t MAX_PARAMS = 16;
+
+    size_t size() const { return count_; }
+    std::string_view name(size_t i) const { return std::string_view(names_[i].data, names_[i].size); }
+    std::string_view value(size_t i) const { return std::string_view(values_[i].data, values_[i].size); }
+
+private:
+    template <size_t N>
+    friend class RouteTable;
+
+    struct View {
+        const char* data;
+        size_t size;
+    };
+
+    View names_[MAX_PARAMS];
+    View values_[MAX_PARAMS];
+    size_t count_ = 0;
+};
+
+namespace detail {
+
+constexpr size_t MAX_SEGMENTS = 16;
+
+// A pattern split into segments; bit i of param_mask marks segment i as ":name"
+struct ParsedPattern {
+    std::string_view text;
+    size_t count = 0;
+    uint32_t param_mask = 0;
+    std::string_view segments[MAX_SEGMENTS] = {};  // Static text, or the parameter name
+};
+
+constexpr bool is_param_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+constexpr bool is_path_char(char c) {
+    return c > ' ' && c != 0x7f && c != '?' && c != '#' && c != ':';
+}
+
+// Throwing here inside a constant expression is what turns a bad pattern into a compile error
+constexpr ParsedPattern parse_pattern(std::string_view pattern) {
+    if (pattern.empty() || pattern[0] != '/') {
+        throw std::logic_error("route pattern must start with '/'");
+    }
+
+    ParsedPattern out;
+    out.text = pattern;
+
+    size_t pos = 1;
+    while (pos < pattern.size()) {
+        size_t end = pattern.find('/', pos);
+        if (end == std::string_view::npos) end = pattern.size();
+        std::string_view segment = pattern.substr(pos, end - pos);
+
+        if (segment.empty()) {
+            throw std::logic_error("empty segment in route pattern");
+        }
+        if (out.count == MAX_SEGMENTS) {
+            throw std::logic_error("route pattern has too many segments");
+        }
+
+        if (segment[0] == ':') {
+            std::string_view name = segment.substr(1);
+            if (name.empty()) {
+                throw std::logic_error("route parameter needs a name");
+            }
+            for (char c : name) {
+                if (!is_param_char(c)) throw std::logic_error("invalid character in route parameter name");
+            }
+            for (size_t i = 0; i < out.count; i++) {
+                if ((out.param_mask >> i & 1u) && out.segments[i] == name) {
+                    throw std::logic_error("duplicate route parameter name");
+                }
+            }
+            out.param_mask |= 1u << out.count;
+            out.segments[out.count++] = name;
+        } else {
+            for (char c : segment) {
+                if (!is_path_char(c)) throw std::logic_error("invalid character in route pattern");
+            }
+            out.segments[out.count++] = segment;
+        }
+
+        pos = end + 1;
+    }
+    return out;
+}
+
+// Route keys: each segment is hashed once, 8 bytes at a time, then the hashes of
+// the static segments are folded into a seed made of method, segment count and
+// parameter mask. Parameter segments are left out, so a request path hashes like
+// its pattern.
+constexpr uint64_t HASH_MUL = 0x9E3779B97F4A7C15ull;
+constexpr uint64_t SEGMENT_SEED = 0x452821E638D01377ull;
+
+constexpr uint64_t combine(uint64_t h, uint64_t value) {
+    h = (h ^ value) * HASH_MUL;
+    return h ^ (h >> 29);
+}
+
+// Run-time load of n <= 8 bytes as a little-endian word, with fixed-size copies
+// (plain loads once optimized)
+inline uint64_t load_word_le(const char* p, size_t n) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    uint64_t word = 0;
+    for (size_t k = 0; k < n; k++) word |= static_cast<uint64_t>(static_cast<uint8_t>(p[k])) << (8 * k);
+    return word;
+#else
+    if (n == 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        return word;
+    }
+    uint64_t word = 0;
+    unsigned shift = 0;
+    if (n & 4) {
+        uint32_t part;
+        std::memcpy(&part, p, 4);
+        word = part;
+        p += 4;
+        shift = 32;
+    }
+    if (n & 2) {
+        uint16_t part;
+        std::memcpy(&part, p, 2);
+        word |= static_cast<uint64_t>(part) << shift;
+        p += 2;
+        shift += 16;
+    }
+    if (n & 1) {
+        word |= static_cast<uint64_t>(static_cast<uint8_t>(*p)) << shift;
+    }
+    return word;
+#endif
+}
+
+// Same word, usable in constant expressions
+constexpr uint64_t load_word(std::string_view s, size_t at, size_t n) {
+#if defined(__GNUC__)
+    if (!__builtin_is_constant_evaluated()) return load_word_le(s.data() + at, n);
+#endif
+    uint64_t word = 0;
+    for (size_t k = 0; k < n; k++) {
+        word |= static_cast<uint64_t>(static_cast<uint8_t>(s[at + k])) << (8 * k);
+    }
+    return word;
+}
+
+// Short-string equality with word compares (segments are a few bytes long)
+inline bool same_bytes(const char* a, const char* b, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        if (load_word_le(a + i, 8) != load_word_le(b + i, 8)) return false;
+    }
+    return i == n || load_word_le(a + i, n - i) == load_word_le(b + i, n - i);
+}
+
+// Must give the same value as the scan in RouteTable::match
+constexpr uint64_t segment_hash(std::string_view segment) {
+    uint64_t h = SEGMENT_SEED;
+    size_t i = 0;
+    for (; i + 8 <= segment.size(); i += 8) h = combine(h, load_word(segment, i, 8));
+    if (i < segment.size()) h = combine(h, load_word(segment, i, segment.size() - i));
+    return h ^ segment.size();
+}
+
+constexpr uint64_t key_seed(HttpMethod method, size_t count, uint32_t mask) {
+    return combine(0x243F6A8885A308D3ull,
+                   static_cast<uint64_t>(method) << 40 | static_cast<uint64_t>(count) << 32 | mask);
+}
+
+// Segment hashes are added, rotated by position: independent of each other, so the
+// CPU overlaps them (the slot finalizer does the mixing)
+constexpr uint64_t key_part(uint64_t segment_hash, size_t position) {
+    unsigned r = 1 + static_cast<unsigned>(position * 11 % 63);
+    return (segment_hash << r) | (segment_hash >> (64 - r));
+}
+
+constexpr uint64_t key_hash(HttpMethod method, size_t count, uint32_t mask, const uint64_t* segment_hashes) {
+    uint64_t h = key_seed(method, count, mask);
+    for (size_t i = 0; i < count; i++) {
+        if (!(mask >> i & 1u)) h += key_part(segment_hashes[i], i);
+    }
+    return h;
+}
+
+// Second level of the perfect hash: multiply-shift keyed by the bucket's displacement
+constexpr size_t displaced_slot(uint64_t h, uint32_t displacement, unsigned slot_bits) {
+    uint64_t x = (h ^ (displacement * HASH_MUL)) * 0xff51afd7ed558ccdull;
+    return slot_bits == 0 ? 0 : static_cast<size_t>(x >> (64 - slot_bits));
+}
+
+constexpr size_t next_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+constexpr unsigned log2(size_t pow2) {
+    unsigned bits = 0;
+    while ((size_t(1) << bits) < pow2) bits++;
+    return bits;
+}
+
+constexpr bool method_from_string(std::string_view name, HttpMethod& out) {
+    switch (name.size()) {
+        case 3:
+            if (name == "GET") { out = HttpMethod::GET; return true; }
+            if (name == "PUT") { out = HttpMethod::PUT; return true; }
+            return false;
+        case 4:
+            if (name == "POST") { out = HttpMethod::POST; return true; }
+            return false;
+        case 5:
+            if (name == "PATCH") { out = HttpMethod::PATCH; return true; }
+            return false;
+        case 6:
+            if (name == "DELETE") { out = HttpMethod::DELETE; return true; }
+            return false;
+        default:
+            return false;
+    }
+}
+
+} // namespace detail
+
+// One entry of a RouteTable
+struct StaticRoute {
+    HttpMethod method;
+    detail::ParsedPattern pattern;
+    StaticHandler handler;
+};
+
+namespace routes {
+
+constexpr StaticRoute route(HttpMethod method, std::string_view pattern, StaticHandler handler) {
+    if (!handler) throw std::logic_error("route handler is null");
+    return StaticRoute{method, detail::parse_pattern(pattern), handler};
+}
+
+constexpr StaticRoute get(std::string_view pattern, StaticHandler handler) {
+    return route(HttpMethod::GET, pattern, handler);
+}
+
+constexpr StaticRoute post(std::string_view pattern, StaticHandler handler) {
+    return route(HttpMethod::POST, pattern, handler);
+}
+
+constexpr StaticRoute put(std::string_view pattern, StaticHandler handler) {
+    return route(HttpMethod::PUT, pattern, handler);
+}
+
+constexpr StaticRoute del(std::string_view pattern, StaticHandler handler) {
+    return route(HttpMethod::DELETE, pattern, handler);
+}
+
+constexpr StaticRoute patch(std::string_view pattern, StaticHandler handler) {
+    return route(HttpMethod::PATCH, pattern, handler);
+}
+
+} // namespace routes
+
+// N routes with a two-level perfect hash (hash and displace), all computed by the
+// compiler. A lookup splits the path once, then for each route shape (segment count
+// + parameter positions) of that length hashes the static segments and probes
+// exactly one slot. Shapes are tried static-first, segment by segment, which gives
+// the same precedence as the dynamic router ("/users/me" beats "/users/:id").
+template <size_t N>
+class RouteTable {
+    static_assert(N > 0, "a route table needs at least one route");
+
+public:
+    static constexpr size_t SLOTS = detail::next_pow2(N * 2);
+    static constexpr size_t BUCKETS = (N + 1) / 2;
+    static constexpr unsigned SLOT_BITS = detail::log2(SLOTS);
+
+    StaticRoute routes[N];
+
+    template <typename... Routes>
+    constexpr explicit RouteTable(const Routes&... r)
+        : routes{r...}
+    {
+        build();
+    }
+
+    static constexpr size_t size() { return N; }
+
+    // Index of the matching route, or -1. params views point into path.
+    int match(HttpMethod method, std::string_view path, RouteMatch& params) const {
+        struct Segment {
+            size_t begin;
+            size_t size;
+        };
+        Segment segments[detail::MAX_SEGMENTS];   // Left uninitialized: only [0, count) is read
+        uint64_t hashes[detail::MAX_SEGMENTS];
+        size_t count = 0;
+
+        // One pass, 8 bytes at a time: a word without '/' is hashed whole, the
+        // first '/' (SWAR zero-byte test on word ^ "////////") ends the segment.
+        // Empty segments ("//", trailing "/") are skipped, as in the dynamic router.
+        const char* data = path.data();
+        size_t size = path.size();
+        size_t pos = 0;
+        while (pos < size) {
+            if (data[pos] == '/') {
+                pos++;
+                continue;
+            }
+            if (count == detail::MAX_SEGMENTS) return -1;
+
+            size_t begin = pos;
+            uint64_t h = detail::SEGMENT_SEED;
+            while (pos < size) {
+                size_t take = size - pos < 8 ? size - pos : 8;
+                uint64_t word = detail::load_word_le(data + pos, take);
+                uint64_t x = word ^ 0x2F2F2F2F2F2F2F2Full;
+                uint64_t slash = (x - 0x0101010101010101ull) & ~x & 0x8080808080808080ull;
+                if (slash) {
+                    // The lowest flagged byte is always a real '/' (padding bytes are 0, not '/')
+                    size_t k = static_cast<size_t>(__builtin_ctzll(slash)) / 8;
+                    if (k > 0) h = detail::combine(h, word & ((1ull << (8 * k)) - 1));
+                    pos += k;
+                    break;
+                }
+                h = detail::combine(h, word);
+                pos += take;
+            }
+
+            segments[count] = Segment{begin, pos - begin};
+            hashes[count] = h ^ (pos - begin);
+            count++;
+        }
+
+        for (size_t s = shape_begin_[count]; s < shape_begin_[count + 1]; s++) {
+            uint32_t mask = shapes_[s].mask;
+            uint64_t h = detail::key_seed(method, count, mask);
+            for (size_t i = 0; i < count; i++) {
+                if (!(mask >> i & 1u)) h += detail::key_part(hashes[i], i);
+            }
+
+            uint16_t slot = slots_[slot_of(h)];
+            if (slot == 0 || keys_[slot - 1] != h) continue;
+
+            // Same hash: confirm the key itself
+            const StaticRoute& candidate = routes[slot - 1];
+            if (candidate.method != method || candidate.pattern.param_mask != mask ||
+                candidate.pattern.count != count) {
+                continue;
+            }
+
+            bool same = true;
+            for (size_t i = 0; i < count && same; i++) {
+                if (!(mask >> i & 1u)) {
+                    std::string_view expected = candidate.pattern.segments[i];
+                    same = expected.size() == segments[i].size &&
+                           detail::same_bytes(expected.data(), data + segments[i].begin, segments[i].size);
+                }
+            }
+            if (!same) continue;
+
+            params.count_ = 0;
+            for (size_t i = 0; i < count; i++) {
+                if (mask >> i & 1u) {
+                    std::string_view name = candidate.pattern.segments[i];
+                    params.names_[params.count_] = RouteMatch::View{name.data(), name.size()};
+                    params.values_[params.count_] = RouteMatch::View{data + segments[i].begin, segments[i].size};
+                    params.count_++;
+                }
+            }
+            return static_cast<int>(slot - 1);
+        }
+        return -1;
+    }
+
+private:
+    struct Shape {
+        size_t count = 0;
+        uint32_t mask = 0;
+    };
+
+    uint16_t slots_[SLOTS] = {};          // Route index + 1; 0 = empty
+    uint64_t keys_[N] = {};               // Key hash of each route
+    uint32_t displacement_[BUCKETS] = {};
+    Shape shapes_[N] = {};                // Distinct shapes, in match order
+    size_t shape_count_ = 0;
+    size_t shape_begin_[detail::MAX_SEGMENTS + 2] = {};  // Shapes with c segments: [begin[c], begin[c + 1])
+
+    static constexpr size_t bucket_of(uint64_t h) {
+        return static_cast<size_t>((h >> 32) % BUCKETS);
+    }
+
+    constexpr size_t slot_of(uint64_t h) const {
+        return detail::displaced_slot(h, displacement_[bucket_of(h)], SLOT_BITS);
+    }
+
+    // a before b when, at the first segment where they differ, a is static
+    static constexpr bool shape_before(const Shape& a, const Shape& b) {
+        if (a.count != b.count) return a.count < b.count;
+        uint32_t diff = a.mask ^ b.mask;
+        if (diff == 0) return false;
+        uint32_t lowest = diff & (~diff + 1);
+        return (a.mask & lowest) == 0;
+    }
+
+    static constexpr bool same_key(const StaticRoute& a, const StaticRoute& b) {
+        if (a.method != b.method || a.pattern.count != b.pattern.count ||
+            a.pattern.param_mask != b.pattern.param_mask) {
+            return false;
+        }
+        for (size_t i = 0; i < a.pattern.count; i++) {
+            if (a.pattern.param_mask >> i & 1u) continue;
+            if (a.pattern.segments[i] != b.pattern.segments[i]) return false;
+        }
+        return true;
+    }
+
+    constexpr void build() {
+        static_assert(N < 65535, "route table too large");
+
+        uint64_t hashes[N] = {};
+        for (size_t i = 0; i < N; i++) {
+            const detail::ParsedPattern& pattern = routes[i].pattern;
+            uint64_t segment_hashes[detail::MAX_SEGMENTS] = {};
+            for (size_t k = 0; k < pattern.count; k++) segment_hashes[k] = detail::segment_hash(pattern.segments[k]);
+            hashes[i] = detail::key_hash(routes[i].method, pattern.count, pattern.param_mask, segment_hashes);
+            keys_[i] = hashes[i];
+
+            for (size_t j = 0; j < i; j++) {
+                // "/users/:id" and "/users/:name" are the same route
+                if (same_key(routes[i], routes[j])) throw std::logic_error("duplicate route in table");
+                if (hashes[i] == hashes[j]) throw std::logic_error("route hash collision");
+            }
+        }
+
+        // Shapes, sorted by precedence
+        for (size_t i = 0; i < N; i++) {
+            Shape shape{routes[i].pattern.count, routes[i].pattern.param_mask};
+            bool seen = false;
+            for (size_t s = 0; s < shape_count_ && !seen; s++) {
+                seen = shapes_[s].count == shape.count && shapes_[s].mask == shape.mask;
+            }
+            if (seen) continue;
+
+            size_t at = shape_count_++;
+            while (at > 0 && shape_before(shape, shapes_[at - 1])) {
+                shapes_[at] = shapes_[at - 1];
+                at--;
+            }
+            shapes_[at] = shape;
+        }
+        for (size_t c = 0, s = 0; c <= detail::MAX_SEGMENTS + 1; c++) {
+            while (s < shape_count_ && shapes_[s].count < c) s++;
+            shape_begin_[c] = s;
+        }
+
+        // Buckets, largest first: each gets the first displacement that puts
+        // all of its keys into free, distinct slots
+        size_t bucket_size[BUCKETS] = {};
+        for (size_t i = 0; i < N; i++) bucket_size[bucket_of(hashes[i])]++;
+
+        bool placed[BUCKETS] = {};
+        for (size_t round = 0; round < BUCKETS; round++) {
+            size_t bucket = BUCKETS;
+            for (size_t b = 0; b < BUCKETS; b++) {
+                if (placed[b] || bucket_size[b] == 0) continue;
+                if (bucket == BUCKETS || bucket_size[b] > bucket_size[bucket]) bucket = b;
+            }
+            if (bucket == BUCKETS) break;
+            placed[bucket] = true;
+
+            for (uint32_t d = 1;; d++) {
+                if (d == 1u << 20) throw std::logic_error("could not build perfect hash for route table");
+
+                size_t taken[N] = {};
+                size_t taken_count = 0;
+                bool fits = true;
+                for (size_t i = 0; i < N && fits; i++) {
+                    if (bucket_of(hashes[i]) != bucket) continue;
+                    size_t slot = detail::displaced_slot(hashes[i], d, SLOT_BITS);
+                    if (slots_[slot] != 0) fits = false;
+                    for (size_t t = 0; t < taken_count && fits; t++) {
+                        if (taken[t] == slot) fits = false;
+                    }
+                    taken[taken_count++] = slot;
+                }
+                if (!fits) continue;
+
+                displacement_[bucket] = d;
+                for (size_t i = 0; i < N; i++) {
+                    if (bucket_of(hashes[i]) != bucket) continue;
+                    slots_[detail::displaced_slot(hashes[i], d, SLOT_BITS)] =
+                        static_cast<uint16_t>(i + 1);
+                }
+                break;
+            }
+        }
+    }
+};
+
+template <typename... Routes>
+constexpr RouteTable<sizeof...(Routes)> make_route_table(const Routes&... routes) {
+    return RouteTable<sizeof...(Routes)>(routes...);
+}
+
+// Non-template view of a mounted table, used by the framework at run time
+class RouteTableBase {
+public:
+    virtual ~RouteTableBase() = default;
+
+    // Index of the matching route, or -1
+    virtual int match(std::string_view method, std::string_view path, RouteMatch& params) const = 0;
+
+    // Run the handler of route index
+    virtual Response call(int index, const Request& req) const = 0;
+
+    // Number of routes and the pattern of route index (to resolve middlewares)
+    virtual size_t size() const = 0;
+    virtual std::string_view pattern(int index) const = 0;
+};
+
+// Table must be a constexpr object with static storage duration: its handler
+// pointers are then constants and every call below is a direct call
+template <const auto& Table>
+class RouteTableDispatcher final : public RouteTableBase {
+    static constexpr size_t COUNT = std::decay_t<decltype(Table)>::size();
+
+public:
+    int match(std::string_view method, std::string_view path, RouteMatch& params) const override {
+        HttpMethod m = HttpMethod::GET;
+        if (!detail::method_from_string(method, m)) return -1;
+        return Table.match(m, path, params);
+    }
+
+    Response call(int index, const Request& req) const override {
+        return invoke(index, req, std::make_index_sequence<COUNT>{});
+    }
+
+    size_t size() const override { return COUNT; }
+
+    std::string_view pattern(int index) const override {
+        return Table.routes[static_cast<size_t>(index)].pattern.text;
+    }
+
+private:
+    // Compiles to a switch on index with one direct call per case
+    template <size_t... I>
+    static Response invoke(int index, const Request& req, std::index_sequence<I...>) {
+        Response out;
+        (void)((index == static_cast<int>(I) ? (out = Table.routes[I].handler(req), true) : false) || ...);
+        return out;
+    }
+};
+
+template <const auto& Table>
+void RestApiFramework::mount() {
+    mount_table(std::make_shared<const RouteTableDispatcher<Table>>());
+}
+
+} // namespace RestAPI
@@ -0,0 +1,278 @@
+#include "restapi_coro.hpp"
+
+// Include infrastructure layer
+#include "../../../infrastructure/include/core/eventloop.hpp"
+#include "../../../infrastructure/include/core/threadpool.hpp"
+#include "../../../infrastructure/include/data/connectionpool.hpp"
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+
+namespace RestAPI {
+namespace coro {
+
+// ===== EVENT LOOP HOOKS =====
+
+namespace detail {
+
+void resume_on_loop(std::coroutine_handle<> h) {
+    EventLoop::instance().post([h]() { h.resume(); });
+}
+
+void resume_after(std::chrono::milliseconds delay, std::coroutine_handle<> h) {
+    EventLoop::instance().run_after(delay, [h]() { h.resume(); });
+}
+
+void resume_when_ready(int fd, uint32_t interest, uint32_t* events, std::coroutine_handle<> h) {
+    bool ok = EventLoop::instance().watch_once(fd, interest, [events, h](uint32_t ev) {
+        *events = ev;
+        h.resume();
+    });
+    if (!ok) {
+        // fd invalid: resume with an error so the caller sees it
+        *events = EPOLLERR;
+        resume_on_loop(h);
+    }
+}
+
+// Blocking pool per process (recreated after fork, like the event loop)
+static ThreadPool& blocking_pool() {
+    static std::mutex pool_mutex;
+    static std::unique_ptr<ThreadPool> pool;
+    static pid_t owner = 0;
+
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    if (!pool || owner != getpid()) {
+        if (pool && owner != getpid()) {
+            pool.release();  // Threads were not inherited by this process
+        }
+        pool = std::make_unique<ThreadPool>(4);
+        owner = getpid();
+    }
+    return *pool;
+}
+
+void submit_blocking(std::function<void()> job) {
+    blocking_pool().enqueue(std::move(job));
+}
+
+} // namespace detail
+
+// ===== AWAITABLES =====
+
+ReadyAwaiter readable(int fd) {
+    return ReadyAwaiter{fd, EPOLLIN | EPOLLRDHUP};
+}
+
+ReadyAwaiter writable(int fd) {
+    return ReadyAwaiter{fd, EPOLLOUT};
+}
+
+// ===== FRAMEWORK I/O =====
+
+// Awaiters that own non-trivial state are kept in named locals: GCC 12 can
+// mis-handle such prvalue operands of co_await inside the coroutine frame.
+
+Task<Rows> query(ConnectionPool& pool, std::string sql) {
+    auto job = run_blocking([&pool, sql = std::move(sql)]() {
+        auto conn = pool.acquire();
+        return conn->query(sql);
+    });
+    co_return co_await job;
+}
+
+Task<bool> execute(ConnectionPool& pool, std::string sql) {
+    auto job = run_blocking([&pool, sql = std::move(sql)]() {
+        auto conn = pool.acquire();
+        return conn->execute(sql);
+    });
+    co_return co_await job;
+}
+
+Task<long> recv_some(int fd, char* buffer, size_t size) {
+    while (true) {
+        ssize_t n = ::recv(fd, buffer, size, MSG_DONTWAIT);
+        if (n >= 0) co_return n;
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) co_return -1;
+
+        uint32_t events = co_await readable(fd);
+        if ((events & EPOLLERR) && !(events & EPOLLIN)) co_return -1;
+    }
+}
+
+Task<bool> send_all(int fd, std::string data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) co_return false;
+
+        uint32_t events = co_await writable(fd);
+        if (events & (EPOLLERR | EPOLLHUP)) co_return false;
+    }
+    co_return true;
+}
+
+namespace {
+
+struct ResolvedAddress {
+    sockaddr_storage addr;
+    socklen_t len = 0;
+    int family = AF_UNSPEC;
+};
+
+ResolvedAddress resolve(const std::string& host, int port) {
+    ResolvedAddress out;
+
+    struct addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo* result = nullptr;
+    std::string service = std::to_string(port);
+    if (getaddrinfo(host.c_str(), service.c_str(), &hints, &result) != 0 || !result) {
+        return out;
+    }
+
+    std::memcpy(&out.addr, result->ai_addr, result->ai_addrlen);
+    out.len = result->ai_addrlen;
+    out.family = result->ai_family;
+    freeaddrinfo(result);
+    return out;
+}
+
+} // namespace
+
+Task<int> connect_tcp(std::string host, int port, std::chrono::milliseconds timeout) {
+    // DNS is blocking: resolve on the blocking pool
+    auto lookup = run_blocking([host, port]() { return resolve(host, port); });
+    ResolvedAddress target = co_await lookup;
+    if (target.family == AF_UNSPEC) co_return -1;
+
+    int fd = ::socket(target.family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) co_return -1;
+
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&target.addr), target.len) == 0) {
+        co_return fd;
+    }
+    if (errno != EINPROGRESS) {
+        ::close(fd);
+        co_return -1;
+    }
+
+    // Timeout: shutdown() wakes the pending writable() wait with an error.
+    // Both the timer and the resumption run on the loop thread.
+    auto done = std::make_shared<bool>(false);
+    EventLoop::instance().run_after(timeout, [fd, done]() {
+        if (!*done) ::shutdown(fd, SHUT_RDWR);
+    });
+
+    co_await writable(fd);
+    *done = true;
+
+    int error = 0;
+    socklen_t len = sizeof(error);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) != 0 || error != 0) {
+        ::close(fd);
+        co_return -1;
+    }
+    co_return fd;
+}
+
+Task<std::string> http_request(std::string host, int port, std::string method,
+                               std::string target, std::string body) {
+    int fd = co_await connect_tcp(host, port);
+    if (fd < 0) co_return std::string();
+
+    std::string request = method + " " + target + " HTTP/1.1\r\n"
+                          "Host: " + host + "\r\n"
+                          "Connection: close\r\n"
+                          "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+
+    std::string response;
+    if (co_await send_all(fd, std::move(request))) {
+        char buffer[8192];
+        while (true) {
+            long n = co_await recv_some(fd, buffer, sizeof(buffer));
+            if (n <= 0) break;
+            response.append(buffer, static_cast<size_t>(n));
+        }
+    }
+
+    ::close(fd);
+    co_return response;
+}
+
+// ===== ROUTE REGISTRATION =====
+
+namespace {
+
+// Fire-and-forget root coroutine: owns the handler task until it completes
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() {
+            std::cerr << "[Coro] Unhandled exception in detached coroutine\n";
+        }
+    };
+};
+
+Detached drive(std::shared_ptr<CoroHandler> handler, Request req, AsyncResponse res) {
+    try {
+        Response response = co_await (*handler)(std::move(req));
+        res.send(response);
+    } catch (const std::exception& e) {
+        std::cerr << "[Coro] Handler error: " << e.what() << "\n";
+        res.send(Response::json(500, std::string("{\"error\":\"") + e.what() + "\"}"));
+    }
+}
+
+using AsyncRegister = RouteHandle (RestApiFramework::*)(const std::string&, AsyncRouteHandler);
+
+RouteHandle registerCoro(RestApiFramework& app, AsyncRegister reg, const std::string& path, CoroHandler handler) {
+    auto shared = std::make_shared<CoroHandler>(std::move(handler));
+
+    // Runs on the pool thread until the first suspension,
+    // then continues on the worker's event loop
+    return (app.*reg)(path, [shared](const Request& req, AsyncResponse res) {
+        drive(shared, req, res);
+    });
+}
+
+} // namespace
+
+RouteHandle get(RestApiFramework& app, const std::string& path, CoroHandler handler) {
+    return registerCoro(app, &RestApiFramework::get_async, path, std::move(handler));
+}
+
+RouteHandle post(RestApiFramework& app, const std::string& path, CoroHandler handler) {
+    return registerCoro(app, &RestApiFramework::post_async, path, std::move(handler));
+}
+
+RouteHandle put(RestApiFramework& app, const std::string& path, CoroHandler handler) {
+    return registerCoro(app, &RestApiFramework::put_async, path, std::move(handler));
+}
+
+RouteHandle del(RestApiFramework& app, const std::string& path, CoroHandler handler) {
+    return registerCoro(app, &RestApiFramework::del_async, path, std::move(handler));
+}
+
+} // namespace coro
+} // namespace RestAPI
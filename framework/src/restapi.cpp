@@ -1,89 +1,810 @@
 #include "restapi.hpp"
+#include "restapi_routes.hpp"
 
 // Include infrastructure layer
 #include "../../infrastructure/include/core/server.hpp"
+#include "../../infrastructure/include/core/listener.hpp"
+#include "../../infrastructure/include/core/worker.hpp"
+#include "../../infrastructure/include/core/healthcheck.hpp"
 #include "../../infrastructure/include/http/router.hpp"
 #include "../../infrastructure/include/http/request.hpp"
 #include "../../infrastructure/include/http/response.hpp"
+#include "../../infrastructure/include/http/completion.hpp"
+#include "../../infrastructure/include/http/websocket.hpp"
+#include "../../infrastructure/include/http/sse.hpp"
+#include "../../infrastructure/include/http/body.hpp"
+#include "../../infrastructure/include/http/cors.hpp"
+#include "../../infrastructure/include/http/routestats.hpp"
+#include "../../infrastructure/include/http/metrics.hpp"
+#include "../../infrastructure/include/http/ratelimit.hpp"
+#include "../../infrastructure/include/core/concurrencylimit.hpp"
+#include "../../infrastructure/include/core/trace.hpp"
+#include "../../infrastructure/include/core/cancellation.hpp"
+#include "../../infrastructure/include/http/responsecache.hpp"
+#include "../../infrastructure/include/sync/singleflight.hpp"
 
+#include <unistd.h>
+#include <time.h>
+#include <cctype>
+#include <cinttypes>
+#include <cstdio>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <stdexcept>
 
 namespace RestAPI {
 
 // ===== HELPER FUNCTIONS =====
 
-// Parse query parameters from target (/path?key=val&...)
-static std::map<std::string, std::string> parseQuery(const std::string& target) {
-    std::map<std::string, std::string> out;
-    auto qpos = target.find('?');
-    if (qpos == std::string::npos) return out;
+// Reason phrase for the status line
+static const char* statusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 204: return "No Content";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 408: return "Request Timeout";
+        case 413: return "Payload Too Large";
+        case 499: return "Client Closed Request";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        case 504: return "Gateway Timeout";
+        default: return "Unknown";
+    }
+}
 
-    auto q = target.substr(qpos + 1);
-    size_t i = 0;
-    while (i < q.size()) {
-        size_t amp = q.find('&', i);
-        std::string pair = (amp == std::string::npos) ? q.substr(i) : q.substr(i, amp - i);
+// Serialize RestAPI::Response into a new string: sizes are summed first, so
+// the status line, headers and body take one pre-sized allocation. The worker
+// then sends it with its own header block (request ID, RateLimit-*) spliced
+// in by writev.
+// extraHeaders is a serialized block ("Name: value\r\n"...), e.g. CORS;
+// it is skipped when the handler set its own Access-Control-Allow-Origin.
+static std::string convertResponse(const Response& response, const std::string& extraHeaders = std::string()) {
+    const char* reason = statusText(response.status);
+
+    char status[16];
+    char* status_end = std::to_chars(status, status + sizeof(status), response.status).ptr;
+    char length[24];
+    char* length_end = std::to_chars(length, length + sizeof(length), response.body.size()).ptr;
+
+    bool extra = !extraHeaders.empty() &&
+                 response.headers.find("Access-Control-Allow-Origin") == response.headers.end();
+    // One response per connection: tell clients and proxies the socket is closing
+    bool close = response.headers.find("Connection") == response.headers.end();
+    // A 304 has no body; a Content-Length would describe the 200 it stands for
+    bool has_length = response.status != 304;
+
+    size_t size = 9 + (status_end - status) + 1 + std::strlen(reason) + 2;   // "HTTP/1.1 200 OK\r\n"
+    for (const auto& [key, value] : response.headers) {
+        size += key.size() + 2 + value.size() + 2;
+    }
+    if (extra) size += extraHeaders.size();
+    if (has_length) size += 16 + (length_end - length) + 2;                   // Content-Length
+    if (close) size += 19;                                                    // Connection: close
+    size += 2 + response.body.size();
+
+    std::string out;
+    out.reserve(size);
+
+    out.append("HTTP/1.1 ");
+    out.append(status, status_end);
+    out.push_back(' ');
+    out.append(reason);
+    out.append("\r\n");
+
+    for (const auto& [key, value] : response.headers) {
+        out.append(key);
+        out.append(": ");
+        out.append(value);
+        out.append("\r\n");
+    }
+    if (extra) out.append(extraHeaders);
+
+    if (has_length) {
+        out.append("Content-Length: ");
+        out.append(length, length_end);
+        out.append("\r\n");
+    }
+    if (close) out.append("Connection: close\r\n");
+
+    out.append("\r\n");
+    out.append(response.body);
+    return out;
+}
+
+// ===== REQUEST =====
+
+struct Request::Owned {
+    std::string method;
+    std::string path;
+    std::string target;
+    std::string body;
+    std::string raw;
+    std::map<std::string, std::string> headers;
+};
+
+static const std::string EMPTY_STRING;
+static const std::map<std::string, std::string> NO_HEADERS;
+
+Request::Request()
+    : method_(&EMPTY_STRING), path_(&EMPTY_STRING), target_(&EMPTY_STRING), body_(&EMPTY_STRING),
+      raw_(&EMPTY_STRING), headers_(&NO_HEADERS) {}
+
+Request::Request(const HttpRequest& http)
+    : cancellation_(http.cancellation), method_(&http.method), path_(&http.path), target_(&http.target),
+      body_(&http.body), raw_(&http.raw), headers_(&http.headers) {}
+
+Request::Request(const Request& other) : params(other.params), body_file_(other.body_file_) {
+    detach(other);
+}
+
+// A moved-from view may not outlive the HttpRequest either: moving detaches too
+Request::Request(Request&& other) : params(other.params), body_file_(std::move(other.body_file_)) {
+    detach(other);
+}
+
+Request& Request::operator=(const Request& other) {
+    if (this != &other) {
+        params = other.params;
+        body_file_ = other.body_file_;
+        detach(other);
+    }
+    return *this;
+}
+
+Request& Request::operator=(Request&& other) {
+    if (this != &other) {
+        params = other.params;
+        body_file_ = std::move(other.body_file_);
+        detach(other);
+    }
+    return *this;
+}
+
+Request::~Request() = default;
+
+void Request::detach(const Request& from) {
+    // Copies of a copy share the same immutable data
+    if (!from.owned_) {
+        auto owned = std::make_shared<Owned>();
+        owned->method = *from.method_;
+        owned->path = *from.path_;
+        owned->target = *from.target_;
+        owned->raw = *from.raw_;
+        owned->headers = *from.headers_;
+        if (!from.body_owned_) owned->body = *from.body_;
+        owned_ = std::move(owned);
+    } else {
+        owned_ = from.owned_;
+    }
+    body_owned_ = from.body_owned_;
+    cancellation_ = from.cancellation_;
+
+    method_ = &owned_->method;
+    path_ = &owned_->path;
+    target_ = &owned_->target;
+    raw_ = &owned_->raw;
+    headers_ = &owned_->headers;
+    body_ = body_owned_ ? body_owned_.get() : &owned_->body;
+
+    // The views pointed into the other request's target
+    query_.clear();
+    query_parsed_ = false;
+}
+
+void Request::setBody(std::string body) {
+    body_owned_ = std::make_shared<const std::string>(std::move(body));
+    body_ = body_owned_.get();
+}
+
+// Header names are ASCII tokens: fold case inline, without the locale-aware std::tolower
+static inline char asciiLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+std::string_view Request::header(std::string_view key) const {
+    for (const auto& [name, value] : *headers_) {
+        if (name.size() != key.size()) continue;
+        bool same = true;
+        for (size_t i = 0; i < name.size() && same; i++) {
+            same = asciiLower(name[i]) == asciiLower(key[i]);
+        }
+        if (same) return value;
+    }
+    return std::string_view();
+}
+
+// Split ?key=val&... into views of target (no copies, no decoding)
+void Request::parseQuery() const {
+    query_parsed_ = true;
+    std::string_view target(*target_);
+    size_t qpos = target.find('?');
+    if (qpos == std::string_view::npos) return;
+
+    std::string_view q = target.substr(qpos + 1);
+    while (!q.empty()) {
+        size_t amp = q.find('&');
+        std::string_view pair = q.substr(0, amp);
         size_t eq = pair.find('=');
-        std::string k = (eq == std::string::npos) ? pair : pair.substr(0, eq);
-        std::string v = (eq == std::string::npos) ? "" : pair.substr(eq + 1);
-        out[k] = v;
-        if (amp == std::string::npos) break;
-        i = amp + 1;
+        if (!pair.empty()) {
+            query_.emplace_back(pair.substr(0, eq),
+                                eq == std::string_view::npos ? std::string_view() : pair.substr(eq + 1));
+        }
+        if (amp == std::string_view::npos) break;
+        q.remove_prefix(amp + 1);
+    }
+}
+
+std::string_view Request::query(std::string_view key) const {
+    if (!query_parsed_) parseQuery();
+    // The last occurrence wins, as before
+    for (auto it = query_.rbegin(); it != query_.rend(); ++it) {
+        if (it->first == key) return it->second;
     }
+    return std::string_view();
+}
+
+bool Request::hasQuery(std::string_view key) const {
+    if (!query_parsed_) parseQuery();
+    for (const auto& entry : query_) {
+        if (entry.first == key) return true;
+    }
+    return false;
+}
+
+// View of the parsed request with the matched path parameters (no copies)
+static void setParams(Request& req, const RouteParams& pathParams) {
+    for (const auto& param : pathParams) {
+        req.params.set(param.name, param.value);
+    }
+}
+
+// ===== CONDITIONAL REQUESTS =====
+
+// IMF-fixdate (RFC 9110 5.6.7): "Sun, 06 Nov 1994 08:49:37 GMT"
+static std::string httpDate(std::time_t time) {
+    struct tm tm;
+    gmtime_r(&time, &tm);
+    char buf[32];
+    size_t n = std::strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+    return std::string(buf, n);
+}
+
+// -1 when the date is not an IMF-fixdate
+static std::time_t parseHttpDate(std::string_view text) {
+    std::string copy(text);
+    struct tm tm;
+    std::memset(&tm, 0, sizeof(tm));
+    const char* end = strptime(copy.c_str(), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+    if (!end) return -1;
+    return timegm(&tm);
+}
+
+// "tag" or W/"tag"; a tag that is already quoted is kept as is
+static std::string formatETag(const std::string& tag, bool weak) {
+    if (!tag.empty() && (tag[0] == '"' || tag.compare(0, 3, "W/\"") == 0)) return tag;
+    std::string out;
+    out.reserve(tag.size() + 4);
+    out.append(weak ? "W/\"" : "\"");
+    out.append(tag);
+    out.push_back('"');
     return out;
 }
 
-// Convert HttpRequest to RestAPI::Request
-static Request convertRequest(const HttpRequest& httpReq,
-                               const std::map<std::string, std::string>& pathParams) {
-    Request req;
-    req.method = httpReq.method;
-    req.path = httpReq.path;
-    req.target = httpReq.target;
-    req.body = httpReq.body;
-    req.headers = httpReq.headers;
-    req.params = pathParams;
-    req.query = parseQuery(httpReq.target);
-    req.raw = httpReq.raw;
-    return req;
-}
-
-// Convert RestAPI::Response to HTTP response string
-static std::string convertResponse(const Response& response) {
-    std::ostringstream oss;
-
-    // Status line
-    oss << "HTTP/1.1 " << response.status << " ";
-    switch (response.status) {
-        case 200: oss << "OK"; break;
-        case 201: oss << "Created"; break;
-        case 204: oss << "No Content"; break;
-        case 400: oss << "Bad Request"; break;
-        case 401: oss << "Unauthorized"; break;
-        case 403: oss << "Forbidden"; break;
-        case 404: oss << "Not Found"; break;
-        case 500: oss << "Internal Server Error"; break;
-        default: oss << "Unknown"; break;
-    }
-    oss << "\r\n";
-
-    // Headers
-    for (const auto& [key, value] : response.headers) {
-        oss << key << ": " << value << "\r\n";
+// Weak comparison (RFC 9110 8.8.3.2): W/ prefixes are ignored
+static std::string_view opaqueTag(std::string_view tag) {
+    if (tag.size() >= 2 && tag[0] == 'W' && tag[1] == '/') tag.remove_prefix(2);
+    return tag;
+}
+
+// If-None-Match: "*" or a comma-separated list of entity tags
+static bool etagListMatches(std::string_view list, std::string_view etag) {
+    if (etag.empty()) return false;
+    etag = opaqueTag(etag);
+    while (!list.empty()) {
+        size_t comma = list.find(',');
+        std::string_view item = list.substr(0, comma);
+        while (!item.empty() && (item.front() == ' ' || item.front() == '\t')) item.remove_prefix(1);
+        while (!item.empty() && (item.back() == ' ' || item.back() == '\t')) item.remove_suffix(1);
+        if (item == "*" || opaqueTag(item) == etag) return true;
+        if (comma == std::string_view::npos) break;
+        list.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+// RFC 9110 13.2.2: If-None-Match decides when present, If-Modified-Since only without it
+static bool clientIsCurrent(std::string_view ifNoneMatch, std::string_view ifModifiedSince,
+                            std::string_view etag, std::string_view lastModified) {
+    if (!ifNoneMatch.empty()) return etagListMatches(ifNoneMatch, etag);
+    if (ifModifiedSince.empty() || lastModified.empty()) return false;
+    std::time_t since = parseHttpDate(ifModifiedSince);
+    std::time_t modified = parseHttpDate(lastModified);
+    return since != -1 && modified != -1 && modified <= since;
+}
+
+// 64-bit hash of a body for ETags, 8 bytes per step (not cryptographic)
+static uint64_t bodyHash(const std::string& data) {
+    const uint64_t K1 = 0x9E3779B97F4A7C15ull;
+    const uint64_t K2 = 0xBF58476D1CE4E5B9ull;
+    uint64_t h = data.size() * K1;
+    size_t i = 0;
+    for (; i + 8 <= data.size(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data.data() + i, 8);
+        h ^= word * K1;
+        h = ((h << 31) | (h >> 33)) * K2;
+    }
+    uint64_t tail = 0;
+    for (size_t shift = 0; i < data.size(); i++, shift += 8) {
+        tail |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << shift;
+    }
+    h ^= tail * K1;
+    // Final avalanche (splitmix64)
+    h ^= h >> 30; h *= K2;
+    h ^= h >> 27; h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return h;
+}
+
+// enable_etags(): strong ETag from the body of a 200 that has none
+static void addBodyETag(Response& res) {
+    if (res.status != 200 || res.headers.count("ETag")) return;
+    char tag[24];
+    std::snprintf(tag, sizeof(tag), "\"%016" PRIx64 "\"", bodyHash(res.body));
+    res.headers["ETag"] = tag;
+}
+
+// The client's copy is current: keep the validators and caching headers, drop the body
+static void makeNotModified(Response& res) {
+    res.status = 304;
+    res.body.clear();
+    res.headers.erase("Content-Type");
+}
+
+// Last step of GET routes, after the after hooks: body ETag when enabled,
+// then 304 when the request's validators match the response's
+static void conditionalGet(std::string_view ifNoneMatch, std::string_view ifModifiedSince,
+                           Response& res, bool hashBodies) {
+    if (res.status != 200) return;
+    if (hashBodies) addBodyETag(res);
+    if (ifNoneMatch.empty() && ifModifiedSince.empty()) return;
+
+    auto etag = res.headers.find("ETag");
+    auto modified = res.headers.find("Last-Modified");
+    if (clientIsCurrent(ifNoneMatch, ifModifiedSince,
+                        etag != res.headers.end() ? std::string_view(etag->second) : std::string_view(),
+                        modified != res.headers.end() ? std::string_view(modified->second) : std::string_view())) {
+        makeNotModified(res);
+    }
+}
+
+// Header value in a serialized response block ("" if missing), case-insensitive
+static std::string_view rawHeader(std::string_view head, std::string_view name) {
+    size_t pos = head.find("\r\n");
+    while (pos != std::string_view::npos) {
+        pos += 2;
+        size_t end = head.find("\r\n", pos);
+        std::string_view line = head.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+        if (line.size() > name.size() && line[name.size()] == ':') {
+            bool same = true;
+            for (size_t i = 0; i < name.size() && same; i++) {
+                same = asciiLower(line[i]) == asciiLower(name[i]);
+            }
+            if (same) {
+                std::string_view value = line.substr(name.size() + 1);
+                while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+                return value;
+            }
+        }
+        pos = end;
+    }
+    return std::string_view();
+}
+
+// Cached routes store the full 200; a conditional hit is answered from its validators
+static bool cachedNotModified(std::string_view raw, std::string_view ifNoneMatch,
+                              std::string_view ifModifiedSince, Response& out) {
+    if (raw.compare(0, 13, "HTTP/1.1 200 ") != 0) return false;
+    std::string_view head = raw.substr(0, raw.find("\r\n\r\n"));
+
+    std::string_view etag = rawHeader(head, "ETag");
+    std::string_view modified = rawHeader(head, "Last-Modified");
+    if (!clientIsCurrent(ifNoneMatch, ifModifiedSince, etag, modified)) return false;
+
+    out = Response();
+    out.status = 304;
+    for (const char* name : {"ETag", "Last-Modified", "Cache-Control", "Vary"}) {
+        std::string_view value = rawHeader(head, name);
+        if (!value.empty()) out.headers[name] = std::string(value);
+    }
+    return true;
+}
+
+bool Request::notModified(const Validator& validator) const {
+    if (*method_ != "GET") return false;
+    std::string_view ifNoneMatch = header("If-None-Match");
+    std::string_view ifModifiedSince = header("If-Modified-Since");
+    if (ifNoneMatch.empty() && ifModifiedSince.empty()) return false;
+
+    std::string etag = validator.etag.empty() ? std::string() : formatETag(validator.etag, validator.weak);
+    std::string modified = validator.last_modified > 0 ? httpDate(validator.last_modified) : std::string();
+    return clientIsCurrent(ifNoneMatch, ifModifiedSince, etag, modified);
+}
+
+CancellationToken Request::cancellation() const {
+    CancellationToken token;
+    token.state_ = cancellation_;
+    return token;
+}
+
+bool Request::cancelled() const {
+    return cancellation_ && cancellation_->cancelled();
+}
+
+// ===== CANCELLATION TOKEN =====
+
+bool CancellationToken::cancelled() const {
+    return state_ && state_->cancelled();
+}
+
+bool CancellationToken::deadlineExceeded() const {
+    return state_ && state_->reason() == CancelReason::Deadline;
+}
+
+bool CancellationToken::clientDisconnected() const {
+    return state_ && state_->reason() == CancelReason::Disconnected;
+}
+
+bool CancellationToken::hasDeadline() const {
+    return state_ && state_->has_deadline();
+}
+
+std::chrono::milliseconds CancellationToken::timeLeft() const {
+    return state_ ? state_->remaining() : std::chrono::milliseconds::max();
+}
+
+Response& Response::setETag(const std::string& tag, bool weak) {
+    headers["ETag"] = formatETag(tag, weak);
+    return *this;
+}
+
+Response& Response::setLastModified(std::time_t time) {
+    headers["Last-Modified"] = httpDate(time);
+    return *this;
+}
+
+Response& Response::setValidator(const Validator& validator) {
+    if (!validator.etag.empty()) setETag(validator.etag, validator.weak);
+    if (validator.last_modified > 0) setLastModified(validator.last_modified);
+    return *this;
+}
+
+Response Response::notModified(const Validator& validator) {
+    Response res;
+    res.status = 304;
+    res.setValidator(validator);
+    return res;
+}
+
+// ===== RESPONSE CACHE HELPERS =====
+
+// Cache key: method, path, the selected query parameters and Vary headers.
+// Raw query values cannot hold '&' and header values cannot hold '\n'.
+static std::string cacheKey(const HttpRequest& httpReq, const Request& req, const CacheOptions& options) {
+    std::string key = httpReq.method;
+    key += ' ';
+    key += httpReq.path;
+    key += '?';
+    for (const auto& name : options.query) {
+        if (req.hasQuery(name)) {
+            key += name;
+            key += '=';
+            key += req.query(name);
+        }
+        key += '&';
+    }
+    for (const auto& name : options.vary) {
+        key += '\n';
+        key += httpReq.getHeader(name);
+    }
+    return key;
+}
+
+// "product/:id" -> "product/42" using the request's path parameters
+static std::string expandCacheTag(const std::string& tag, const Request& req) {
+    std::string out;
+    size_t i = 0;
+    while (i < tag.size()) {
+        if (tag[i] != ':') {
+            out += tag[i++];
+            continue;
+        }
+        size_t end = i + 1;
+        while (end < tag.size() && (std::isalnum(static_cast<unsigned char>(tag[end])) || tag[end] == '_')) {
+            end++;
+        }
+        std::string_view name(tag.data() + i + 1, end - i - 1);
+        if (!name.empty() && req.params.has(name)) {
+            out += req.params.get(name);
+        } else {
+            out.append(tag, i, end - i);
+        }
+        i = end;
+    }
+    return out;
+}
+
+static bool isCacheable(const Response& response) {
+    if (response.status != 200) return false;
+    if (response.headers.count("Set-Cookie")) return false;
+
+    auto it = response.headers.find("Cache-Control");
+    if (it != response.headers.end() &&
+        (it->second.find("no-store") != std::string::npos || it->second.find("private") != std::string::npos)) {
+        return false;
+    }
+    return true;
+}
+
+// ===== ASYNC RESPONSE =====
+
+struct AsyncResponse::State {
+    ResponseCompletion completion;
+    std::string cors_headers;   // Serialized CORS block for this request ("" when off)
+
+    // Set only when the route has after hooks (the request is an owned copy)
+    std::shared_ptr<const MiddlewareChain> chain;
+    std::unique_ptr<Request> request;
+
+    // GET routes: conditional headers of the request, checked at send()
+    bool conditional = false;
+    bool hash_bodies = false;
+    std::string if_none_match;
+    std::string if_modified_since;
+};
+
+bool AsyncResponse::send(const Response& response) const {
+    if (!state_) {
+        return false;
+    }
+
+    if ((state_->request || state_->conditional) && !state_->completion.is_completed()) {
+        Response out = response;
+        if (state_->request) {
+            state_->chain->run_after(*state_->request, out);
+        }
+        if (state_->conditional) {
+            conditionalGet(state_->if_none_match, state_->if_modified_since, out, state_->hash_bodies);
+        }
+        return state_->completion.complete(convertResponse(out, state_->cors_headers));
+    }
+    return state_->completion.complete(convertResponse(response, state_->cors_headers));
+}
+
+bool AsyncResponse::is_sent() const {
+    return state_ && state_->completion.is_completed();
+}
+
+// ===== BODY STREAM =====
+
+bool BodyStream::read(std::string& chunk, size_t max_chunk) {
+    return reader_ && reader_->next(chunk, max_chunk);
+}
+
+void BodyStream::discard() {
+    if (reader_) {
+        reader_->discard();
+    }
+}
+
+size_t BodyStream::bytes_read() const {
+    return reader_ ? reader_->bytes_read() : 0;
+}
+
+int64_t BodyStream::content_length() const {
+    return reader_ ? reader_->content_length() : 0;
+}
+
+// Temp file holding a large upload; removed when the request is done
+class SpoolFile {
+public:
+    SpoolFile() = default;
+    ~SpoolFile() {
+        if (fd_ >= 0) ::close(fd_);
+        if (!path_.empty()) ::unlink(path_.c_str());
+    }
+
+    SpoolFile(const SpoolFile&) = delete;
+    SpoolFile& operator=(const SpoolFile&) = delete;
+
+    bool is_open() const { return fd_ >= 0; }
+    const std::string& path() const { return path_; }
+
+    void open(const std::string& dir) {
+        std::string tmpl = dir + "/restapi-upload-XXXXXX";
+        fd_ = ::mkstemp(&tmpl[0]);
+        if (fd_ < 0) {
+            throw std::runtime_error("Cannot create upload spool file in " + dir + ": " + strerror(errno));
+        }
+        path_ = tmpl;
+    }
+
+    void write(const std::string& data) {
+        size_t written = 0;
+        while (written < data.size()) {
+            ssize_t n = ::write(fd_, data.data() + written, data.size() - written);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("Cannot write upload spool file: ") + strerror(errno));
+            }
+            written += static_cast<size_t>(n);
+        }
+    }
+
+    // Done writing; the handler reads the file by path
+    void finish() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+private:
+    int fd_ = -1;
+    std::string path_;
+};
+
+// ===== WEBSOCKET =====
+
+bool WebSocket::send_text(const std::string& message) const {
+    return conn_ && conn_->send_text(message);
+}
+
+bool WebSocket::send_binary(const std::string& data) const {
+    return conn_ && conn_->send_binary(data);
+}
+
+void WebSocket::close(int code, const std::string& reason) const {
+    if (conn_) {
+        conn_->close(static_cast<uint16_t>(code), reason);
     }
+}
+
+bool WebSocket::is_open() const {
+    return conn_ && conn_->is_open();
+}
+
+size_t WebSocket::buffered_amount() const {
+    return conn_ ? conn_->buffered_amount() : 0;
+}
+
+uint64_t WebSocket::id() const {
+    return conn_ ? conn_->id() : 0;
+}
+
+// ===== EVENT STREAM =====
+
+EventStream EventStream::create(const EventStreamOptions& options) {
+    SseOptions sse;
+    sse.replay_capacity = options.replay_capacity;
+    sse.max_queued_bytes = options.max_queued_bytes;
+    sse.heartbeat = std::chrono::seconds(options.heartbeat_seconds);
+    sse.retry_ms = options.retry_ms;
+
+    EventStream stream;
+    stream.channel_ = std::make_shared<::SseChannel>(sse);
+    return stream;
+}
+
+uint64_t EventStream::publish(const std::string& data, const std::string& event) const {
+    return channel_ ? channel_->publish(data, event) : 0;
+}
+
+size_t EventStream::subscriber_count() const {
+    return channel_ ? channel_->subscriber_count() : 0;
+}
 
-    // Content-Length
-    oss << "Content-Length: " << response.body.size() << "\r\n";
+uint64_t EventStream::evicted_count() const {
+    return channel_ ? channel_->evicted_count() : 0;
+}
+
+void EventStream::close_all() const {
+    if (channel_) {
+        channel_->close_all();
+    }
+}
 
-    // End of headers
-    oss << "\r\n";
+// ===== MIDDLEWARE CHAINS =====
+
+void MiddlewareChain::use(MiddlewareHandler middleware) {
+    before_.push_back(std::move(middleware));
+}
+
+void MiddlewareChain::after(AfterResponseHandler hook) {
+    after_.push_back(std::move(hook));
+}
 
-    // Body
-    oss << response.body;
+void MiddlewareChain::append(const MiddlewareChain& other) {
+    before_.insert(before_.end(), other.before_.begin(), other.before_.end());
+    after_.insert(after_.end(), other.after_.begin(), other.after_.end());
+}
+
+void MiddlewareChain::clear() {
+    before_.clear();
+    after_.clear();
+}
+
+RouteHandle& RouteHandle::use(MiddlewareHandler middleware) {
+    if (chain_) chain_->use(std::move(middleware));
+    return *this;
+}
+
+RouteHandle& RouteHandle::after(AfterResponseHandler hook) {
+    if (chain_) chain_->after(std::move(hook));
+    return *this;
+}
 
-    return oss.str();
+RouteHandle& RouteHandle::pool(const std::string& name) {
+    if (settings_) settings_->pool = name;
+    return *this;
+}
+
+RouteHandle& RouteHandle::deadline(std::chrono::milliseconds timeout) {
+    if (settings_) settings_->deadline = timeout;
+    return *this;
+}
+
+// The middlewares and the hooks of a chain, each list traced as one span
+static bool runBefore(const MiddlewareChain& chain, Request& req, Response& res) {
+    if (!chain.has_before()) return true;
+    Trace::Scope span(SpanKind::Middleware);
+    return chain.run_before(req, res);
+}
+
+static void runAfter(const MiddlewareChain& chain, const Request& req, Response& res) {
+    if (!chain.has_after()) return;
+    Trace::Scope span(SpanKind::After);
+    chain.run_after(req, res);
+}
+
+// The answer for a request cancelled before its handler ran: nobody is
+// waiting for the handler's work any more
+static Response cancelledResponse(const Request& req) {
+    if (req.cancellation().clientDisconnected()) {
+        return Response::json(499, "{\"error\":\"Client Closed Request\"}");
+    }
+    return Response::json(504, "{\"error\":\"Deadline exceeded\"}");
+}
+
+// Middlewares, then the handler unless one rejected or the request was
+// cancelled meanwhile, then the after hooks
+template <typename Handler>
+static Response runChain(const MiddlewareChain& chain, Request& req, Handler&& handler) {
+    if (chain.empty()) {
+        if (req.cancelled()) return cancelledResponse(req);
+        Trace::Scope span(SpanKind::Handler);
+        return handler();
+    }
+    Response res;
+    if (runBefore(chain, req, res)) {
+        if (req.cancelled()) {
+            res = cancelledResponse(req);
+        } else {
+            Trace::Scope span(SpanKind::Handler);
+            res = handler();
+        }
+    }
+    runAfter(chain, req, res);
+    return res;
 }
 
 // ===== IMPLEMENTATION CLASS =====
@@ -94,14 +815,70 @@ public:
     int thread_pool_size;
     bool cors_enabled;
     std::string cors_origins;
+    int cors_max_age;
+    std::shared_ptr<const CorsPolicy> cors;  // Built at start() when enabled
     std::string log_file;
     int log_level;
     int shutdown_timeout;
+    size_t max_body_size;
+    bool etag_bodies = false;   // enable_etags(): hash bodies of GET responses without an ETag
 
     Router router;
     std::unique_ptr<Server> server;
 
-    std::vector<MiddlewareHandler> middlewares;
+    // Created at start() (before the workers fork) when a cached route exists
+    std::unique_ptr<ResponseCache> response_cache;
+    ResponseCacheOptions cache_options;
+    bool cache_needed = false;
+
+    // Handler calls in progress for single_flight routes (per worker process)
+    SingleFlight in_flight;
+
+    std::vector<ListenerConfig> listeners;  // Empty: TCP on port
+
+    // Middlewares added with use()/after(): for every route, and per path prefix
+    MiddlewareChain global_middlewares;
+    std::vector<std::pair<std::string, MiddlewareChain>> prefix_middlewares;
+
+    // One entry per registered route: its own middlewares (filled through the
+    // RouteHandle) and the chain its handler runs, compiled at start()
+    struct RouteChain {
+        std::string path;
+        std::shared_ptr<MiddlewareChain> own;
+        std::shared_ptr<MiddlewareChain> compiled;
+        int route_index = -1;                  // In router; -1 = not a router route (tables, WebSocket, SSE)
+        std::shared_ptr<RouteHandle::Settings> settings;   // Set through RouteHandle::pool(), deadline()
+    };
+    std::vector<RouteChain> route_chains;
+
+    // enable_cancellation(); route deadlines are resolved at start()
+    Worker::CancellationConfig cancellation;
+    int default_deadline_ms = 0;
+
+    // add_thread_pool() / assign_pool(): the pools each worker starts next to the default one
+    std::vector<Worker::ThreadPoolConfig> thread_pools;
+    std::vector<std::pair<std::string, std::string>> prefix_pools;
+
+    // rate_limit(): one policy per prefix ("" = every route); the limiter's
+    // shared memory is created at start(), before the workers fork
+    std::vector<RateLimitPolicy> rate_policies;
+    size_t rate_capacity = 65536;
+    std::shared_ptr<RateLimiter> rate_limiter;
+
+    // concurrency_limit(): one group per prefix; each worker adapts its own limits
+    std::vector<ConcurrencyLimitPolicy> concurrency_policies;
+    std::shared_ptr<ConcurrencyLimiter> concurrency_limiter;
+
+    // enable_tracing(): the ring buffers are created at start(), before the workers fork
+    bool tracing = false;
+    TraceConfig trace_config;
+
+    // Database pools reported by the metrics route
+    std::vector<std::pair<std::string, const ConnectionPool*>> metrics_pools;
+
+    // Admin port (admin.port == 0: disabled); checks run in the master process
+    AdminConfig admin;
+    HealthCheck health_checks;
 
     RestApiFrameworkImpl(int p, int w)
         : port(p)
@@ -109,52 +886,520 @@ public:
         , thread_pool_size(8)
         , cors_enabled(false)
         , cors_origins("*")
+        , cors_max_age(86400)
         , log_level(2)
         , shutdown_timeout(30)
+        , max_body_size(Worker::max_body_size())
     {}
 
-    void registerRoute(const std::string& method, const std::string& path, RouteHandler handler) {
+    // Prometheus text for the metrics route; only atomics and snapshots are read
+    std::string renderMetrics() const {
+        MetricsWriter out;
+        const GlobalStats* global = server ? server->global_stats() : nullptr;
+        RouteStats* routes = server ? server->route_stats() : nullptr;
+
+        int worker = -1;
+        if (global) {
+            Metrics::write_server(out, *global);
+            Metrics::write_thread_pools(out, *global);
+            if (concurrency_limiter) {
+                Metrics::write_concurrency_limits(out, *global, *concurrency_limiter);
+            }
+            pid_t self = getpid();
+            for (int i = 0; i < MAX_WORKERS; i++) {
+                if (global->workers[i].pid == self) {
+                    worker = i;
+                    break;
+                }
+            }
+        }
+        if (routes) {
+            Metrics::write_routes(out, *routes, router);
+        }
+        Metrics::write_pools(out, metrics_pools, worker);
+        if (rate_limiter) {
+            Metrics::write_rate_limits(out, *rate_limiter);
+        }
+        return out.str();
+    }
+
+    // The chain a route's handler runs; empty until compileChains()
+    // Routes with a handle are added to the router right after this call, so
+    // they get the next router index
+    std::shared_ptr<const MiddlewareChain> addRouteChain(const std::string& path, RouteHandle* route = nullptr) {
+        RouteChain entry;
+        entry.path = path;
+        entry.own = std::make_shared<MiddlewareChain>();
+        entry.compiled = std::make_shared<MiddlewareChain>();
+        if (route) {
+            entry.route_index = static_cast<int>(router.routeCount());
+            entry.settings = std::make_shared<RouteHandle::Settings>();
+            route->chain_ = entry.own;
+            route->settings_ = entry.settings;
+        }
+        route_chains.push_back(entry);
+        return entry.compiled;
+    }
+
+    MiddlewareChain& prefixGroup(std::string prefix) {
+        while (!prefix.empty() && prefix.back() == '/') prefix.pop_back();
+        for (auto& [existing, group] : prefix_middlewares) {
+            if (existing == prefix) return group;
+        }
+        prefix_middlewares.emplace_back(prefix, MiddlewareChain());
+        return prefix_middlewares.back().second;
+    }
+
+    // Resolve every route's middlewares once, before the workers fork:
+    // global ones, then matching prefixes (in the order added), then the route's own
+    void compileChains() {
+        for (auto& entry : route_chains) {
+            MiddlewareChain& chain = *entry.compiled;
+            chain.clear();
+            chain.append(global_middlewares);
+            for (const auto& [prefix, group] : prefix_middlewares) {
+                if (path_under_prefix(entry.path, prefix)) chain.append(group);
+            }
+            chain.append(*entry.own);
+        }
+    }
+
+    // Each router route's pool index and deadline, resolved once before the
+    // workers fork: the route's own pool(), else the longest assign_pool()
+    // prefix; the route's own deadline(), else the default one
+    void applyRouteSettings() {
+        for (const auto& entry : route_chains) {
+            if (entry.route_index < 0) continue;
+
+            std::chrono::milliseconds deadline = entry.settings->deadline;
+            if (deadline.count() <= 0) deadline = std::chrono::milliseconds(default_deadline_ms);
+            router.setRouteDeadline(static_cast<size_t>(entry.route_index),
+                                    static_cast<uint32_t>(std::max<int64_t>(0, deadline.count())));
+
+            std::string name = entry.settings->pool;
+            if (name.empty()) {
+                size_t best = 0;
+                for (const auto& [prefix, pool] : prefix_pools) {
+                    if (path_under_prefix(entry.path, prefix) && (name.empty() || prefix.size() > best)) {
+                        name = pool;
+                        best = prefix.size();
+                    }
+                }
+            }
+
+            int index = -1;
+            if (!name.empty() && name != "default") {
+                for (size_t i = 0; i < thread_pools.size(); i++) {
+                    if (thread_pools[i].name == name) index = static_cast<int>(i);
+                }
+                if (index < 0) {
+                    throw std::runtime_error("Unknown thread pool: " + name);
+                }
+            }
+            router.setRoutePool(static_cast<size_t>(entry.route_index), index);
+        }
+    }
+
+    // Serialized CORS headers for the request ("" when CORS is off)
+    std::string corsHeaders(const HttpRequest& httpReq) const {
+        return cors ? cors->headers_for(httpReq) : std::string();
+    }
+
+    RouteHandle registerRoute(const std::string& method, const std::string& path, RouteHandler handler) {
+        RouteHandle route;
+        auto chain = addRouteChain(path, &route);
+        bool conditional = method == "GET";
+
         // Wrap the RestAPI::RouteHandler into a function compatible with Router
-        auto wrappedHandler = [handler, this](const HttpRequest& httpReq,
-                                                const std::map<std::string, std::string>& params) -> std::string {
+        auto wrappedHandler = [handler, chain, conditional, this](const HttpRequest& httpReq,
+                                                                    const RouteParams& params) -> std::string {
             // Convert to RestAPI::Request
-            Request req = convertRequest(httpReq, params);
+            Request req(httpReq);
+            setParams(req, params);
+
+            // Middlewares, handler, after hooks
+            Response response = runChain(*chain, req, [&]() { return handler(req); });
+            if (conditional) {
+                conditionalGet(req.header("If-None-Match"), req.header("If-Modified-Since"), response, etag_bodies);
+            }
+
+            // Convert and return (CORS headers appended as serialized bytes)
+            return convertResponse(response, corsHeaders(httpReq));
+        };
+
+        // Register with the underlying Router
+        router.addRoute(method, path, wrappedHandler);
+        return route;
+    }
+
+    RouteHandle registerCachedRoute(const std::string& path, RouteHandler handler, const CacheOptions& options) {
+        cache_needed = true;
+        RouteHandle route;
+        auto chain = addRouteChain(path, &route);
 
-            // Execute middlewares
+        std::string vary;
+        for (const auto& name : options.vary) {
+            if (!vary.empty()) vary += ", ";
+            vary += name;
+        }
+
+        auto wrappedHandler = [handler, options, vary, chain, this](const HttpRequest& httpReq,
+                                                                     const RouteParams& params) -> std::string {
+            Request req(httpReq);
+            setParams(req, params);
+
+            // Middlewares run on hits too (authentication, rate limits, ...). A
+            // cancelled request neither runs the handler nor fills the cache
             Response res;
-            for (auto& middleware : middlewares) {
-                if (!middleware(req, res)) {
-                    // Middleware rejected the request
-                    return convertResponse(res);
+            bool admitted = runBefore(*chain, req, res);
+            if (admitted && req.cancelled()) {
+                res = cancelledResponse(req);
+                admitted = false;
+            }
+            if (!admitted) {
+                runAfter(*chain, req, res);
+                return convertResponse(res, corsHeaders(httpReq));
+            }
+
+            // The cache keeps full 200s; a client whose copy is current gets a 304 instead
+            std::string_view ifNoneMatch = req.header("If-None-Match");
+            std::string_view ifModifiedSince = req.header("If-Modified-Since");
+            bool conditional = !ifNoneMatch.empty() || !ifModifiedSince.empty();
+            auto answer = [&](std::string raw) -> std::string {
+                Response notModified;
+                if (conditional && cachedNotModified(raw, ifNoneMatch, ifModifiedSince, notModified)) {
+                    return convertResponse(notModified, corsHeaders(httpReq));
                 }
+                return raw;
+            };
+
+            std::string key = cacheKey(httpReq, req, options);
+            if (cors && cors->varies_by_origin()) {
+                // The stored bytes include the CORS block, which echoes the Origin
+                key += "\nOrigin:";
+                key += httpReq.getHeader("Origin");
+            }
+            std::string cached;
+            if (response_cache && response_cache->lookup(key, cached)) {
+                return answer(std::move(cached));
             }
 
-            // CORS handling
-            if (cors_enabled) {
-                res.setHeader("Access-Control-Allow-Origin", cors_origins);
-                res.setHeader("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-                res.setHeader("Access-Control-Allow-Headers", "Content-Type, Authorization");
+            // After hooks run on computed responses; what they set is cached with them
+            auto compute = [&]() -> std::string {
+                Response response;
+                {
+                    Trace::Scope span(SpanKind::Handler);
+                    response = handler(req);
+                }
+                runAfter(*chain, req, response);
+                if (!vary.empty()) {
+                    response.setHeader("Vary", vary);
+                }
+                if (etag_bodies) {
+                    addBodyETag(response);
+                }
+                std::string raw = convertResponse(response, corsHeaders(httpReq));
+
+                if (response_cache && isCacheable(response)) {
+                    std::vector<std::string> tags;
+                    tags.reserve(options.tags.size());
+                    for (const auto& tag : options.tags) {
+                        tags.push_back(expandCacheTag(tag, req));
+                    }
+                    response_cache->store(key, raw, std::chrono::seconds(options.ttl_seconds), tags);
+                }
+                return raw;
+            };
+
+            if (!options.single_flight) {
+                return answer(compute());
             }
 
-            // Execute the handler
-            Response response = handler(req);
+            // Identical requests arriving while this one runs wait for its response.
+            // The leader looks again first: a call that just finished may have stored it.
+            return answer(in_flight.run(key, [&]() -> std::string {
+                std::string stored;
+                if (response_cache && response_cache->lookup(key, stored)) {
+                    return stored;
+                }
+                return compute();
+            }));
+        };
 
-            // Merge CORS headers if enabled
-            if (cors_enabled) {
-                response.setHeader("Access-Control-Allow-Origin", cors_origins);
-                response.setHeader("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-                response.setHeader("Access-Control-Allow-Headers", "Content-Type, Authorization");
+        router.addRoute("GET", path, wrappedHandler);
+        return route;
+    }
+
+    RouteHandle registerAsyncRoute(const std::string& method, const std::string& path, AsyncRouteHandler handler) {
+        RouteHandle route;
+        auto chain = addRouteChain(path, &route);
+        bool conditional = method == "GET";
+
+        auto wrappedHandler = [handler, chain, conditional, this](const HttpRequest& httpReq,
+                                                                    const RouteParams& params,
+                                                                    ResponseCompletion completion) {
+            Request req(httpReq);
+            setParams(req, params);
+
+            // Execute middlewares (a rejection or a cancelled request completes right away)
+            Response res;
+            bool admitted = runBefore(*chain, req, res);
+            if (admitted && req.cancelled()) {
+                res = cancelledResponse(req);
+                admitted = false;
+            }
+            if (!admitted) {
+                runAfter(*chain, req, res);
+                completion.complete(convertResponse(res, corsHeaders(httpReq)));
+                return;
+            }
+
+            AsyncResponse async;
+            async.state_ = std::make_shared<AsyncResponse::State>();
+            async.state_->completion = std::move(completion);
+            async.state_->cors_headers = corsHeaders(httpReq);
+            if (chain->has_after()) {
+                // The hooks run at send(), after this request view is gone
+                async.state_->chain = chain;
+                async.state_->request = std::make_unique<Request>(req);
+            }
+            if (conditional) {
+                async.state_->conditional = true;
+                async.state_->hash_bodies = etag_bodies;
+                async.state_->if_none_match = std::string(req.header("If-None-Match"));
+                async.state_->if_modified_since = std::string(req.header("If-Modified-Since"));
             }
 
-            // Convert and return
-            return convertResponse(response);
+            // The handler may complete now or keep the handle and complete later
+            Trace::Scope span(SpanKind::Handler);
+            handler(req, async);
         };
 
-        // Register with the underlying Router
-        router.addRoute(method, path, wrappedHandler);
+        router.addAsyncRoute(method, path, wrappedHandler);
+        return route;
+    }
+
+    RouteHandle registerStreamingRoute(const std::string& method, const std::string& path, StreamingRouteHandler handler) {
+        RouteHandle route;
+        auto chain = addRouteChain(path, &route);
+
+        auto wrappedHandler = [handler, chain, this](const HttpRequest& httpReq,
+                                                       const RouteParams& params,
+                                                       BodyReader& body, ResponseCompletion completion) {
+            Request req(httpReq);
+            setParams(req, params);
+
+            // Middlewares run before any of the body is read (e.g. reject unauthenticated uploads)
+            BodyStream stream;
+            stream.reader_ = &body;
+            Response response = runChain(*chain, req, [&]() { return handler(req, stream); });
+
+            completion.complete(convertResponse(response, corsHeaders(httpReq)));
+        };
+
+        router.addStreamingRoute(method, path, wrappedHandler);
+        return route;
+    }
+
+    RouteHandle registerUploadRoute(const std::string& method, const std::string& path, RouteHandler handler,
+                              const UploadOptions& options) {
+        RouteHandle route;
+        auto chain = addRouteChain(path, &route);
+
+        auto wrappedHandler = [handler, options, chain, this](const HttpRequest& httpReq,
+                                                                const RouteParams& params,
+                                                                BodyReader& body, ResponseCompletion completion) {
+            Request req(httpReq);
+            setParams(req, params);
+
+            // Every response of the route (rejections and 413 included) goes through the hooks
+            auto finish = [&](Response response) {
+                runAfter(*chain, req, response);
+                completion.complete(convertResponse(response, corsHeaders(httpReq)));
+            };
+
+            Response res;
+            if (!runBefore(*chain, req, res)) {
+                finish(std::move(res));
+                return;
+            }
+
+            Response tooLarge = Response::json(413, "{\"error\":\"Payload Too Large\"}");
+            if (body.content_length() > 0 && static_cast<size_t>(body.content_length()) > options.max_size) {
+                finish(std::move(tooLarge));
+                return;
+            }
+
+            // Small bodies stay in memory; past the threshold everything goes to disk
+            SpoolFile spool;
+            std::string data;
+            std::string chunk;
+            while (body.next(chunk)) {
+                if (body.bytes_read() > options.max_size) {
+                    finish(std::move(tooLarge));
+                    return;
+                }
+                if (!spool.is_open() && data.size() + chunk.size() > options.spool_threshold) {
+                    spool.open(options.spool_dir);
+                    spool.write(data);
+                    data.clear();
+                    data.shrink_to_fit();
+                }
+                if (spool.is_open()) {
+                    spool.write(chunk);
+                } else {
+                    data += chunk;
+                }
+            }
+
+            if (spool.is_open()) {
+                spool.finish();
+                req.setBodyFile(spool.path());
+            } else {
+                req.setBody(std::move(data));
+            }
+
+            Response response;
+            {
+                Trace::Scope span(SpanKind::Handler);
+                response = handler(req);
+            }
+            finish(std::move(response));
+        };
+
+        router.addStreamingRoute(method, path, wrappedHandler);
+        return route;
+    }
+
+    static WebSocket wrapSocket(const WebSocketPtr& conn) {
+        WebSocket ws;
+        ws.conn_ = conn;
+        return ws;
     }
+
+    void registerWebSocket(const std::string& path, WebSocketHandlers handlers, const WebSocketOptions& options) {
+        auto route = std::make_shared<::WebSocketRoute>();
+
+        route->options.max_message_size = options.max_message_size;
+        route->options.high_water_mark = options.high_water_mark;
+        route->options.low_water_mark = options.low_water_mark;
+        route->options.max_buffered = options.max_buffered;
+        route->options.ping_interval = std::chrono::seconds(options.ping_interval_seconds);
+
+        auto chain = addRouteChain(path);
+        auto on_open = handlers.on_open;
+        route->handlers.on_open = [on_open, chain](const WebSocketPtr& conn, const HttpRequest& httpReq,
+                                                   const RouteParams& params) {
+            Request req(httpReq);
+            setParams(req, params);
+
+            // Middlewares (auth, ...) see the upgrade request like any other
+            Response res;
+            if (!runBefore(*chain, req, res)) {
+                conn->close(WebSocketClose::POLICY, "Rejected");
+                return;
+            }
+
+            if (on_open) on_open(wrapSocket(conn), req);
+        };
+
+        if (handlers.on_message) {
+            auto on_message = handlers.on_message;
+            route->handlers.on_message = [on_message](const WebSocketPtr& conn, const std::string& message,
+                                                      bool binary) {
+                on_message(wrapSocket(conn), message, binary);
+            };
+        }
+
+        if (handlers.on_close) {
+            auto on_close = handlers.on_close;
+            route->handlers.on_close = [on_close](const WebSocketPtr& conn, uint16_t code) {
+                on_close(wrapSocket(conn), code);
+            };
+        }
+
+        if (handlers.on_drain) {
+            auto on_drain = handlers.on_drain;
+            route->handlers.on_drain = [on_drain](const WebSocketPtr& conn) {
+                on_drain(wrapSocket(conn));
+            };
+        }
+
+        router.addWebSocketRoute(path, route);
+    }
+
+    void registerSse(const std::string& path, EventStreamSelector selector) {
+        auto chain = addRouteChain(path);
+        auto wrappedHandler = [selector, chain, this](const HttpRequest& httpReq,
+                                                      const RouteParams& params) {
+            SseSubscription subscription;
+            Request req(httpReq);
+            setParams(req, params);
+
+            Response res;
+            if (!runBefore(*chain, req, res)) {
+                runAfter(*chain, req, res);
+                subscription.rejection = convertResponse(res, corsHeaders(httpReq));
+                return subscription;
+            }
+
+            EventStream stream = selector(req);
+            subscription.channel = stream.channel_;
+
+            subscription.extra_headers = corsHeaders(httpReq);
+            return subscription;
+        };
+
+        router.addSseRoute(path, wrappedHandler);
+    }
+
+    void mountTable(std::shared_ptr<const RouteTableBase> table);
+};
+
+// ===== COMPILE-TIME ROUTE TABLES =====
+
+// Router-facing adapter: match in the table, then the same request pipeline as
+// registerRoute (middleware chain, CORS), with a direct call to the handler
+class MountedRouteTable : public StaticRouteTable {
+public:
+    MountedRouteTable(std::shared_ptr<const RouteTableBase> table, RestApiFrameworkImpl* impl)
+        : table_(std::move(table)), impl_(impl) {
+        // One chain per table route, resolved from its pattern like any other route
+        chains_.reserve(table_->size());
+        for (size_t i = 0; i < table_->size(); i++) {
+            chains_.push_back(impl->addRouteChain(std::string(table_->pattern(static_cast<int>(i)))));
+        }
+    }
+
+    bool dispatch(const HttpRequest& httpReq, ResponseCompletion& completion) const override {
+        RouteMatch match;
+        int index = table_->match(httpReq.method, httpReq.path, match);
+        if (index < 0) return false;
+
+        Request req(httpReq);
+        for (size_t i = 0; i < match.size(); i++) {
+            req.params.set(match.name(i), match.value(i));
+        }
+
+        Response response = runChain(*chains_[index], req, [&]() { return table_->call(index, req); });
+        if (httpReq.method == "GET") {
+            conditionalGet(req.header("If-None-Match"), req.header("If-Modified-Since"), response,
+                           impl_->etag_bodies);
+        }
+        completion.complete(convertResponse(response, impl_->corsHeaders(httpReq)));
+        return true;
+    }
+
+private:
+    std::shared_ptr<const RouteTableBase> table_;
+    const RestApiFrameworkImpl* impl_;
+    std::vector<std::shared_ptr<const MiddlewareChain>> chains_;
 };
 
+void RestApiFrameworkImpl::mountTable(std::shared_ptr<const RouteTableBase> table) {
+    router.addStaticTable(std::make_shared<MountedRouteTable>(std::move(table), this));
+}
+
 // ===== FRAMEWORK IMPLEMENTATION =====
 
 RestApiFramework::RestApiFramework(int port, int workers)
@@ -168,24 +1413,99 @@ RestApiFramework::~RestApiFramework() {
     }
 }
 
-void RestApiFramework::get(const std::string& path, RouteHandler handler) {
-    pImpl->registerRoute("GET", path, handler);
+RouteHandle RestApiFramework::get(const std::string& path, RouteHandler handler) {
+    return pImpl->registerRoute("GET", path, handler);
+}
+
+RouteHandle RestApiFramework::post(const std::string& path, RouteHandler handler) {
+    return pImpl->registerRoute("POST", path, handler);
+}
+
+RouteHandle RestApiFramework::put(const std::string& path, RouteHandler handler) {
+    return pImpl->registerRoute("PUT", path, handler);
+}
+
+RouteHandle RestApiFramework::del(const std::string& path, RouteHandler handler) {
+    return pImpl->registerRoute("DELETE", path, handler);
+}
+
+RouteHandle RestApiFramework::get_async(const std::string& path, AsyncRouteHandler handler) {
+    return pImpl->registerAsyncRoute("GET", path, handler);
+}
+
+RouteHandle RestApiFramework::post_async(const std::string& path, AsyncRouteHandler handler) {
+    return pImpl->registerAsyncRoute("POST", path, handler);
+}
+
+RouteHandle RestApiFramework::put_async(const std::string& path, AsyncRouteHandler handler) {
+    return pImpl->registerAsyncRoute("PUT", path, handler);
+}
+
+RouteHandle RestApiFramework::del_async(const std::string& path, AsyncRouteHandler handler) {
+    return pImpl->registerAsyncRoute("DELETE", path, handler);
+}
+
+RouteHandle RestApiFramework::post_stream(const std::string& path, StreamingRouteHandler handler) {
+    return pImpl->registerStreamingRoute("POST", path, handler);
+}
+
+RouteHandle RestApiFramework::put_stream(const std::string& path, StreamingRouteHandler handler) {
+    return pImpl->registerStreamingRoute("PUT", path, handler);
+}
+
+RouteHandle RestApiFramework::post_upload(const std::string& path, RouteHandler handler, UploadOptions options) {
+    return pImpl->registerUploadRoute("POST", path, handler, options);
 }
 
-void RestApiFramework::post(const std::string& path, RouteHandler handler) {
-    pImpl->registerRoute("POST", path, handler);
+RouteHandle RestApiFramework::put_upload(const std::string& path, RouteHandler handler, UploadOptions options) {
+    return pImpl->registerUploadRoute("PUT", path, handler, options);
 }
 
-void RestApiFramework::put(const std::string& path, RouteHandler handler) {
-    pImpl->registerRoute("PUT", path, handler);
+void RestApiFramework::websocket(const std::string& path, WebSocketHandlers handlers,
+                                 WebSocketOptions options) {
+    pImpl->registerWebSocket(path, std::move(handlers), options);
 }
 
-void RestApiFramework::del(const std::string& path, RouteHandler handler) {
-    pImpl->registerRoute("DELETE", path, handler);
+void RestApiFramework::sse(const std::string& path, EventStream stream) {
+    pImpl->registerSse(path, [stream](const Request&) { return stream; });
+}
+
+void RestApiFramework::sse(const std::string& path, EventStreamSelector selector) {
+    pImpl->registerSse(path, std::move(selector));
+}
+
+RouteHandle RestApiFramework::get_cached(const std::string& path, RouteHandler handler, CacheOptions options) {
+    return pImpl->registerCachedRoute(path, handler, options);
+}
+
+size_t RestApiFramework::invalidate_cache(const std::string& tag) {
+    return pImpl->response_cache ? pImpl->response_cache->invalidate_tag(tag) : 0;
+}
+
+void RestApiFramework::clear_cache() {
+    if (pImpl->response_cache) {
+        pImpl->response_cache->clear();
+    }
+}
+
+void RestApiFramework::mount_table(std::shared_ptr<const RouteTableBase> table) {
+    pImpl->mountTable(std::move(table));
 }
 
 void RestApiFramework::use(MiddlewareHandler middleware) {
-    pImpl->middlewares.push_back(middleware);
+    pImpl->global_middlewares.use(std::move(middleware));
+}
+
+void RestApiFramework::use(const std::string& prefix, MiddlewareHandler middleware) {
+    pImpl->prefixGroup(prefix).use(std::move(middleware));
+}
+
+void RestApiFramework::after(AfterResponseHandler hook) {
+    pImpl->global_middlewares.after(std::move(hook));
+}
+
+void RestApiFramework::after(const std::string& prefix, AfterResponseHandler hook) {
+    pImpl->prefixGroup(prefix).after(std::move(hook));
 }
 
 void RestApiFramework::serve_static(const std::string& route, const std::string& directory) {
@@ -201,15 +1521,100 @@ void RestApiFramework::start() {
     std::cout << "╚════════════════════════════════════════════════╝\n\n";
 
     std::cout << "[FRAMEWORK] Starting server...\n";
-    std::cout << "  Port:    " << pImpl->port << "\n";
+    if (pImpl->listeners.empty()) {
+        std::cout << "  Port:    " << pImpl->port << "\n";
+    } else {
+        for (const auto& listener : pImpl->listeners) {
+            std::cout << "  Listen:  " << listener.describe() << "\n";
+        }
+    }
     std::cout << "  Workers: " << pImpl->workers << "\n";
     std::cout << "  CORS:    " << (pImpl->cors_enabled ? "enabled" : "disabled") << "\n\n";
 
+    // CORS headers are serialized once; preflights are answered by the worker
+    if (pImpl->cors_enabled) {
+        CorsConfig config;
+        config.allow_origins = pImpl->cors_origins;
+        config.max_age = pImpl->cors_max_age;
+        pImpl->cors = std::make_shared<const CorsPolicy>(config);
+    } else {
+        pImpl->cors.reset();
+    }
+    Worker::set_cors_policy(pImpl->cors);
+
+    // Middleware chains are fixed from here on: one flat list per route
+    pImpl->compileChains();
+
+    // Shared memory for cached routes must exist before the workers fork
+    if (pImpl->cache_needed && !pImpl->response_cache) {
+        pImpl->response_cache = std::make_unique<ResponseCache>(pImpl->cache_options);
+    }
+
+    // One trace ring per thread that records spans: the default and named pool
+    // threads of every worker plus event loop, TLS and handler-owned threads
+    if (pImpl->tracing) {
+        int threads_per_worker = std::max(1, pImpl->thread_pool_size) + 8;
+        for (const auto& pool : pImpl->thread_pools) {
+            threads_per_worker += pool.threads;
+        }
+        pImpl->trace_config.rings = static_cast<size_t>(std::max(1, pImpl->workers)) *
+                                    static_cast<size_t>(threads_per_worker);
+        Trace::configure(pImpl->trace_config);
+    }
+
+    // Thread pools are started by each worker; routes learn their pool index now,
+    // before the router is copied into the server
+    Worker::set_thread_pool_size(pImpl->thread_pool_size);
+    Worker::set_thread_pools(pImpl->thread_pools);
+    Worker::set_cancellation(pImpl->cancellation);
+    pImpl->applyRouteSettings();
+
+    // Rate limit buckets are shared memory too; policies are resolved per route once
+    if (!pImpl->rate_policies.empty()) {
+        if (!pImpl->rate_limiter) {
+            pImpl->rate_limiter = std::make_shared<RateLimiter>(pImpl->rate_policies, pImpl->rate_capacity);
+        }
+        pImpl->rate_limiter->resolve(pImpl->router);
+
+        // A Unix socket has no client address: policies keyed by address would
+        // put every client of that listener in one bucket
+        bool unix_listener = false;
+        for (const auto& listener : pImpl->listeners) {
+            unix_listener = unix_listener || listener.type == ListenerConfig::Type::UNIX;
+        }
+        for (const auto& policy : pImpl->rate_policies) {
+            if (unix_listener && policy.key_header.empty() && !policy.trust_forwarded_for) {
+                std::cerr << "[WARNING] Rate limit on \"" << policy.prefix << "\" is per address, but clients "
+                          << "on a Unix socket have none and share one bucket; set key_header or "
+                          << "trust_forwarded_for\n";
+            }
+        }
+    }
+    Worker::set_rate_limiter(pImpl->rate_limiter);
+
+    if (!pImpl->concurrency_policies.empty()) {
+        if (!pImpl->concurrency_limiter) {
+            pImpl->concurrency_limiter = std::make_shared<ConcurrencyLimiter>(pImpl->concurrency_policies);
+        }
+        pImpl->concurrency_limiter->resolve(pImpl->router);
+    }
+    Worker::set_concurrency_limiter(pImpl->concurrency_limiter);
+
     // Create server instance
     pImpl->server = std::make_unique<Server>(pImpl->port, pImpl->workers);
     pImpl->server->setRouter(pImpl->router);
+    pImpl->server->set_shutdown_timeout(std::chrono::seconds(pImpl->shutdown_timeout));
+    if (pImpl->admin.port > 0) {
+        pImpl->server->set_admin(pImpl->admin, &pImpl->health_checks);
+    }
+    Worker::set_max_body_size(pImpl->max_body_size);
+    for (const auto& listener : pImpl->listeners) {
+        pImpl->server->add_listener(listener);
+    }
 
-    std::cout << "Server listening on http://localhost:" << pImpl->port << "\n\n";
+    if (pImpl->listeners.empty()) {
+        std::cout << "Server listening on http://localhost:" << pImpl->port << "\n\n";
+    }
 
     // Start server (blocking)
     pImpl->server->start();
@@ -227,14 +1632,65 @@ void RestApiFramework::shutdown() {
     }
 }
 
+void RestApiFramework::listen_tcp(int port, const std::string& host) {
+    pImpl->listeners.push_back(ListenerConfig::tcp(port, host));
+}
+
+void RestApiFramework::listen_unix(const std::string& path, unsigned int mode) {
+    pImpl->listeners.push_back(ListenerConfig::unix_socket(path, static_cast<mode_t>(mode)));
+}
+
+void RestApiFramework::listen_tls(int port, const std::string& cert_file, const std::string& key_file,
+                                  const std::string& host) {
+    pImpl->listeners.push_back(ListenerConfig::tls_tcp(port, cert_file, key_file, host));
+}
+
 void RestApiFramework::set_workers(int count) {
     pImpl->workers = count;
 }
 
+void RestApiFramework::set_response_cache_size(size_t max_bytes, size_t max_entries) {
+    pImpl->cache_options.max_bytes = max_bytes;
+    pImpl->cache_options.max_entries = max_entries;
+}
+
 void RestApiFramework::set_thread_pool_size(int size) {
     pImpl->thread_pool_size = size;
 }
 
+void RestApiFramework::add_thread_pool(const std::string& name, int threads, size_t queue_limit) {
+    if (name.empty() || name == "default") {
+        throw std::runtime_error("add_thread_pool: the name must not be empty or \"default\"");
+    }
+    Worker::ThreadPoolConfig config;
+    config.name = name;
+    config.threads = std::max(1, threads);
+    config.queue_limit = std::max<size_t>(1, queue_limit);
+
+    for (auto& existing : pImpl->thread_pools) {
+        if (existing.name == name) {
+            existing = config;
+            return;
+        }
+    }
+    if (pImpl->thread_pools.size() + 1 >= MAX_THREAD_POOLS) {
+        throw std::runtime_error("add_thread_pool: too many pools");
+    }
+    pImpl->thread_pools.push_back(config);
+}
+
+void RestApiFramework::assign_pool(const std::string& prefix, const std::string& pool) {
+    std::string normalized = prefix;
+    while (!normalized.empty() && normalized.back() == '/') normalized.pop_back();
+    for (auto& [existing, name] : pImpl->prefix_pools) {
+        if (existing == normalized) {
+            name = pool;
+            return;
+        }
+    }
+    pImpl->prefix_pools.emplace_back(normalized, pool);
+}
+
 void RestApiFramework::enable_cors(bool enable) {
     pImpl->cors_enabled = enable;
 }
@@ -243,6 +1699,10 @@ void RestApiFramework::set_cors_origins(const std::string& origins) {
     pImpl->cors_origins = origins;
 }
 
+void RestApiFramework::set_cors_max_age(int seconds) {
+    pImpl->cors_max_age = seconds;
+}
+
 void RestApiFramework::enable_logging(const std::string& log_file) {
     pImpl->log_file = log_file;
 }
@@ -255,6 +1715,165 @@ void RestApiFramework::set_shutdown_timeout(int seconds) {
     pImpl->shutdown_timeout = seconds;
 }
 
+void RestApiFramework::enable_etags(bool enable) {
+    pImpl->etag_bodies = enable;
+}
+
+void RestApiFramework::rate_limit(RateLimitOptions options) {
+    rate_limit(std::string(), std::move(options));
+}
+
+void RestApiFramework::rate_limit(const std::string& prefix, RateLimitOptions options) {
+    RateLimitPolicy policy;
+    policy.prefix = prefix;
+    while (!policy.prefix.empty() && policy.prefix.back() == '/') {
+        policy.prefix.pop_back();
+    }
+    policy.limit = static_cast<uint32_t>(std::max(1, options.requests));
+    policy.window_seconds = static_cast<uint32_t>(std::max(1, options.window_seconds));
+    policy.key_header = std::move(options.key_header);
+    policy.trust_forwarded_for = options.trust_forwarded_for;
+
+    for (auto& existing : pImpl->rate_policies) {
+        if (existing.prefix == policy.prefix) {
+            existing = std::move(policy);
+            return;
+        }
+    }
+    if (pImpl->rate_policies.size() >= RateLimiter::MAX_POLICIES) {
+        throw std::runtime_error("rate_limit: too many prefixes");
+    }
+    pImpl->rate_policies.push_back(std::move(policy));
+}
+
+void RestApiFramework::set_rate_limit_capacity(size_t buckets) {
+    pImpl->rate_capacity = std::max<size_t>(buckets, RateLimiter::MAX_PROBE);
+}
+
+void RestApiFramework::concurrency_limit(ConcurrencyLimitOptions options) {
+    concurrency_limit(std::string(), options);
+}
+
+void RestApiFramework::concurrency_limit(const std::string& prefix, ConcurrencyLimitOptions options) {
+    ConcurrencyLimitPolicy policy;
+    policy.prefix = prefix;
+    while (!policy.prefix.empty() && policy.prefix.back() == '/') {
+        policy.prefix.pop_back();
+    }
+    policy.initial_limit = options.initial_limit;
+    policy.min_limit = options.min_limit;
+    policy.max_limit = options.max_limit;
+    policy.tolerance = options.tolerance;
+    policy.max_queue = options.max_queue;
+    policy.queue_timeout = std::chrono::milliseconds(std::max(0, options.queue_timeout_ms));
+
+    for (auto& existing : pImpl->concurrency_policies) {
+        if (existing.prefix == policy.prefix) {
+            existing = std::move(policy);
+            return;
+        }
+    }
+    if (pImpl->concurrency_policies.size() >= ConcurrencyLimiter::MAX_GROUPS) {
+        throw std::runtime_error("concurrency_limit: too many prefixes");
+    }
+    pImpl->concurrency_policies.push_back(std::move(policy));
+}
+
+void RestApiFramework::enable_cancellation(CancellationOptions options) {
+    pImpl->cancellation.watch_disconnects = options.watch_disconnects;
+    pImpl->cancellation.deadline_header = std::move(options.deadline_header);
+    pImpl->default_deadline_ms = std::max(0, options.default_deadline_ms);
+}
+
+void RestApiFramework::set_max_body_size(size_t bytes) {
+    pImpl->max_body_size = bytes;
+}
+
+void RestApiFramework::enable_metrics(const std::string& path) {
+    RestApiFrameworkImpl* impl = pImpl.get();
+    pImpl->registerRoute("GET", path, [impl](const Request&) {
+        Response res(200, impl->renderMetrics());
+        res.setHeader("Content-Type", MetricsWriter::CONTENT_TYPE);
+        res.setHeader("Cache-Control", "no-store");
+        return res;
+    });
+}
+
+void RestApiFramework::enable_tracing(TracingOptions options) {
+    pImpl->tracing = true;
+    pImpl->trace_config.sample_rate = options.sample_rate;
+    pImpl->trace_config.header = options.header;
+    pImpl->trace_config.dump_file = options.dump_file;
+    pImpl->trace_config.events_per_ring = options.buffer_events;
+
+    if (!options.path.empty()) {
+        pImpl->registerRoute("GET", options.path, [](const Request& req) {
+            Response res(200, Trace::chrome_json(req.query("request_id")));
+            res.setHeader("Content-Type", "application/json");
+            res.setHeader("Cache-Control", "no-store");
+            return res;
+        });
+    }
+}
+
+void RestApiFramework::add_metrics_pool(const std::string& name, const ConnectionPool& pool) {
+    pImpl->metrics_pools.emplace_back(name, &pool);
+}
+
+void RestApiFramework::enable_admin(int port, AdminOptions options) {
+    pImpl->admin.port = port;
+    pImpl->admin.host = options.host;
+    pImpl->admin.health_path = options.health_path;
+    pImpl->admin.ready_path = options.ready_path;
+    pImpl->admin.metrics_path = options.metrics_path;
+    pImpl->admin.check_interval = std::chrono::seconds(std::max(1, options.check_interval_seconds));
+}
+
+void RestApiFramework::add_health_check(const std::string& name, HealthCheckHandler check) {
+    pImpl->health_checks.register_check(name, [name, check]() {
+        HealthCheckResult result;
+        result.component = name;
+        result.status = check() ? HealthStatus::HEALTHY : HealthStatus::UNHEALTHY;
+        result.message = result.status == HealthStatus::HEALTHY ? "OK" : "Check failed";
+        return result;
+    });
+}
+
+std::vector<RouteMetrics> RestApiFramework::route_metrics() const {
+    std::vector<RouteMetrics> out;
+    RouteStats* stats = pImpl->server ? pImpl->server->route_stats() : nullptr;
+    if (!stats) {
+        return out;
+    }
+
+    // pImpl->router holds the same routes, in the same order, as the server's copy
+    for (size_t i = 0; i <= stats->route_count(); i++) {
+        RouteStatsSnapshot snapshot = stats->snapshot(i);
+        RouteMetrics m;
+        if (i < stats->route_count()) {
+            const Route& route = pImpl->router.routeAt(i);
+            m.method = route.method;
+            m.path = route.pattern;
+        } else {
+            m.method = "*";
+            m.path = "*";
+        }
+        m.requests = snapshot.requests;
+        for (int c = 0; c < 5; c++) {
+            m.status[c] = snapshot.status[c];
+        }
+        m.bytes_in = snapshot.bytes_in;
+        m.bytes_out = snapshot.bytes_out;
+        m.mean_us = snapshot.mean_us();
+        m.p50_us = snapshot.percentile_us(0.50);
+        m.p90_us = snapshot.percentile_us(0.90);
+        m.p99_us = snapshot.percentile_us(0.99);
+        m.max_us = snapshot.max_us();
+        out.push_back(m);
+    }
+    return out;
+}
+
 int RestApiFramework::get_port() const {
     return pImpl->port;
 }
@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+struct GlobalStats;      // core/master.hpp
+class RouteStats;        // http/routestats.hpp
+class Router;            // http/router.hpp
+class HealthCheck;       // core/healthcheck.hpp
+
+// Portul de administrare: probe de sănătate și metrici servite de un thread
+// din procesul Master, nu de worker-i. Răspunde doar din shared memory
+// (GlobalStats, RouteStats) și din ultimele rezultate HealthCheck, deci
+// orchestratorul primește răspuns și când worker-ii sunt saturați.
+struct AdminConfig {
+    int port = 0;                              // 0 = dezactivat
+    std::string host = "127.0.0.1";            // Doar local, implicit
+    std::string health_path = "/healthz";      // Liveness: Master-ul rulează
+    std::string ready_path = "/readyz";        // Readiness: worker-i vii, fără drain, check-uri OK
+    std::string metrics_path = "/metrics";     // Prometheus
+    std::chrono::seconds check_interval{5};    // Cât de des rulează check-urile HealthCheck
+};
+
+class AdminServer {
+public:
+    AdminServer(const AdminConfig& config, const GlobalStats* stats, const RouteStats* routes,
+                const Router* router, HealthCheck* health);
+    ~AdminServer();
+
+    AdminServer(const AdminServer&) = delete;
+    AdminServer& operator=(const AdminServer&) = delete;
+
+    // Deschide socket-ul (înainte de fork, ca erorile să oprească pornirea);
+    // aruncă std::runtime_error dacă portul nu poate fi folosit
+    void open();
+
+    // Pornește thread-ul (și check-urile periodice) după fork-ul worker-ilor
+    void start();
+    void stop();
+
+    // În procesele copil: închide socket-ul moștenit, fără thread-uri
+    void close_in_child();
+
+    // În timpul graceful shutdown readiness răspunde 503
+    void set_draining(bool draining) { draining_ = draining; }
+
+private:
+    AdminConfig config_;
+    const GlobalStats* stats_;
+    const RouteStats* routes_;
+    const Router* router_;
+    HealthCheck* health_;
+
+    int listen_fd_ = -1;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> draining_{false};
+
+    void run();
+    void handle(int client_fd);
+    std::string respond(const std::string& method, const std::string& path);
+    std::string readiness(bool& ready);
+};
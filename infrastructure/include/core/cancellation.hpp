@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Anularea cooperativă a unei cereri: termenul (deadline) rutei sau al
+// clientului, ori deconectarea clientului (EPOLLRDHUP, văzută de EventLoop).
+//
+// Handler-ul verifică starea când vrea (cancelled()); stratul de date se
+// înregistrează cu on_cancel() pe durata unei interogări, ca să o întrerupă
+// (sqlite3_interrupt) imediat ce cererea e anulată.
+
+enum class CancelReason : uint8_t {
+    None,
+    Deadline,         // Termenul a trecut
+    Disconnected      // Clientul a închis conexiunea
+};
+
+class CancellationState {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // deadline = Clock::time_point() înseamnă fără termen
+    explicit CancellationState(Clock::time_point deadline = Clock::time_point());
+
+    CancellationState(const CancellationState&) = delete;
+    CancellationState& operator=(const CancellationState&) = delete;
+
+    // Anulată explicit sau cu termenul trecut (verificat la fiecare apel)
+    bool cancelled() const { return reason() != CancelReason::None; }
+    CancelReason reason() const;
+
+    bool has_deadline() const { return deadline_ != Clock::time_point(); }
+    Clock::time_point deadline() const { return deadline_; }
+
+    // Timpul rămas până la termen: 0 după el, milliseconds::max() fără termen
+    std::chrono::milliseconds remaining() const;
+
+    // Prima anulare câștigă; apelează callback-urile înregistrate pe thread-ul apelant
+    void cancel(CancelReason reason);
+
+    // Callback la anulare; 0 = deja anulată (callback-ul nu se păstrează).
+    // Rulează sub lock: după remove(id) nu mai poate fi apelat.
+    uint64_t on_cancel(std::function<void()> callback);
+    void remove(uint64_t id);
+
+private:
+    Clock::time_point deadline_;
+    std::atomic<CancelReason> reason_{CancelReason::None};
+    std::mutex m_;
+    std::vector<std::pair<uint64_t, std::function<void()>>> callbacks_;
+    uint64_t next_id_ = 1;
+};
+
+namespace Cancellation {
+    // Cererea procesată acum de thread-ul curent (nullptr = niciuna / fără anulare)
+    inline thread_local CancellationState* current_ = nullptr;
+    inline CancellationState* current() { return current_; }
+
+    // Setează starea curentă a thread-ului pe durata unui bloc
+    class CurrentScope {
+    public:
+        explicit CurrentScope(CancellationState* state) : previous_(current_) { current_ = state; }
+        ~CurrentScope() { current_ = previous_; }
+        CurrentScope(const CurrentScope&) = delete;
+        CurrentScope& operator=(const CurrentScope&) = delete;
+    private:
+        CancellationState* previous_;
+    };
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Router;       // http/router.hpp
+struct Route;       // http/router.hpp
+class HttpRequest;  // http/request.hpp
+
+// Limită adaptivă de concurență per worker și per grup de rute (prefix).
+//
+// Câte cereri ale unui grup rulează simultan într-un worker e limitat de o
+// valoare care se ajustează după latența observată (gradient, ca TCP Vegas):
+// cât timp latența rămâne aproape de minimul văzut (RTT-ul fără coadă), limita
+// crește; când latența urcă (ex. SQLite încetinește), serverul e saturat și
+// limita scade proporțional, până la min_limit.
+//
+// Peste limită o cerere așteaptă scurt un loc (cel mult max_queue cereri, cel
+// mult queue_timeout); altfel primește 503 fără să ajungă la handler.
+//
+// Starea e a procesului (fiecare worker are limitele lui); valorile sunt
+// publicate în GlobalStats pentru /metrics.
+
+struct ConcurrencyLimitPolicy {
+    std::string prefix;                 // "" = toate rutele; altfel rutele de sub prefix
+    int initial_limit = 20;
+    int min_limit = 1;
+    int max_limit = 200;
+    double tolerance = 2.0;             // Latența acceptată, ca multiplu al RTT-ului minim, înainte de a scădea
+    double smoothing = 0.2;             // Cât din limita nouă se aplică la fiecare eșantion
+    size_t max_queue = 16;              // Cereri care pot aștepta un loc
+    std::chrono::milliseconds queue_timeout{50};
+    std::chrono::seconds rtt_window{30};   // RTT-ul minim e cel din ultimele 1-2 ferestre
+};
+
+// Starea unui grup într-un worker, în shared memory (GlobalStats)
+struct ConcurrencyStats {
+    std::atomic<int> limit;
+    std::atomic<int> in_flight;
+    std::atomic<int> waiting;
+    std::atomic<int64_t> min_rtt_us;
+    std::atomic<int64_t> rtt_us;            // Media recentă (EWMA)
+    std::atomic<uint64_t> admitted;
+    std::atomic<uint64_t> queued;           // Admise după ce au așteptat
+    std::atomic<uint64_t> shed;             // 503: coada plină sau timeout
+};
+
+class ConcurrencyLimiter {
+public:
+    static constexpr size_t MAX_GROUPS = 8;
+
+    // Creat înainte de fork; fiecare worker pornește de la initial_limit
+    explicit ConcurrencyLimiter(std::vector<ConcurrencyLimitPolicy> policies);
+
+    ConcurrencyLimiter(const ConcurrencyLimiter&) = delete;
+    ConcurrencyLimiter& operator=(const ConcurrencyLimiter&) = delete;
+
+    // Grupul fiecărei rute dinamice, după pattern: cel mai lung prefix câștigă
+    void resolve(const Router& router);
+
+    // Grupul cererii (-1 = nelimitată): precalculat pentru rutele dinamice,
+    // după path pentru celelalte (tabele statice, 404)
+    int group_for(const Router& router, const Route* route, const HttpRequest& request) const;
+
+    // Un loc în grup: imediat sub limită, altfel după o așteptare scurtă.
+    // false = cererea se refuză (coada plină sau timeout). waited = a așteptat
+    bool acquire(int group, bool* waited = nullptr);
+
+    // Eliberează locul; cu sample, latența cererii ajustează limita
+    void release(int group, std::chrono::nanoseconds latency, bool sample);
+
+    // Publică starea grupurilor în stats[0..MAX_GROUPS); apelat în worker, după fork
+    void set_stats(ConcurrencyStats* stats);
+
+    const std::vector<ConcurrencyLimitPolicy>& policies() const { return policies_; }
+    int limit(int group) const;
+
+private:
+    struct Group {
+        std::mutex m;
+        std::condition_variable cv;
+        double limit = 0;
+        int in_flight = 0;
+        int waiting = 0;
+        int64_t window_start_ns = 0;
+        int64_t window_min_ns = 0;      // Minimul ferestrei curente
+        int64_t previous_min_ns = 0;    // Minimul ferestrei trecute
+        double rtt_ns = 0;              // EWMA
+    };
+
+    std::vector<ConcurrencyLimitPolicy> policies_;
+    std::vector<std::unique_ptr<Group>> groups_;
+    std::vector<int> route_group_;      // Indexat ca Router::routes
+    ConcurrencyStats* stats_ = nullptr;
+
+    int match_prefix(std::string_view path) const;
+    void update(Group& group, const ConcurrencyLimitPolicy& policy, int64_t latency_ns, int in_flight);
+    void publish(int index, const Group& group);
+};
+
+// Locul unei cereri, eliberat o singură dată: explicit după trimiterea
+// răspunsului (cu eșantion) sau în destructor (fără, ex. completion abandonat)
+class ConcurrencyPermit {
+public:
+    ConcurrencyPermit(ConcurrencyLimiter* limiter, int group)
+        : limiter_(limiter), group_(group), start_(std::chrono::steady_clock::now()) {}
+    ~ConcurrencyPermit() { release(false); }
+
+    ConcurrencyPermit(const ConcurrencyPermit&) = delete;
+    ConcurrencyPermit& operator=(const ConcurrencyPermit&) = delete;
+
+    void release(bool sample) {
+        if (!limiter_) return;
+        limiter_->release(group_, std::chrono::steady_clock::now() - start_, sample);
+        limiter_ = nullptr;
+    }
+
+private:
+    ConcurrencyLimiter* limiter_;
+    int group_;
+    std::chrono::steady_clock::time_point start_;
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+
+// Event loop per proces (epoll + eventfd) rulat într-un thread dedicat.
+// Workers îl folosesc pentru timere, readiness pe socket-uri și pentru
+// reluarea handler-elor asincrone fără să ocupe thread-uri din ThreadPool.
+class EventLoop {
+public:
+    using Callback = std::function<void()>;
+    using IoCallback = std::function<void(uint32_t events)>;
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // Loop-ul procesului curent; pornit la prima utilizare (și refăcut după fork)
+    static EventLoop& instance();
+
+    void start();
+    void stop();
+    bool is_running() const { return running_; }
+    bool in_loop_thread() const;
+
+    // Rulează callback-ul pe thread-ul loop-ului (thread-safe)
+    void post(Callback cb);
+
+    // Rulează callback-ul după delay (thread-safe)
+    void run_after(std::chrono::milliseconds delay, Callback cb);
+
+    // Callback o singură dată când fd devine gata (EPOLLIN/EPOLLOUT); thread-safe
+    bool watch_once(int fd, uint32_t events, IoCallback cb);
+
+    // Renunță la watch (callback-ul nu mai este apelat)
+    void unwatch(int fd);
+
+private:
+    struct Timer {
+        std::chrono::steady_clock::time_point when;
+        uint64_t seq;
+        Callback cb;
+        bool operator>(const Timer& other) const {
+            return when != other.when ? when > other.when : seq > other.seq;
+        }
+    };
+
+    struct Watch {
+        uint32_t events;
+        IoCallback cb;
+    };
+
+    int epoll_fd_;
+    int wake_fd_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    std::mutex mutex_;
+    std::vector<Callback> pending_;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+    uint64_t timer_seq_ = 0;
+    std::map<int, Watch> watches_;
+
+    void loop();
+    void wakeup();
+    int next_timeout_ms();
+    void run_timers();
+    void run_pending();
+};
@@ -38,6 +38,10 @@ public:
     // Overall system health
     HealthStatus get_overall_status();
 
+    // Ultimele rezultate ale run_all() (copie; nu rulează check-urile)
+    std::vector<HealthCheckResult> last_results() const;
+    size_t check_count() const { return checks_.size(); }
+
     // Auto-check în background
     void start_periodic_checks(std::chrono::seconds interval);
     void stop_periodic_checks();
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <sys/types.h>
+
+// Un socket pe care Master acceptă conexiuni (TCP sau Unix domain socket)
+struct ListenerConfig {
+    enum class Type { TCP, UNIX };
+
+    Type type = Type::TCP;
+    std::string host = "0.0.0.0";   // TCP: adresa de bind
+    int port = 8080;                // TCP
+    std::string path;               // UNIX: calea fișierului socket
+    mode_t mode = 0660;             // UNIX: permisiuni (cine se poate conecta)
+    int backlog = 128;
+
+    // TLS (TLS 1.3): handshake-ul îl face worker-ul care primește conexiunea
+    bool tls = false;
+    std::string cert_file;          // PEM, certificat + lanț
+    std::string key_file;           // PEM, cheia privată
+
+    static ListenerConfig tcp(int port, const std::string& host = "0.0.0.0");
+    static ListenerConfig unix_socket(const std::string& path, mode_t mode = 0660);
+    static ListenerConfig tls_tcp(int port, const std::string& cert_file, const std::string& key_file,
+                                  const std::string& host = "0.0.0.0");
+
+    // "tcp://0.0.0.0:8080", "tls://0.0.0.0:8443" sau "unix:/run/api.sock"
+    std::string describe() const;
+};
+
+namespace Listener {
+    // socket + bind + listen, non-blocking; aruncă std::runtime_error la eroare
+    int open(const ListenerConfig& config);
+
+    // Închide socket-ul; pentru UNIX șterge și fișierul
+    void close(int fd, const ListenerConfig& config);
+}
@@ -9,17 +9,33 @@
 
 #include "ipc/sharedqueue.hpp"
 #include "ipc/sharedmemory.hpp"
+#include "ipc/fdchannel.hpp"
 #include "http/router.hpp"
+#include "core/listener.hpp"
+#include "core/tls.hpp"
+#include "http/routestats.hpp"
+#include "core/adminserver.hpp"
+#include "core/threadpool.hpp"
+#include "core/concurrencylimit.hpp"
+#include <memory>
 
 #define MAX_EVENTS 64
 #define MAX_WORKERS 32
+#define MAX_THREAD_POOLS 8        // Per worker: pool-ul implicit + cele cu nume (Worker::set_thread_pools)
+#define JOB_QUEUE_CAPACITY 1024   // Conexiuni acceptate, încă nepreluate de worker-i
 
 // Structură pentru statistici workers în shared memory
 struct WorkerStats {
     pid_t pid;
     std::atomic<uint64_t> requests_handled;
     std::atomic<uint64_t> requests_failed;
-    std::atomic<int> status;  // 0=dead, 1=idle, 2=busy
+    std::atomic<int> status;  // 0=dead, 1=idle, 2=busy, 3=draining
+    std::atomic<int> in_flight;               // Conexiuni primite și încă netrimise
+    std::atomic<uint64_t> drained;            // Finalizate în timpul drain-ului
+    std::atomic<uint64_t> aborted;            // Încă active la expirarea drain-ului
+    std::atomic<int> queued;                  // Primite, în coada ThreadPool-ului (fără thread încă)
+    ThreadPoolStats pools[MAX_THREAD_POOLS];  // [0] = implicit, [i + 1] = Worker::thread_pools()[i]
+    ConcurrencyStats concurrency[ConcurrencyLimiter::MAX_GROUPS];  // Indexat ca policies() ale limitatorului
     char last_error[256];
 };
 
@@ -28,6 +44,12 @@ struct GlobalStats {
     std::atomic<uint64_t> total_requests;
     std::atomic<uint64_t> total_errors;
     std::atomic<int> active_connections;
+    std::atomic<int> drain_timeout_ms;        // Setat de Master înainte de SIGTERM
+    std::atomic<int> pending_connections;     // Tichete în SharedQueue, încă nepreluate de un worker
+    std::atomic<int> queue_capacity;
+    std::atomic<int> num_workers;
+    std::atomic<uint64_t> worker_restarts;
+    std::atomic<int64_t> start_time;          // Unix time (secunde) la pornirea Master-ului
     WorkerStats workers[MAX_WORKERS];
 };
 
@@ -43,30 +65,44 @@ class MasterProcess {
 private:
     int port_;
     int num_workers_;
-    int server_fd_;
     int epoll_fd_;
 
+    std::vector<ListenerConfig> listener_configs_;  // Gol = TCP pe port_
+    std::vector<int> listen_fds_;                   // Același index ca listener_configs_
+    std::vector<std::shared_ptr<TlsContext>> tls_contexts_;  // nullptr pentru listener-ele fără TLS
+
     std::atomic<bool> running_;
     std::atomic<bool> shutdown_requested_;
 
     std::vector<WorkerInfo> workers_;
-    SharedQueue<int>* job_queue_;           // Coadă de file descriptors
+    SharedQueue<int>* job_queue_;           // Tichete (index listener) pentru conexiuni în așteptare
+    FdChannel conn_channel_;                // Conexiunile propriu-zise, transferate prin SCM_RIGHTS
     SharedMemory* worker_status_shm_;       // Status workers în shared memory
     GlobalStats* global_stats_;
+    RouteStats* route_stats_;               // Per rută x worker, în shared memory
 
     Router router_;
 
+    // Port de administrare servit de un thread al Master-ului (opțional)
+    AdminConfig admin_config_;
+    HealthCheck* health_check_ = nullptr;
+    std::unique_ptr<AdminServer> admin_;
+
     // Timeout pentru graceful shutdown
     std::chrono::seconds shutdown_timeout_{30};
 
     // Metode private
     void create_workers();
     void setup_signals();
+    bool open_listeners();
+    void close_listeners(bool remove_files);
     void setup_epoll();
     void accept_loop_epoll();
-    void distribute_connection(int client_fd);
+    void distribute_connection(int client_fd, int listener_index, const PeerAddress& peer);
     void monitor_workers();
     void handle_worker_death(pid_t pid, int worker_index);
+    void report_drain();
+    int drain_timeout_ms() const;
     void cleanup();
 
 public:
@@ -78,5 +114,18 @@ public:
     void graceful_shutdown();
 
     void setRouter(const Router& r);
+
+    // Adaugă un listener (TCP sau Unix domain socket); fără niciunul se ascultă TCP pe port
+    void add_listener(const ListenerConfig& config);
     void set_shutdown_timeout(std::chrono::seconds timeout);
+
+    // Port de administrare (config.port > 0); health poate fi nullptr.
+    // Check-urile din health rulează periodic în procesul Master.
+    void set_admin(const AdminConfig& config, HealthCheck* health = nullptr);
+
+    // Statistici per rută (după start(), și în procesele worker); nullptr înainte
+    RouteStats* route_stats() const { return route_stats_; }
+    // Statistici globale / per worker (shared memory, după start()); nullptr înainte
+    const GlobalStats* global_stats() const { return global_stats_; }
+    const Router& router() const { return router_; }
 };
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <sys/socket.h>
+
+// Adresa clientului așa cum a văzut-o accept() în Master. Worker-ul nu o poate
+// afla singur în toate cazurile: cu TLS fără kTLS primește capătul unui
+// socketpair, iar getpeername() pe el nu spune nimic despre client.
+//
+// Binară și de mărime fixă: trece prin FdChannel împreună cu fd-ul, iar textul
+// se formează doar când e nevoie de el (ex. cheia de rate limit).
+struct PeerAddress {
+    uint16_t family = 0;        // AF_INET / AF_INET6; 0 = necunoscută (ex. socket Unix)
+    uint16_t port = 0;          // Ordinea gazdei
+    uint8_t bytes[16] = {};     // IPv4 în primii 4
+
+    bool known() const { return family != 0; }
+
+    // Din rezultatul lui accept()/getpeername(); alte familii dau o adresă necunoscută
+    static PeerAddress from(const struct sockaddr_storage& addr);
+
+    // Adresa fără port ("203.0.113.7", "2001:db8::1"); "" dacă e necunoscută
+    std::string to_string() const;
+};
@@ -20,10 +20,20 @@ public:
     // setează rutele (Router)
     void setRouter(const Router& r);
 
+    // Listener suplimentar (TCP / Unix domain socket); fără niciunul: TCP pe port
+    void add_listener(const ListenerConfig& config);
+
     // Graceful shutdown support
     void request_shutdown();
     void set_shutdown_timeout(std::chrono::seconds timeout);
 
+    // Port de administrare servit de Master (health, readiness, metrici)
+    void set_admin(const AdminConfig& config, HealthCheck* health = nullptr);
+
+    // Statistici per rută (valabile după start, și în worker-i); nullptr altfel
+    RouteStats* route_stats() const { return master ? master->route_stats() : nullptr; }
+    const GlobalStats* global_stats() const { return master ? master->global_stats() : nullptr; }
+
 private:
     int port;
     int num_workers;
@@ -1,4 +1,3 @@
-
 #pragma once
 #include <thread>
 #include <mutex>
@@ -7,20 +6,44 @@
 #include <functional>
 #include <vector>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Starea unui pool, în shared memory (GlobalStats): citită de /metrics din orice proces
+struct ThreadPoolStats {
+    std::atomic<int> threads;
+    std::atomic<int> busy;                  // Thread-uri care rulează un task
+    std::atomic<int> queued;                // Task-uri care așteaptă un thread
+    std::atomic<int> queue_limit;           // 0 = fără limită
+    std::atomic<uint64_t> completed;
+    std::atomic<uint64_t> rejected;         // try_enqueue cu coada plină
+};
 
 class ThreadPool {
 public:
     ThreadPool();
     explicit ThreadPool(int n);
     ~ThreadPool();
-    void init(int n);
+
+    // max_queue = câte task-uri pot aștepta (0 = fără limită; doar try_enqueue o respectă)
+    void init(int n, size_t max_queue = 0);
     void enqueue(std::function<void()> f);
+
+    // false = coada e plină (task-ul nu a fost preluat)
+    bool try_enqueue(std::function<void()> f);
     void stop();
+
+    // Contoarele pool-ului; setat înainte de init
+    void set_stats(ThreadPoolStats* stats) { stats_ = stats; }
+    int size() const { return static_cast<int>(workers.size()); }
+
 private:
     std::vector<std::thread> workers;
     std::queue<std::function<void()>> tasks;
     std::mutex m;
     std::condition_variable cv;
     std::atomic<bool> stopping{false};
+    size_t max_queue_ = 0;
+    ThreadPoolStats* stats_ = nullptr;
     void worker_loop();
 };
@@ -0,0 +1,78 @@
+#pragma once
+#include "core/eventloop.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+typedef struct ssl_ctx_st SSL_CTX;
+
+// Cheile pentru session tickets (TLS 1.3): generate o dată de Master, înainte de fork,
+// ca orice worker să poată relua o sesiune începută la alt worker
+struct TlsTicketKeys {
+    unsigned char data[80];   // nume (16) + HMAC (32) + AES (32)
+
+    static TlsTicketKeys generate();
+};
+
+// SSL_CTX pentru un listener TLS: doar TLS 1.3, kTLS cerut, tickets cu cheile comune
+class TlsContext {
+public:
+    // Aruncă std::runtime_error dacă certificatul sau cheia nu pot fi încărcate
+    static std::shared_ptr<TlsContext> create(const std::string& cert_file, const std::string& key_file,
+                                              const TlsTicketKeys& keys);
+    ~TlsContext();
+
+    TlsContext(const TlsContext&) = delete;
+    TlsContext& operator=(const TlsContext&) = delete;
+
+    SSL_CTX* get() const { return ctx_; }
+
+private:
+    TlsContext() = default;
+    SSL_CTX* ctx_ = nullptr;
+};
+
+// Handshake-uri TLS pe un thread dedicat (EventLoop propriu), ca un handshake complet
+// să nu ocupe thread-urile care procesează cereri. După handshake, handler-ul primește
+// un fd în clar, deci restul serverului (Worker, BodyReader, WebSocket, SSE) nu se schimbă:
+//  - kTLS activ în ambele direcții: chiar socket-ul clientului; kernel-ul criptează
+//    send/sendfile și decriptează recv, fără copii în user space
+//  - altfel (modulul tls lipsă, cifru nesuportat): o punte socketpair <-> SSL pe thread-ul TLS
+class TlsAcceptor {
+public:
+    using ReadyCallback = std::function<void(int fd)>;  // fd blocking, date în clar
+    using FailCallback = std::function<void()>;         // handshake eșuat; socket-ul e deja închis
+
+    static constexpr int HANDSHAKE_TIMEOUT_MS = 10000;
+
+    TlsAcceptor() = default;
+    ~TlsAcceptor();
+
+    TlsAcceptor(const TlsAcceptor&) = delete;
+    TlsAcceptor& operator=(const TlsAcceptor&) = delete;
+
+    void start();
+    void stop();
+
+    // Preia socket-ul clientului (thread-safe)
+    void accept(int client_fd, const std::shared_ptr<TlsContext>& context,
+                ReadyCallback on_ready, FailCallback on_fail);
+
+    // Handshake-uri în curs + punți încă deschise
+    int active() const { return active_.load(); }
+
+    uint64_t handshakes() const { return handshakes_.load(); }
+    uint64_t resumed() const { return resumed_.load(); }
+    uint64_t ktls() const { return ktls_.load(); }
+
+private:
+    friend class TlsSession;
+
+    EventLoop loop_;
+    std::atomic<int> active_{0};
+    std::atomic<uint64_t> handshakes_{0};
+    std::atomic<uint64_t> resumed_{0};
+    std::atomic<uint64_t> ktls_{0};
+};
@@ -0,0 +1,113 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Tracing per cerere: fiecare cerere primește un ID (din header sau generat), iar
+// etapele ei (accept, coadă, citire, parsare, middleware, handler, DB, trimitere)
+// se înregistrează ca span-uri.
+//
+// Span-urile stau în inele (ring buffers) în shared memory creată înainte de fork:
+// fiecare thread care înregistrează își ia un inel al lui și scrie fără lock-uri
+// (un singur scriitor per inel, seqlock per eveniment). Oricare proces poate citi
+// toate inelele, deci un dump conține toți worker-ii.
+//
+// Dezactivat, costul e un test pe un bool global (Worker) sau pe un pointer
+// thread_local (Scope).
+
+enum class SpanKind : uint8_t {
+    Request,      // Toată cererea: de la accept până după trimitere
+    Accept,       // Acceptată de Master -> primită de worker (FdChannel)
+    Queue,        // Primită de worker -> preluată de un thread din pool
+    Read,         // Citirea headerelor
+    Parse,
+    Middleware,
+    Handler,
+    After,        // Hook-urile after
+    Db,
+    Send,
+    Custom
+};
+
+struct TraceConfig {
+    double sample_rate = 1.0;                 // Fracțiunea de cereri înregistrate (0..1)
+    std::string header = "X-Request-Id";      // Preluat din cerere sau generat; trimis înapoi în răspuns
+    size_t rings = 128;                       // Câte thread-uri pot înregistra simultan
+    size_t events_per_ring = 4096;            // Rotunjit la o putere a lui 2; cele vechi se suprascriu
+    std::string dump_file = "trace.json";     // Scris de Master la SIGUSR2
+};
+
+// Cererea curentă: ID-ul și decizia de eșantionare. Se copiază ieftin (ex. în completion)
+struct TraceContext {
+    char id[40] = {0};
+    bool sampled = false;
+    int64_t start_ns = 0;                     // Începutul span-ului Request
+};
+
+namespace Trace {
+    // Creează inelele și activează tracing-ul. Apelat înainte de fork.
+    void configure(const TraceConfig& config);
+    const TraceConfig& config();
+
+    // Setat o singură dată, înainte de fork
+    extern bool enabled_;
+    inline bool enabled() { return enabled_; }
+
+    // CLOCK_MONOTONIC în ns: comun tuturor proceselor
+    int64_t now_ns();
+
+    // ID-ul cererii: incoming dacă nu e gol (trunchiat), altfel unul nou; decide eșantionarea
+    void begin(TraceContext& ctx, std::string_view incoming_id);
+
+    // Un span terminat (ignorat dacă cererea nu e eșantionată)
+    void record(const TraceContext& ctx, SpanKind kind, int64_t start_ns, int64_t end_ns,
+                std::string_view detail = std::string_view());
+
+    // Cererea procesată acum de thread-ul curent (nullptr = niciuna / netrasată)
+    inline thread_local TraceContext* current_ = nullptr;
+    inline TraceContext* current() { return current_; }
+
+    // Setează cererea curentă a thread-ului pe durata unui bloc
+    class CurrentScope {
+    public:
+        explicit CurrentScope(TraceContext* ctx) : previous_(current_) { current_ = ctx; }
+        ~CurrentScope() { current_ = previous_; }
+        CurrentScope(const CurrentScope&) = delete;
+        CurrentScope& operator=(const CurrentScope&) = delete;
+    private:
+        TraceContext* previous_;
+    };
+
+    // Span pe durata unui bloc, pentru cererea curentă a thread-ului.
+    // detail trebuie să trăiască până la sfârșitul blocului.
+    class Scope {
+    public:
+        explicit Scope(SpanKind kind, std::string_view detail = std::string_view())
+            : ctx_(current_), kind_(kind), detail_(detail), start_(0) {
+            if (ctx_ && ctx_->sampled) start_ = now_ns();
+        }
+        ~Scope() {
+            if (start_) record(*ctx_, kind_, start_, now_ns(), detail_);
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        TraceContext* ctx_;
+        SpanKind kind_;
+        std::string_view detail_;
+        int64_t start_;
+    };
+
+    // Evenimentele din inele ca JSON Chrome trace-event (chrome://tracing, Perfetto).
+    // request_id nevid: doar span-urile acelei cereri
+    std::string chrome_json(std::string_view request_id = std::string_view());
+
+    // chrome_json() scris în path; false la eroare
+    bool write_chrome_json(const std::string& path);
+
+    // Span-uri pierdute: toate inelele erau ocupate de alte thread-uri
+    uint64_t dropped();
+
+    const char* span_name(SpanKind kind);
+}
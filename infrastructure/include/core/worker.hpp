@@ -1,11 +1,86 @@
 #pragma once
+#include "core/peeraddress.hpp"
+
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <functional>
+#include <memory>
+#include <vector>
 
 class Router;  // forward declaration
+class CorsPolicy;  // http/cors.hpp
+class RateLimiter;  // http/ratelimit.hpp
+class ThreadPool;  // core/threadpool.hpp
+class ConcurrencyLimiter;  // core/concurrencylimit.hpp
 
 namespace Worker {
-    void handle_client(int client_fd, Router* router);
+    // Ce se știe despre conexiune dinaintea lui handle_client: momentele
+    // (Trace::now_ns) pentru span-urile accept și queue și pentru termenul
+    // cererii (0 = necunoscut) și adresa clientului de la accept()
+    struct ConnectionTimes {
+        int64_t accepted_ns = 0;    // accept() în Master
+        int64_t received_ns = 0;    // Primită de worker prin FdChannel
+        PeerAddress peer;           // Necunoscută pe socket Unix
+    };
+
+    // on_done se apelează după ce răspunsul a fost trimis și socket-ul închis
+    // (poate fi din alt thread, dacă ruta e asincronă)
+    void handle_client(int client_fd, Router* router, std::function<void()> on_done = nullptr,
+                       ConnectionTimes times = ConnectionTimes());
+    // Citește până la sfârșitul headerelor; rezultatul poate conține și începutul corpului
     std::string read_request(int fd);
     void send_response(int fd, const std::string& response);
     void initialize();
+
+    // Limita corpului pentru rutele obișnuite (citit întreg în memorie); peste = 413.
+    // Rutele cu corp în flux nu au limită aici. Se setează înainte de fork.
+    void set_max_body_size(size_t bytes);
+    size_t max_body_size();
+
+    // Cu o politică CORS setată, cererile OPTIONS primesc 204 (preflight)
+    // înainte de router. nullptr = dezactivat. Se setează înainte de fork.
+    void set_cors_policy(std::shared_ptr<const CorsPolicy> policy);
+
+    // Cu un limitator setat, cererile peste limită primesc 429 după căutarea
+    // rutei, înainte de corp și de handler. nullptr = dezactivat. Se setează
+    // înainte de fork (gălețile sunt în shared memory, comune worker-ilor).
+    void set_rate_limiter(std::shared_ptr<RateLimiter> limiter);
+
+    // Pool de thread-uri cu nume (bulkhead): rutele atribuite lui își rulează
+    // corpul, handler-ul și trimiterea acolo, nu în pool-ul implicit. Cu coada
+    // plină cererea primește 503, fără să ocupe alt pool.
+    struct ThreadPoolConfig {
+        std::string name;
+        int threads = 4;
+        size_t queue_limit = 64;      // Cereri care pot aștepta un thread
+    };
+
+    // Thread-urile pool-ului implicit (citire, parsare, rutare și rutele fără pool).
+    // Se setează înainte de fork.
+    void set_thread_pool_size(int threads);
+    int thread_pool_size();
+
+    // Cel mult MAX_THREAD_POOLS - 1; indexul e Route::pool. Se setează înainte de fork.
+    void set_thread_pools(std::vector<ThreadPoolConfig> pools);
+    const std::vector<ThreadPoolConfig>& thread_pools();
+
+    // În worker, după fork: pool-urile pornite (același index ca thread_pools()); {} la oprire
+    void attach_thread_pools(std::vector<ThreadPool*> pools);
+
+    // Cu un limitator setat, cererile unui grup de rute rulează cel mult câte
+    // permite limita adaptivă a grupului; peste ea așteaptă scurt sau primesc
+    // 503. nullptr = dezactivat. Se setează înainte de fork; fiecare worker
+    // își ajustează limitele lui.
+    void set_concurrency_limiter(std::shared_ptr<ConcurrencyLimiter> limiter);
+    ConcurrencyLimiter* concurrency_limiter();
+
+    // Anularea cererilor (HttpRequest::cancellation): termenul rutei (Route::deadline_ms),
+    // scurtat de cel trimis de client, și deconectarea clientului cât rulează ruta.
+    // Se setează înainte de fork.
+    struct CancellationConfig {
+        bool watch_disconnects = false;   // EPOLLRDHUP pe socket, prin EventLoop
+        std::string deadline_header;      // Termenul clientului în ms (ex. "X-Request-Timeout"); gol = ignorat
+    };
+    void set_cancellation(CancellationConfig config);
 }
@@ -8,6 +8,11 @@
 #include "http/router.hpp"
 #include "ipc/sharedqueue.hpp"
 #include "ipc/sharedmemory.hpp"
+#include "ipc/fdchannel.hpp"
+#include "core/tls.hpp"
+#include "core/worker.hpp"
+#include <memory>
+#include <vector>
 
 // Forward declaration pentru GlobalStats
 struct GlobalStats;
@@ -17,19 +22,34 @@ private:
     int worker_id_;
     pid_t pid_;
     ThreadPool thread_pool_;
+    std::vector<std::unique_ptr<ThreadPool>> route_pools_;  // Worker::thread_pools(), același index
     Router* router_;
     SharedQueue<int>* job_queue_;
+    FdChannel* conn_channel_;
     SharedMemory* worker_status_shm_;
     GlobalStats* global_stats_;
 
+    // Per listener (același index ca tichetul); nullptr = fără TLS
+    std::vector<std::shared_ptr<TlsContext>> tls_contexts_;
+    TlsAcceptor tls_acceptor_;
+
     std::atomic<bool> running_{false};
 
+    // Drain: conexiuni primite și încă nefinalizate
+    std::atomic<int> in_flight_{0};
+    std::atomic<bool> draining_{false};
+
     void setup_signals();
     void work_loop();
-    void process_request(int client_fd);
+    void dispatch_connection(int client_fd, uint32_t listener_index, int64_t accepted_ns = 0,
+                             const PeerAddress& peer = PeerAddress());
+    void process_request(int client_fd, Worker::ConnectionTimes times);
+    void connection_done();
+    void drain();
 
 public:
-    WorkerProcess(int id, Router* r, SharedQueue<int>* queue, SharedMemory* shm);
+    WorkerProcess(int id, Router* r, SharedQueue<int>* queue, FdChannel* channel, SharedMemory* shm,
+                  std::vector<std::shared_ptr<TlsContext>> tls_contexts = {});
     ~WorkerProcess();
 
     void start();  // Rulează în proces copil (după fork)
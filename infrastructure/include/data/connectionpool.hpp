@@ -36,6 +36,10 @@ private:
     std::atomic<uint64_t> total_destroyed_{0};
     std::atomic<uint64_t> wait_count_{0};
     std::atomic<uint64_t> wait_time_ms_{0};
+    std::atomic<uint64_t> timeouts_{0};
+    // Oglinzi ale stării de sub pool_mutex_, ca get_stats() să nu ia lock-ul
+    std::atomic<size_t> open_count_{0};
+    std::atomic<size_t> in_use_count_{0};
 
 public:
     ConnectionPool(size_t min, size_t max,
@@ -85,7 +89,10 @@ public:
         uint64_t total_destroyed;
         uint64_t wait_count;
         uint64_t avg_wait_time_ms;
+        uint64_t timeouts;
+        size_t max_connections;
     };
+    // Doar atomice, fără pool_mutex_: sigur de apelat la fiecare scrape /metrics
     Stats get_stats() const;
 
     void print_stats() const;
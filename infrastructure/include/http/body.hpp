@@ -0,0 +1,73 @@
+#pragma once
+#include "http/request.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+// Corpul cererii citit incremental de pe socket (Content-Length sau chunked).
+// Citirea se face doar când handler-ul cere următorul fragment: un consumator
+// lent umple buffer-ul TCP și clientul e frânat (backpressure), iar corpul
+// nu trebuie să încapă întreg în memorie.
+
+// Eroare la citirea corpului; status = codul HTTP de trimis (400, 408, 413)
+class BodyError : public std::runtime_error {
+public:
+    BodyError(int status, const std::string& what) : std::runtime_error(what), status_(status) {}
+    int status() const { return status_; }
+
+private:
+    int status_;
+};
+
+class BodyReader {
+public:
+    static constexpr size_t UNLIMITED = SIZE_MAX;
+
+    // prefetched = octeții de după headere deja citiți împreună cu ele.
+    // fd < 0: corpul e doar prefetched (ex. Router::handle fără socket).
+    // Headere invalide (Content-Length, Transfer-Encoding) sunt raportate de primul next()
+    BodyReader(int fd, std::string prefetched, const HttpRequest& request, size_t max_size = UNLIMITED);
+
+    BodyReader(const BodyReader&) = delete;
+    BodyReader& operator=(const BodyReader&) = delete;
+
+    // Următorul fragment decodat (cel mult max_chunk octeți); false la finalul corpului.
+    // Aruncă BodyError pentru corp invalid, prea mare sau client care nu mai trimite
+    bool next(std::string& chunk, size_t max_chunk = 64 * 1024);
+
+    // Citește tot restul corpului în out (tot limitat de max_size)
+    void read_all(std::string& out);
+
+    // Consumă restul corpului fără să-l păstreze
+    void discard();
+
+    size_t bytes_read() const { return bytes_read_; }
+    int64_t content_length() const { return content_length_; }  // -1 pentru chunked
+    bool is_chunked() const { return chunked_; }
+    bool finished() const { return state_ == State::DONE; }
+
+    // Timeout între două recv-uri (clientul a încetat să trimită)
+    static constexpr int IDLE_TIMEOUT_SECONDS = 30;
+
+private:
+    enum class State { DATA, CHUNK_SIZE, CHUNK_DATA, CHUNK_CRLF, TRAILERS, DONE };
+
+    int fd_;
+    std::string buf_;           // Octeți primiți, încă nedecodați
+    size_t pos_ = 0;            // Începutul datelor neconsumate din buf_
+    State state_;
+    bool chunked_ = false;
+    int64_t content_length_ = 0;
+    uint64_t remaining_ = 0;    // Din Content-Length sau din chunk-ul curent
+    size_t bytes_read_ = 0;
+    size_t max_size_;
+    bool expect_continue_ = false;
+    int error_status_ = 0;      // Eroare din headere, aruncată de next()
+    std::string error_;
+
+    void init(const HttpRequest& request);
+    bool fill();                // Mai citește de pe socket; false la EOF
+    bool read_line(std::string& line);
+    void take(std::string& chunk, size_t max_chunk);
+};
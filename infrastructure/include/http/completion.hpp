@@ -0,0 +1,25 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+
+// Handle pentru completarea unui răspuns HTTP, eventual mai târziu și din alt thread.
+// Copiile împart aceeași stare; doar primul complete() ajunge pe socket.
+// Dacă ultima copie dispare fără complete(), clientul primește 500.
+class ResponseCompletion {
+public:
+    using Sink = std::function<void(const std::string&)>;
+
+    ResponseCompletion() = default;
+    explicit ResponseCompletion(Sink sink);
+
+    // Trimite răspunsul (raw HTTP); false dacă a fost deja completat
+    bool complete(const std::string& raw_response) const;
+
+    bool is_completed() const;
+    bool valid() const { return state_ != nullptr; }
+
+private:
+    struct State;
+    std::shared_ptr<State> state_;
+};
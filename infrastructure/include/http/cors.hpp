@@ -0,0 +1,47 @@
+#pragma once
+#include "http/request.hpp"
+#include <string>
+#include <vector>
+
+// CORS: headerele se serializează o singură dată, la configurare, și se
+// adaugă răspunsurilor ca octeți. Preflight-urile (OPTIONS) primesc direct
+// 204 din Worker, fără să treacă prin router.
+
+struct CorsConfig {
+    // "*", o origine sau o listă separată prin virgulă; pentru listă se
+    // întoarce originea cererii (dacă e permisă) plus Vary: Origin
+    std::string allow_origins = "*";
+    std::string allow_methods = "GET, POST, PUT, DELETE, PATCH, OPTIONS";
+    std::string allow_headers = "Content-Type, Authorization";
+    std::string expose_headers;               // Gol = fără Access-Control-Expose-Headers
+    bool allow_credentials = false;
+    int max_age = 86400;                      // Secunde cât browser-ul ține minte preflight-ul
+};
+
+class CorsPolicy {
+public:
+    explicit CorsPolicy(const CorsConfig& config);
+
+    // Blocul de headere ("Nume: valoare\r\n"...) pentru un răspuns obișnuit;
+    // gol dacă originea cererii nu e permisă
+    std::string headers_for(const HttpRequest& request) const;
+
+    // Răspunsul complet la un preflight (204)
+    std::string preflight_response(const HttpRequest& request) const;
+
+    // Blocul depinde de header-ul Origin (listă de origini)?
+    bool varies_by_origin() const { return !fixed_origin_; }
+
+    static bool is_preflight(const HttpRequest& request) { return request.method == "OPTIONS"; }
+
+private:
+    bool fixed_origin_;                       // "*" sau o singură origine
+    std::vector<std::string> origins_;        // Lista, când nu e fixă
+
+    std::string fixed_headers_;               // Allow-Origin inclus (origine fixă)
+    std::string common_headers_;              // Fără Allow-Origin (listă)
+    std::string fixed_preflight_;
+    std::string preflight_extra_;             // Allow-Methods, Allow-Headers, Max-Age
+
+    bool origin_allowed(const std::string& origin) const;
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+struct GlobalStats;      // core/master.hpp
+class RouteStats;        // http/routestats.hpp
+class Router;            // http/router.hpp
+class ConnectionPool;    // data/connectionpool.hpp
+class RateLimiter;       // http/ratelimit.hpp
+class ConcurrencyLimiter;  // core/concurrencylimit.hpp
+
+// Metrici în formatul text Prometheus (exposition format 0.0.4).
+// Scrape-ul citește doar atomice din shared memory și snapshot-uri; nu ia
+// niciun lock folosit la procesarea cererilor.
+class MetricsWriter {
+public:
+    static constexpr const char* CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8";
+
+    using Label = std::pair<std::string_view, std::string_view>;
+
+    // # HELP + # TYPE; sample-urile familiei trebuie scrise imediat după
+    void family(std::string_view name, std::string_view help, std::string_view type);
+
+    void sample(std::string_view name, std::initializer_list<Label> labels, double value);
+    void sample(std::string_view name, std::initializer_list<Label> labels, uint64_t value);
+    void sample(std::string_view name, std::initializer_list<Label> labels, int64_t value);
+
+    const std::string& str() const { return out_; }
+
+private:
+    std::string out_;
+
+    void begin_sample(std::string_view name, std::initializer_list<Label> labels);
+};
+
+namespace Metrics {
+    // Conexiuni, worker-i (stare, restart-uri), cozi (SharedQueue + ThreadPool)
+    void write_server(MetricsWriter& out, const GlobalStats& stats);
+
+    // Cereri per rută și clasă de status, octeți, histogramă de latență
+    void write_routes(MetricsWriter& out, const RouteStats& stats, const Router& router);
+
+    // Pool-uri de conexiuni DB ale procesului curent (worker = indexul lui, -1 = necunoscut)
+    void write_pools(MetricsWriter& out, const std::vector<std::pair<std::string, const ConnectionPool*>>& pools,
+                     int worker);
+
+    // Pool-urile de thread-uri ale fiecărui worker: mărime, ocupare, coadă, respingeri
+    void write_thread_pools(MetricsWriter& out, const GlobalStats& stats);
+
+    // Cereri permise / refuzate (429) per politică de limitare, din shared memory
+    void write_rate_limits(MetricsWriter& out, const RateLimiter& limiter);
+
+    // Limita adaptivă, ocuparea, RTT-ul și cererile refuzate per worker și grup
+    void write_concurrency_limits(MetricsWriter& out, const GlobalStats& stats, const ConcurrencyLimiter& limiter);
+}
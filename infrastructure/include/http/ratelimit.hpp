@@ -0,0 +1,111 @@
+#pragma once
+#include "ipc/sharedmemory.hpp"
+#include "core/peeraddress.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Router;       // http/router.hpp
+struct Route;       // http/router.hpp
+class HttpRequest;  // http/request.hpp
+
+// Limitare de rată comună tuturor worker-ilor. Gălețile de token-uri stau într-un
+// tabel cu adresare deschisă, de dimensiune fixă, în shared memory creată înainte
+// de fork; fiecare worker le actualizează cu CAS, fără lock-uri.
+//
+// O găleată e ținută ca GCRA: un singur moment teoretic de sosire (TAT) per client.
+// E echivalent cu o găleată de `limit` token-uri reumplută uniform în `window`,
+// dar încape într-un singur cuvânt atomic (token-uri + ultima reumplere nu ar încăpea).
+//
+// O găleată plină la loc (TAT în trecut) nu mai ține nicio stare, așa că locul ei
+// poate fi dat altui client fără să se piardă nimic. Doar dacă toate locurile din
+// fereastra de căutare sunt active, cererea trece (fail open) și se numără.
+
+struct RateLimitPolicy {
+    std::string prefix;                 // "" = toate rutele; altfel rutele de sub prefix
+    uint32_t limit = 100;               // Cereri pe fereastră (și capacitatea găleții)
+    uint32_t window_seconds = 60;
+    std::string key_header;             // Gol = per adresă; ex. "X-API-Key" = per cheie (adresa dacă lipsește)
+    bool trust_forwarded_for = false;   // Adresa din X-Forwarded-For (doar în spatele unui proxy)
+};
+
+struct RateLimitDecision {
+    bool allowed = true;
+    int policy = -1;
+    uint32_t limit = 0;
+    uint32_t remaining = 0;             // Cereri care mai pot veni acum
+    uint32_t reset_seconds = 0;         // Până se umple găleata la loc
+    uint32_t retry_after = 0;           // Doar la refuz: până la următorul token
+};
+
+// Un loc din tabel
+struct RateBucket {
+    std::atomic<uint64_t> key;          // Hash-ul (politică, client); 0 = liber
+    std::atomic<int64_t> tat;           // Momentul teoretic de sosire, us (CLOCK_MONOTONIC)
+};
+
+// Contoare per politică
+struct RateLimitCounters {
+    std::atomic<uint64_t> allowed;
+    std::atomic<uint64_t> limited;
+};
+
+class RateLimiter {
+public:
+    static constexpr size_t MAX_POLICIES = 64;
+    static constexpr size_t MAX_PROBE = 16;   // Locuri încercate per cheie
+
+    // Creat de Master (sau de framework) înainte de fork.
+    // capacity = numărul de găleți, rotunjit în sus la o putere a lui 2
+    RateLimiter(std::vector<RateLimitPolicy> policies, size_t capacity);
+    ~RateLimiter();
+
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    // Politica fiecărei rute dinamice, după pattern: cel mai lung prefix câștigă
+    void resolve(const Router& router);
+
+    // Politica cererii (-1 = nelimitată): precalculată pentru rutele dinamice,
+    // după path pentru celelalte (tabele statice, 404)
+    int policy_for(const Router& router, const Route* route, const HttpRequest& request) const;
+
+    // Cheia clientului: header-ul de cheie, X-Forwarded-For sau adresa clientului.
+    // peer = adresa de la accept() în Master; necunoscută, se ia din socket
+    std::string client_key(int policy, const HttpRequest& request, int client_fd,
+                           const PeerAddress& peer = PeerAddress()) const;
+
+    // Consumă un token din găleata clientului
+    RateLimitDecision take(int policy, std::string_view client);
+
+    // Blocul RateLimit-* ("Nume: valoare\r\n"...) pentru un răspuns permis
+    std::string headers(const RateLimitDecision& decision) const;
+
+    // Răspunsul 429 complet; extra_headers e un bloc serializat (ex. CORS)
+    std::string rejection(const RateLimitDecision& decision, const std::string& extra_headers) const;
+
+    const std::vector<RateLimitPolicy>& policies() const { return policies_; }
+    uint64_t allowed(int policy) const;
+    uint64_t limited(int policy) const;
+    uint64_t saturated() const;         // Cereri lăsate să treacă: tabel plin de clienți activi
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Header {
+        RateLimitCounters counters[MAX_POLICIES];
+        std::atomic<uint64_t> saturated;
+    };
+
+    std::vector<RateLimitPolicy> policies_;
+    std::vector<int> route_policy_;     // Indexat ca Router::routes
+    SharedMemory* shm_;
+    Header* header_;
+    RateBucket* buckets_;
+    size_t mask_;
+
+    int match_prefix(std::string_view path) const;
+    RateBucket* find_or_claim(uint64_t key, int64_t now_us);
+};
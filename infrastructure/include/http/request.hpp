@@ -1,6 +1,9 @@
 #pragma once
 #include <string>
 #include <map>
+#include <memory>
+
+class CancellationState;  // core/cancellation.hpp
 
 class HttpRequest {
 public:
@@ -16,8 +19,14 @@ public:
     // Request raw complet (pentru parsing manual in controller)
     std::string raw;
 
+    // Termenul / deconectarea clientului, setat de worker înainte de handler (nullptr = fără)
+    std::shared_ptr<CancellationState> cancellation;
+
     // utilitare simple (nu rup nimic existent)
     const std::string& getMethod() const { return method; }
     const std::string& getTarget() const { return target; }
     const std::string& getPath()   const { return path;   }
+
+    // Header după nume, fără să țină cont de majuscule ("" dacă lipsește)
+    std::string getHeader(const std::string& name) const;
 };
@@ -0,0 +1,90 @@
+#pragma once
+#include "ipc/sharedmemory.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <pthread.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Cache de răspunsuri partajat între procesele worker.
+// Zona e creată (SharedMemory) înainte de fork, așa că toți worker-ii o moștenesc:
+// un răspuns calculat într-un worker e servit din cache și de ceilalți, iar o
+// invalidare făcută dintr-un worker se vede imediat în toate.
+//
+// Intrările (cheie + răspuns serializat) stau în blocuri de dimensiune fixă,
+// înlănțuite; când nu mai e loc se evacuează intrarea folosită cel mai demult (LRU).
+// Tot accesul e sub un pthread mutex PROCESS_SHARED + ROBUST: dacă un worker
+// moare cu lock-ul luat, următorul golește cache-ul și continuă.
+
+struct ResponseCacheOptions {
+    size_t max_bytes = 16 * 1024 * 1024;   // Spațiul pentru chei + răspunsuri
+    size_t max_entries = 4096;             // Număr maxim de intrări
+};
+
+struct ResponseCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t stores;
+    uint64_t evictions;       // Scoase pentru spațiu (LRU)
+    uint64_t expirations;     // Găsite expirate la lookup
+    uint64_t invalidations;   // Scoase prin invalidate_tag / clear
+    size_t entries;
+    size_t bytes_used;        // Blocuri ocupate * dimensiunea blocului
+};
+
+class ResponseCache {
+public:
+    static constexpr size_t BLOCK_SIZE = 512;
+    static constexpr size_t MAX_TAGS = 4;
+
+    // Creează zona (o singură dată, în procesul care face fork)
+    explicit ResponseCache(const ResponseCacheOptions& options = ResponseCacheOptions());
+    ~ResponseCache();
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    // Copiază răspunsul în out; false dacă lipsește sau a expirat
+    bool lookup(std::string_view key, std::string& out);
+
+    // Înlocuiește intrarea cu aceeași cheie. Peste MAX_TAGS, tag-urile în plus sunt ignorate.
+    // false dacă răspunsul nu încape deloc în cache
+    bool store(std::string_view key, std::string_view value, std::chrono::milliseconds ttl,
+               const std::vector<std::string>& tags = {});
+
+    // Scoate toate intrările cu tag-ul dat; întoarce câte au fost scoase
+    size_t invalidate_tag(std::string_view tag);
+
+    void clear();
+
+    ResponseCacheStats stats() const;
+
+private:
+    // Structurile din shared memory: legături prin indici, nu pointeri
+    // (zona poate fi mapată la adrese diferite)
+    struct Header;
+    struct Entry;
+    struct Block;
+
+    SharedMemory* shm_;
+    Header* header_;
+    int32_t* buckets_;
+    Entry* entries_;
+    Block* blocks_;
+
+    void lock() const;
+    void unlock() const;
+
+    int32_t find_locked(uint64_t hash, std::string_view key) const;
+    bool key_equals(const Entry& entry, std::string_view key) const;
+    void remove_locked(int32_t index);
+    void evict_lru_locked();
+    void lru_unlink(int32_t index);
+    void lru_push_front(int32_t index);
+    void reset_locked();
+
+    static uint64_t hash_bytes(std::string_view data);
+    static int64_t now_ms();
+};
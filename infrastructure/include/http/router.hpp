@@ -1,39 +1,211 @@
 #pragma once
 #include "http/request.hpp"
 #include "http/response.hpp"
+#include "http/completion.hpp"
+#include <chrono>
+#include <cstdint>
 #include <functional>
-#include <map>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+struct WebSocketRoute;  // http/websocket.hpp
+class SseChannel;      // http/sse.hpp
+class BodyReader;      // http/body.hpp
+class RouteStats;      // http/routestats.hpp
+struct Route;
+
+// Parametrii rutei găsite: perechi nume/valoare ca view-uri, fără alocări.
+// Numele sunt în Route::param_names, valorile în path-ul cererii (sau în copia
+// normalizată păstrată aici): valabile pe durata handler-ului, copiați ce păstrați.
+// Necopiabil, ca view-urile să nu ajungă să arate în normalized-ul altui obiect.
+class RouteParams {
+public:
+    static constexpr size_t MAX = 16;
+
+    struct Entry {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    RouteParams() = default;
+    RouteParams(const RouteParams&) = delete;
+    RouteParams& operator=(const RouteParams&) = delete;
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    const Entry* begin() const { return entries_; }
+    const Entry* end() const { return entries_ + count_; }
+
+    // end() dacă parametrul lipsește
+    const Entry* find(std::string_view name) const;
+
+    // "" dacă parametrul lipsește
+    std::string_view get(std::string_view name) const;
+
+private:
+    friend class Router;
+
+    Entry entries_[MAX];
+    size_t count_ = 0;
+    std::string normalized_;  // Path-ul normalizat, doar pentru "//" sau "/" final
+};
+
 // Tip pentru handler functions
-using RouteHandler = std::function<std::string(const HttpRequest&, const std::map<std::string, std::string>&)>;
+using RouteHandler = std::function<std::string(const HttpRequest&, const RouteParams&)>;
+
+// Handler asincron: răspunsul se trimite mai târziu prin ResponseCompletion
+using AsyncRouteHandler = std::function<void(const HttpRequest&, const RouteParams&, ResponseCompletion)>;
+
+// Rezultatul unei rute SSE: canalul la care se abonează clientul
+struct SseSubscription {
+    std::shared_ptr<SseChannel> channel;  // nullptr = fără stream (rejection sau 404)
+    std::string extra_headers;            // Linii "Nume: valoare\r\n" (ex. CORS)
+    std::string rejection;                // Răspuns HTTP complet trimis în loc de stream
+};
+
+using SseRouteHandler = std::function<SseSubscription(const HttpRequest&, const RouteParams&)>;
+
+// Handler cu corp citit incremental: request.body e gol, fragmentele vin din BodyReader.
+// Reader-ul e valid doar pe durata apelului; răspunsul poate veni și mai târziu
+using StreamingRouteHandler = std::function<void(const HttpRequest&, const RouteParams&,
+                                                 BodyReader&, ResponseCompletion)>;
+
+// Regula prefixelor de rută (middleware, pool-uri, rate limit, limite de
+// concurență): "/admin" acoperă "/admin" și "/admin/...", dar nu "/administrators".
+// Prefixul gol acoperă tot.
+bool path_under_prefix(std::string_view path, std::string_view prefix);
 
 struct Route {
     std::string method;
     std::string pattern;  // ex: "/api/users/:id"
     RouteHandler handler;
+    AsyncRouteHandler async_handler;  // setat doar pentru rute asincrone
+    std::shared_ptr<const WebSocketRoute> websocket;  // setat doar pentru rute WebSocket
+    SseRouteHandler sse;              // setat doar pentru rute SSE
+    StreamingRouteHandler streaming;  // setat doar pentru rute cu corp în flux
+    std::vector<std::string> param_names;  // Numele parametrilor, în ordinea din pattern
+    int pool = -1;                    // Pool-ul handler-ului (Worker::thread_pools()); -1 = cel implicit
+    uint32_t deadline_ms = 0;         // Termenul cererii, de la sosire; 0 = fără
+};
+
+// Tabel de rute fixat la compilare (ex. RestAPI::RouteTable): un singur apel virtual
+// per cerere, handler-ul rutei e apelat direct. Consultat după arborele dinamic.
+class StaticRouteTable {
+public:
+    virtual ~StaticRouteTable() = default;
+
+    // false = nicio rută în tabel; altfel răspunsul a fost dat prin completion
+    virtual bool dispatch(const HttpRequest& request, ResponseCompletion& completion) const = 0;
 };
 
+// Rutare: un arbore radix comprimat per metodă HTTP.
+// Segmentele statice sunt muchii etichetate (prefixe comune comasate), iar ":param"
+// e o muchie wildcard care acceptă exact un segment nevid.
+// Precedență la fiecare nivel: segmentul static înaintea parametrului, cu revenire
+// (dacă ramura statică nu duce la o rută, se încearcă parametrul). Ex: pentru
+// "/users/me" și "/users/:id", "/users/me" câștigă indiferent de ordinea înregistrării.
+// Același pattern înregistrat de două ori: rămâne primul.
 class Router {
 private:
+    struct Node {
+        std::string label;          // Text static (comprimat), ex. "/api/users/"
+        std::vector<int> children;  // Copii statici; etichetele diferă prin primul caracter
+        int param_child = -1;       // Muchia ":param"
+        int route = -1;             // Index în routes pentru ruta care se termină aici
+    };
+
+    struct MethodTree {
+        std::string method;
+        int root;
+    };
+
     std::vector<Route> routes;
-    
-    // Helper pentru a verifica dacă un pattern match cu un path
-    bool matchPattern(const std::string& pattern, const std::string& path, 
-                     std::map<std::string, std::string>& params);
-    
-    // Helper pentru a splita path-ul în segmente
-    std::vector<std::string> splitPath(const std::string& path);
+    std::vector<Node> nodes_;         // Indici, nu pointeri: Router se copiază (Server, Master)
+    std::vector<MethodTree> trees_;
+    std::vector<std::shared_ptr<const StaticRouteTable>> static_tables_;
+    RouteStats* stats_ = nullptr;     // Shared memory, creată de Master înainte de fork
+
+    // Înregistrează ruta în arborele metodei ei
+    void insertRoute(size_t route_index);
+    int matchNode(int node, std::string_view rest, RouteParams& params) const;
+
+    // Încearcă tabelele statice (false dacă niciunul nu are ruta)
+    bool dispatchStatic(const HttpRequest& request, ResponseCompletion& completion) const;
+
+    // Handler-ul unei rute cu corp în flux
+    void dispatchStreaming(const HttpRequest& request, const Route* route, const RouteParams& params,
+                           BodyReader& body, ResponseCompletion& completion);
 
 public:
     Router() = default;
     
     // Adaugă o rută
     void addRoute(const std::string& method, const std::string& pattern, RouteHandler handler);
+
+    // Adaugă o rută asincronă
+    void addAsyncRoute(const std::string& method, const std::string& pattern, AsyncRouteHandler handler);
+
+    // Adaugă un endpoint WebSocket (GET + Upgrade)
+    void addWebSocketRoute(const std::string& pattern, std::shared_ptr<const WebSocketRoute> route);
+
+    // Adaugă un endpoint Server-Sent Events (GET)
+    void addSseRoute(const std::string& pattern, SseRouteHandler handler);
+
+    // Adaugă o rută care primește corpul în fragmente (upload-uri mari)
+    void addStreamingRoute(const std::string& method, const std::string& pattern, StreamingRouteHandler handler);
+
+    // Adaugă un tabel de rute fixat la compilare
+    void addStaticTable(std::shared_ptr<const StaticRouteTable> table);
+
+    // Caută ruta potrivită și completează parametrii (nullptr dacă nu există)
+    const Route* findRoute(const HttpRequest& request, RouteParams& params);
+
+    // La fel, fără log
+    const Route* match(const std::string& method, std::string_view path, RouteParams& params) const;
     
+    // ===== Statistici per rută =====
+
+    // nullptr = dezactivate; altfel un rând per rută în RouteStats (același index ca routes)
+    void setStats(RouteStats* stats) { stats_ = stats; }
+    RouteStats* stats() const { return stats_; }
+
+    size_t routeCount() const { return routes.size(); }
+    const Route& routeAt(size_t index) const { return routes[index]; }
+
+    // Rulează handler-ul rutei în pool-ul cu indexul dat (Worker::thread_pools()).
+    // Se setează înainte ca Router-ul să fie copiat în Server
+    void setRoutePool(size_t index, int pool) { routes[index].pool = pool; }
+
+    // Termenul rutei (ms de la sosirea cererii); la fel, înainte de copiere
+    void setRouteDeadline(size_t index, uint32_t ms) { routes[index].deadline_ms = ms; }
+
+    // Indexul unei rute întoarse de findRoute/match (pentru tabele paralele cu routes)
+    size_t routeIndex(const Route* route) const { return static_cast<size_t>(route - routes.data()); }
+
+    // Cerere terminată: status și octeți din răspunsul raw, latența de la start.
+    // route = nullptr pentru cererile fără rută dinamică (tabele statice, 404)
+    void recordRequest(const Route* route, const std::string& response,
+                       std::chrono::steady_clock::time_point start, uint64_t bytes_in) const;
+
     // Găsește și execută handler-ul pentru o cerere
+    // (pentru rute asincrone blochează până la completare)
     std::string handle(const HttpRequest& request);
+
+    // Execută handler-ul; răspunsul ajunge prin completion (sync sau async)
+    void dispatch(const HttpRequest& request, ResponseCompletion completion);
+
+    // La fel, pentru o rută deja căutată cu findRoute (route poate fi nullptr)
+    void dispatch(const HttpRequest& request, const Route* route,
+                  const RouteParams& params, ResponseCompletion completion);
+
+    // Cu corpul de pe socket: rutele obișnuite îl primesc întreg în request.body
+    // (citit pe loc, fără copia cererii), cele cu corp în flux îl citesc din body
+    void dispatch(HttpRequest& request, const Route* route,
+                  const RouteParams& params, BodyReader& body,
+                  ResponseCompletion completion);
     
     // Helper shortcuts pentru metode HTTP
     void get(const std::string& pattern, RouteHandler handler) {
@@ -0,0 +1,100 @@
+#pragma once
+#include "ipc/sharedmemory.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Statistici per rută: cereri, clase de status, octeți, histogramă de latență.
+// Fiecare worker scrie doar în rândul lui din shared memory (atomice relaxed,
+// fără lock-uri); citirea adună rândurile tuturor worker-ilor.
+
+// Histogramă log-liniară (stil HDR), în microsecunde: 8 sub-bucket-uri pe
+// fiecare putere a lui 2, deci eroare relativă sub 12.5% pe tot intervalul
+struct LatencyHistogram {
+    static constexpr int SUB_BUCKETS = 8;
+    static constexpr int SUB_BITS = 3;
+    static constexpr int MAX_EXPONENT = 31;   // Peste 2^32 us (~71 min) intră în ultimul bucket
+    static constexpr int BUCKETS = SUB_BUCKETS + (MAX_EXPONENT - SUB_BITS + 1) * SUB_BUCKETS;
+
+    static int bucket_for(uint64_t us) {
+        if (us < SUB_BUCKETS) return static_cast<int>(us);
+        int exponent = 63 - __builtin_clzll(us);
+        if (exponent > MAX_EXPONENT) return BUCKETS - 1;
+        int sub = static_cast<int>((us >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1));
+        return SUB_BUCKETS + (exponent - SUB_BITS) * SUB_BUCKETS + sub;
+    }
+
+    // Cea mai mare valoare care cade în bucket
+    static uint64_t bucket_upper(int index) {
+        if (index < SUB_BUCKETS) return static_cast<uint64_t>(index);
+        int exponent = (index - SUB_BUCKETS) / SUB_BUCKETS + SUB_BITS;
+        uint64_t sub = static_cast<uint64_t>((index - SUB_BUCKETS) % SUB_BUCKETS);
+        uint64_t width = 1ULL << (exponent - SUB_BITS);
+        return ((SUB_BUCKETS + sub) << (exponent - SUB_BITS)) + width - 1;
+    }
+};
+
+// Un rând (rută x worker) în shared memory
+// Numărul de cereri nu are contor propriu: e suma histogramei (un fetch_add mai puțin)
+struct alignas(64) RouteCounters {
+    std::atomic<uint64_t> status[5];          // 1xx .. 5xx
+    std::atomic<uint64_t> bytes_in;
+    std::atomic<uint64_t> bytes_out;
+    std::atomic<uint64_t> latency_sum_us;
+    std::atomic<uint64_t> histogram[LatencyHistogram::BUCKETS];
+};
+
+// Valori adunate peste toți worker-ii
+struct RouteStatsSnapshot {
+    uint64_t requests = 0;
+    uint64_t status[5] = {0, 0, 0, 0, 0};
+    uint64_t bytes_in = 0;
+    uint64_t bytes_out = 0;
+    uint64_t latency_sum_us = 0;
+    uint64_t histogram[LatencyHistogram::BUCKETS] = {};
+
+    // Latența sub care se află fracțiunea q (0..1) din cereri (limita de sus a bucket-ului)
+    uint64_t percentile_us(double q) const;
+    uint64_t max_us() const;
+    double mean_us() const { return requests ? static_cast<double>(latency_sum_us) / requests : 0.0; }
+};
+
+class RouteStats {
+public:
+    // Creată de Master înainte de fork; un rând în plus (OTHER) pentru cererile
+    // fără rută dinamică (tabele statice, 404)
+    RouteStats(size_t route_count, int worker_count);
+    ~RouteStats();
+
+    RouteStats(const RouteStats&) = delete;
+    RouteStats& operator=(const RouteStats&) = delete;
+
+    // În procesul worker, după fork și înainte de primele cereri
+    void set_worker(int worker) { worker_ = (worker >= 0 && worker < worker_count_) ? worker : 0; }
+
+    // route = indexul din Router::routes, sau other()
+    void record(size_t route, int status, uint64_t latency_us, uint64_t bytes_in, uint64_t bytes_out) {
+        RouteCounters& row = rows_[static_cast<size_t>(worker_) * stride_ + (route < route_count_ ? route : route_count_)];
+        unsigned cls = static_cast<unsigned>(status / 100 - 1);
+        if (cls < 5) row.status[cls].fetch_add(1, std::memory_order_relaxed);
+        row.bytes_in.fetch_add(bytes_in, std::memory_order_relaxed);
+        row.bytes_out.fetch_add(bytes_out, std::memory_order_relaxed);
+        row.latency_sum_us.fetch_add(latency_us, std::memory_order_relaxed);
+        row.histogram[LatencyHistogram::bucket_for(latency_us)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Suma peste worker-i; fără lock, valorile pot fi cu câteva cereri în urmă
+    RouteStatsSnapshot snapshot(size_t route) const;
+
+    size_t route_count() const { return route_count_; }
+    size_t other() const { return route_count_; }
+    int worker_count() const { return worker_count_; }
+
+private:
+    SharedMemory* shm_;
+    RouteCounters* rows_;
+    size_t route_count_;
+    size_t stride_;          // route_count_ + 1
+    int worker_count_;
+    int worker_ = 0;
+};
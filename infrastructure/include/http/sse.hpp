@@ -0,0 +1,116 @@
+#pragma once
+#include "http/request.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Server-Sent Events: un canal serializează fiecare eveniment o singură dată,
+// iar buffer-ul (ref-counted) e scris direct pe socket-ul fiecărui abonat.
+// Canalele trăiesc în procesul worker-ului; I/O rulează pe EventLoop.
+
+// Eveniment serializat ("id: ..\nevent: ..\ndata: ..\n\n"), partajat de abonați
+using SseEvent = std::shared_ptr<const std::string>;
+
+struct SseOptions {
+    size_t replay_capacity = 256;             // Evenimente păstrate pentru Last-Event-ID
+    size_t max_queued_bytes = 1024 * 1024;    // Per abonat; peste = abonat lent, deconectat
+    std::chrono::seconds heartbeat{15};       // Comentariu keep-alive când nu sunt evenimente (0 = off)
+    int retry_ms = 3000;                      // Sugestia de reconectare pentru EventSource
+};
+
+class SseChannel;
+
+class SseSubscriber : public std::enable_shared_from_this<SseSubscriber> {
+public:
+    SseSubscriber(int fd, std::weak_ptr<SseChannel> channel, size_t max_queued_bytes,
+                  std::function<void()> on_done);
+    ~SseSubscriber();
+
+    SseSubscriber(const SseSubscriber&) = delete;
+    SseSubscriber& operator=(const SseSubscriber&) = delete;
+
+    // Pune evenimentul în coada abonatului (thread-safe).
+    // false = coada ar depăși limita: abonatul e evacuat
+    bool push(const SseEvent& event);
+
+    // Închide conexiunea (thread-safe)
+    void close();
+
+    bool is_open() const { return open_; }
+    size_t queued_bytes() const { return queued_bytes_.load(); }
+
+private:
+    friend class SseChannel;
+
+    int fd_;
+    std::weak_ptr<SseChannel> channel_;
+    size_t max_queued_bytes_;
+    std::function<void()> on_done_;
+    std::atomic<bool> open_{true};
+
+    std::mutex mutex_;
+    std::deque<SseEvent> queue_;
+    size_t front_offset_ = 0;                 // Octeți deja trimiși din queue_.front()
+    std::atomic<size_t> queued_bytes_{0};
+    bool flush_scheduled_ = false;
+    std::chrono::steady_clock::time_point last_write_;
+
+    bool enqueue(const SseEvent& event, bool& need_flush);
+    void schedule_flush();
+    void flush();
+    void rearm(bool want_write);
+    void on_events(uint32_t events);
+    void finish();
+    void schedule_heartbeat(std::chrono::seconds interval);
+};
+
+class SseChannel : public std::enable_shared_from_this<SseChannel> {
+public:
+    explicit SseChannel(const SseOptions& options = SseOptions());
+    ~SseChannel();
+
+    // Serializează evenimentul o dată și îl trimite tuturor abonaților; returnează id-ul
+    uint64_t publish(const std::string& data, const std::string& event = "");
+
+    // Preia socket-ul: trimite headerele, reluarea după Last-Event-ID, apoi evenimentele noi.
+    // extra_headers: linii "Nume: valoare\r\n" adăugate răspunsului (ex. CORS)
+    void subscribe(int fd, const HttpRequest& request, std::function<void()> on_done,
+                   const std::string& extra_headers = "");
+
+    // Închide toți abonații (ex. la shutdown)
+    void close_all();
+
+    // Închide abonații tuturor canalelor din proces (drain);
+    // clienții EventSource se reconectează și reiau de la Last-Event-ID
+    static void close_all_channels();
+
+    size_t subscriber_count() const;
+    uint64_t evicted_count() const { return evicted_.load(); }
+    uint64_t last_event_id() const;
+
+    const SseOptions& options() const { return options_; }
+
+private:
+    friend class SseSubscriber;
+
+    SseOptions options_;
+
+    mutable std::mutex mutex_;
+    std::deque<std::pair<uint64_t, SseEvent>> ring_;   // Ultimele replay_capacity evenimente
+    uint64_t next_id_ = 1;
+    std::vector<std::shared_ptr<SseSubscriber>> subscribers_;
+    std::atomic<uint64_t> evicted_{0};
+
+    void remove(const SseSubscriber* subscriber);
+};
+
+namespace SseProtocol {
+    // "id: N\nevent: E\ndata: linia1\ndata: linia2\n\n"
+    std::string format_event(uint64_t id, const std::string& event, const std::string& data);
+}
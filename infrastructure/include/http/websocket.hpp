@@ -0,0 +1,150 @@
+#pragma once
+#include "http/request.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// WebSocket (RFC 6455) peste conexiuni long-lived gestionate de EventLoop-ul worker-ului.
+// Tot I/O-ul pe socket rulează pe thread-ul loop-ului; send_*() e thread-safe.
+
+class RouteParams;  // http/router.hpp
+class WebSocketConnection;
+using WebSocketPtr = std::shared_ptr<WebSocketConnection>;
+
+// Opcodes RFC 6455
+enum class WebSocketOpcode : uint8_t {
+    CONTINUATION = 0x0,
+    TEXT = 0x1,
+    BINARY = 0x2,
+    CLOSE = 0x8,
+    PING = 0x9,
+    PONG = 0xA
+};
+
+// Coduri de închidere folosite de server
+namespace WebSocketClose {
+    constexpr uint16_t NORMAL = 1000;
+    constexpr uint16_t GOING_AWAY = 1001;
+    constexpr uint16_t PROTOCOL_ERROR = 1002;
+    constexpr uint16_t INVALID_DATA = 1007;
+    constexpr uint16_t POLICY = 1008;
+    constexpr uint16_t TOO_BIG = 1009;
+    constexpr uint16_t NO_STATUS = 1005;
+    constexpr uint16_t ABNORMAL = 1006;
+}
+
+struct WebSocketOptions {
+    size_t max_message_size = 1024 * 1024;   // Mesaj reasamblat (toate fragmentele)
+    size_t high_water_mark = 1024 * 1024;    // Peste: send() raportează backpressure, citirea e pusă pe pauză
+    size_t low_water_mark = 256 * 1024;      // Sub: on_drain, citirea se reia
+    size_t max_buffered = 8 * 1024 * 1024;   // Peste: conexiunea e închisă (client prea lent)
+    std::chrono::seconds ping_interval{30};  // 0 = fără ping-uri de la server
+};
+
+struct WebSocketHandlers {
+    std::function<void(const WebSocketPtr&, const HttpRequest&, const RouteParams&)> on_open;
+    std::function<void(const WebSocketPtr&, const std::string& message, bool binary)> on_message;
+    std::function<void(const WebSocketPtr&, uint16_t code)> on_close;
+    std::function<void(const WebSocketPtr&)> on_drain;
+};
+
+struct WebSocketRoute {
+    WebSocketHandlers handlers;
+    WebSocketOptions options;
+};
+
+namespace WebSocketProtocol {
+    // Este o cerere de upgrade la WebSocket?
+    bool is_upgrade_request(const HttpRequest& req);
+
+    // Sec-WebSocket-Accept = base64(SHA1(key + GUID))
+    std::string accept_key(const std::string& client_key);
+
+    // Răspunsul 101 (sau 400/426 dacă handshake-ul nu e valid)
+    bool build_handshake_response(const HttpRequest& req, std::string& response);
+
+    // Frame de la server (nemascat)
+    std::string encode_frame(WebSocketOpcode opcode, const std::string& payload, bool fin = true);
+
+    // Validare UTF-8 pentru mesaje TEXT și motivul din frame-urile CLOSE
+    bool is_valid_utf8(const std::string& data);
+
+    // Cod pe care clientul îl poate trimite într-un CLOSE: 1000-1003, 1007-1014
+    // sau 3000-4999. 1005, 1006 și 1015 nu apar niciodată pe fir
+    bool is_valid_close_code(uint16_t code);
+}
+
+class WebSocketConnection : public std::enable_shared_from_this<WebSocketConnection> {
+public:
+    WebSocketConnection(int fd, std::shared_ptr<const WebSocketRoute> route, std::function<void()> on_done);
+    ~WebSocketConnection();
+
+    WebSocketConnection(const WebSocketConnection&) = delete;
+    WebSocketConnection& operator=(const WebSocketConnection&) = delete;
+
+    // Preia socket-ul după handshake; request.body = octeți deja citiți după headere
+    static WebSocketPtr accept(int fd, std::shared_ptr<const WebSocketRoute> route,
+                               const HttpRequest& request, const RouteParams& params,
+                               std::function<void()> on_done);
+
+    // Thread-safe; false = backpressure (buffer peste high_water_mark) sau conexiune închisă
+    bool send_text(const std::string& message);
+    bool send_binary(const std::string& data);
+    bool ping(const std::string& payload = "");
+
+    // Close handshake inițiat de server
+    void close(uint16_t code = WebSocketClose::NORMAL, const std::string& reason = "");
+
+    // Închide toate conexiunile deschise din proces (ex. drain la shutdown)
+    static void close_all(uint16_t code = WebSocketClose::GOING_AWAY, const std::string& reason = "");
+
+    bool is_open() const { return state_ == State::OPEN; }
+    size_t buffered_amount() const { return buffered_.load(); }
+    uint64_t id() const { return id_; }
+    int fd() const { return fd_; }
+
+    // Date utilizator atașate conexiunii (ex. sensor_id)
+    std::shared_ptr<void> user_data;
+
+private:
+    enum class State { OPEN, CLOSING, CLOSED };
+
+    int fd_;
+    uint64_t id_;
+    std::shared_ptr<const WebSocketRoute> route_;
+    std::function<void()> on_done_;
+    std::atomic<State> state_{State::OPEN};
+
+    // Input (doar pe thread-ul loop-ului)
+    std::string in_buf_;
+    std::string message_;            // Mesaj fragmentat în curs de reasamblare
+    WebSocketOpcode message_opcode_ = WebSocketOpcode::CONTINUATION;
+    bool reading_paused_ = false;
+    std::chrono::steady_clock::time_point last_activity_;
+
+    // Output (protejat de out_mutex_)
+    std::mutex out_mutex_;
+    std::string out_buf_;
+    std::atomic<size_t> buffered_{0};
+    bool flush_scheduled_ = false;
+    bool close_after_flush_ = false;
+    bool drain_pending_ = false;
+    uint16_t close_code_ = WebSocketClose::NORMAL;
+
+    bool enqueue(const std::string& frame, bool control);
+    void schedule_flush();
+    void on_events(uint32_t events);
+    void read_available();
+    void process_frames();
+    void handle_frame(WebSocketOpcode opcode, bool fin, std::string payload);
+    void flush();
+    void rearm();
+    void fail(uint16_t code, const std::string& reason);
+    void finish(uint16_t code);
+    void schedule_ping();
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include "core/peeraddress.hpp"
+
+#include <cstdint>
+
+// Transfer de file descriptors între procese (SCM_RIGHTS peste AF_UNIX).
+// Un număr de fd nu are sens în alt proces: conexiunea acceptată de Master
+// trebuie trimisă worker-ului prin kernel, care o duplică în procesul lui.
+// Socket-ul e SOCK_DGRAM: fiecare mesaj e primit de exact un worker.
+class FdChannel {
+public:
+    FdChannel();
+    ~FdChannel();
+
+    FdChannel(const FdChannel&) = delete;
+    FdChannel& operator=(const FdChannel&) = delete;
+
+    // socketpair; apelat de Master înainte de fork
+    void create();
+
+    // Master: trimite fd (non-blocking); tag = informație asociată (ex. listener),
+    // stamp = momentul acceptării (Trace::now_ns, 0 = netrasat),
+    // peer = adresa clientului de la accept() (nullptr = necunoscută)
+    // false = canal plin (workers saturați) sau eroare
+    bool send(int fd, uint32_t tag, int64_t stamp = 0, const PeerAddress* peer = nullptr);
+
+    // Worker: așteaptă cel mult timeout_ms; returnează fd-ul primit sau -1
+    int receive(uint32_t& tag, int timeout_ms, int64_t* stamp = nullptr, PeerAddress* peer = nullptr);
+
+    // În worker, capătul de trimitere nu mai e necesar
+    void close_sender();
+    void close();
+
+private:
+    // Datele care însoțesc fd-ul
+    struct Message {
+        uint32_t tag;
+        int64_t stamp;
+        PeerAddress peer;
+    };
+
+    int send_fd_;
+    int recv_fd_;
+};
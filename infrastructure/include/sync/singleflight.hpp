@@ -0,0 +1,40 @@
+#pragma once
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Single-flight: cereri concurente cu aceeași cheie nu repetă calculul.
+// Primul apelant (leader) rulează funcția; ceilalți așteaptă și primesc
+// același rezultat (sau aceeași excepție). După terminare cheia e liberă,
+// următorul apel calculează din nou. Valabil în interiorul unui proces.
+class SingleFlight {
+public:
+    SingleFlight() = default;
+
+    SingleFlight(const SingleFlight&) = delete;
+    SingleFlight& operator=(const SingleFlight&) = delete;
+
+    // shared (opțional) = true dacă rezultatul a venit din calculul altui thread
+    std::string run(const std::string& key, const std::function<std::string()>& compute,
+                    bool* shared = nullptr);
+
+    // Chei aflate acum în calcul
+    size_t in_flight() const;
+
+private:
+    struct Call {
+        std::mutex mutex;
+        std::condition_variable done_cv;
+        bool done = false;
+        std::string result;
+        std::exception_ptr error;
+        size_t waiters = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Call>> calls_;
+};
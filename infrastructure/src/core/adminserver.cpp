@@ -0,0 +1,266 @@
+#include "core/adminserver.hpp"
+#include "core/master.hpp"
+#include "core/healthcheck.hpp"
+#include "core/listener.hpp"
+#include "http/metrics.hpp"
+#include "core/worker.hpp"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+static const char* status_text(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 503: return "Service Unavailable";
+        default:  return "Unknown";
+    }
+}
+
+static std::string build_response(int status, const char* content_type, const std::string& body, bool head) {
+    std::ostringstream res;
+    res << "HTTP/1.1 " << status << " " << status_text(status) << "\r\n";
+    res << "Content-Type: " << content_type << "\r\n";
+    res << "Content-Length: " << body.size() << "\r\n";
+    res << "Cache-Control: no-store\r\n";
+    res << "Connection: close\r\n";
+    res << "\r\n";
+    if (!head) res << body;
+    return res.str();
+}
+
+static std::string json_escape(const std::string& value) {
+    std::string out;
+    for (char c : value) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+static const char* health_name(HealthStatus status) {
+    switch (status) {
+        case HealthStatus::HEALTHY:  return "healthy";
+        case HealthStatus::DEGRADED: return "degraded";
+        default:                     return "unhealthy";
+    }
+}
+
+AdminServer::AdminServer(const AdminConfig& config, const GlobalStats* stats, const RouteStats* routes,
+                         const Router* router, HealthCheck* health)
+    : config_(config), stats_(stats), routes_(routes), router_(router), health_(health) {}
+
+AdminServer::~AdminServer() {
+    stop();
+}
+
+void AdminServer::open() {
+    if (listen_fd_ >= 0) return;
+    listen_fd_ = Listener::open(ListenerConfig::tcp(config_.port, config_.host));
+    fcntl(listen_fd_, F_SETFD, FD_CLOEXEC);
+}
+
+void AdminServer::start() {
+    if (listen_fd_ < 0 || running_.exchange(true)) return;
+
+    if (health_ && health_->check_count() > 0) {
+        health_->start_periodic_checks(config_.check_interval);
+    }
+
+    thread_ = std::thread([this]() { run(); });
+    std::cout << "[Admin] Listening on " << config_.host << ":" << config_.port << " ("
+              << config_.health_path << ", " << config_.ready_path << ", " << config_.metrics_path << ")\n";
+}
+
+void AdminServer::stop() {
+    if (running_.exchange(false)) {
+        if (thread_.joinable()) thread_.join();
+        if (health_) health_->stop_periodic_checks();
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+    }
+}
+
+void AdminServer::close_in_child() {
+    // Thread-urile nu supraviețuiesc fork-ului; rămâne doar fd-ul
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+    }
+}
+
+void AdminServer::run() {
+    while (running_) {
+        struct pollfd pfd;
+        pfd.fd = listen_fd_;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        int ready = poll(&pfd, 1, 200);
+        if (ready <= 0) continue;
+
+        // Conexiunile se servesc pe rând: răspunsurile sunt mici și gata calculate
+        while (running_) {
+            int client_fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client_fd < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    perror("[Admin] accept");
+                }
+                break;
+            }
+            handle(client_fd);
+            close(client_fd);
+        }
+    }
+}
+
+void AdminServer::handle(int client_fd) {
+    // Un client lent nu poate ține thread-ul ocupat mai mult de o secundă
+    struct timeval timeout;
+    timeout.tv_sec = 1;
+    timeout.tv_usec = 0;
+    setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(client_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    std::string request;
+    char buf[2048];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+        ssize_t n = recv(client_fd, buf, sizeof(buf), 0);
+        if (n <= 0) break;
+        request.append(buf, static_cast<size_t>(n));
+    }
+
+    size_t line_end = request.find("\r\n");
+    if (line_end == std::string::npos) return;
+
+    // "GET /readyz HTTP/1.1"
+    std::string line = request.substr(0, line_end);
+    size_t sp1 = line.find(' ');
+    size_t sp2 = sp1 == std::string::npos ? std::string::npos : line.find(' ', sp1 + 1);
+    if (sp2 == std::string::npos) return;
+
+    std::string method = line.substr(0, sp1);
+    std::string path = line.substr(sp1 + 1, sp2 - sp1 - 1);
+    size_t query = path.find('?');
+    if (query != std::string::npos) path.resize(query);
+
+    std::string response = respond(method, path);
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t n = send(client_fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) break;
+        sent += static_cast<size_t>(n);
+    }
+}
+
+std::string AdminServer::respond(const std::string& method, const std::string& path) {
+    bool head = method == "HEAD";
+    if (method != "GET" && !head) {
+        return build_response(405, "application/json", R"({"error":"Method Not Allowed"})", head);
+    }
+
+    if (path == config_.health_path) {
+        return build_response(200, "application/json", R"({"status":"alive"})", head);
+    }
+
+    if (path == config_.ready_path) {
+        bool ready = false;
+        std::string body = readiness(ready);
+        return build_response(ready ? 200 : 503, "application/json", body, head);
+    }
+
+    if (path == config_.metrics_path) {
+        MetricsWriter out;
+        if (stats_) Metrics::write_server(out, *stats_);
+        if (stats_) Metrics::write_thread_pools(out, *stats_);
+        if (stats_ && Worker::concurrency_limiter()) {
+            Metrics::write_concurrency_limits(out, *stats_, *Worker::concurrency_limiter());
+        }
+        if (routes_ && router_) Metrics::write_routes(out, *routes_, *router_);
+
+        bool ready = false;
+        readiness(ready);
+        out.family("rest_api_ready", "1 when the admin readiness probe answers 200", "gauge");
+        out.sample("rest_api_ready", {}, static_cast<int64_t>(ready ? 1 : 0));
+
+        if (health_ && health_->check_count() > 0) {
+            auto results = health_->last_results();
+            out.family("rest_api_health_check_healthy", "1 when the component's last check was healthy", "gauge");
+            for (const auto& r : results) {
+                out.sample("rest_api_health_check_healthy", {{"component", r.component}},
+                           static_cast<int64_t>(r.status == HealthStatus::HEALTHY ? 1 : 0));
+            }
+            out.family("rest_api_health_check_duration_seconds", "Duration of the component's last check", "gauge");
+            for (const auto& r : results) {
+                out.sample("rest_api_health_check_duration_seconds", {{"component", r.component}},
+                           static_cast<double>(r.response_time.count()) / 1e3);
+            }
+        }
+        return build_response(200, MetricsWriter::CONTENT_TYPE, out.str(), head);
+    }
+
+    return build_response(404, "application/json", R"({"error":"Not Found"})", head);
+}
+
+std::string AdminServer::readiness(bool& ready) {
+    int configured = 0;
+    int alive = 0;
+    bool worker_draining = false;
+    if (stats_) {
+        configured = stats_->num_workers.load(std::memory_order_relaxed);
+        if (configured > MAX_WORKERS) configured = MAX_WORKERS;
+        for (int i = 0; i < configured; i++) {
+            int status = stats_->workers[i].status.load(std::memory_order_relaxed);
+            if (status != 0) alive++;
+            if (status == 3) worker_draining = true;
+        }
+    }
+
+    bool draining = draining_ || worker_draining;
+    ready = alive == configured && !draining;
+
+    std::ostringstream checks;
+    if (health_ && health_->check_count() > 0) {
+        auto results = health_->last_results();
+        if (results.empty()) ready = false;  // Prima rundă de check-uri nu s-a terminat
+        bool first = true;
+        for (const auto& r : results) {
+            if (r.status == HealthStatus::UNHEALTHY) ready = false;
+            if (!first) checks << ",";
+            first = false;
+            checks << "{\"component\":\"" << json_escape(r.component) << "\",\"status\":\"" << health_name(r.status)
+                   << "\",\"message\":\"" << json_escape(r.message) << "\",\"response_time_ms\":"
+                   << r.response_time.count() << "}";
+        }
+    }
+
+    std::ostringstream body;
+    body << "{\"status\":\"" << (ready ? "ready" : "not ready") << "\""
+         << ",\"draining\":" << (draining ? "true" : "false")
+         << ",\"workers\":{\"configured\":" << configured << ",\"alive\":" << alive << "}"
+         << ",\"checks\":[" << checks.str() << "]}";
+    return body.str();
+}
@@ -0,0 +1,50 @@
+#include "core/cancellation.hpp"
+
+CancellationState::CancellationState(Clock::time_point deadline)
+    : deadline_(deadline) {}
+
+CancelReason CancellationState::reason() const {
+    CancelReason reason = reason_.load(std::memory_order_acquire);
+    if (reason != CancelReason::None) return reason;
+    if (has_deadline() && Clock::now() >= deadline_) return CancelReason::Deadline;
+    return CancelReason::None;
+}
+
+std::chrono::milliseconds CancellationState::remaining() const {
+    if (!has_deadline()) return std::chrono::milliseconds::max();
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline_ - Clock::now());
+    return left.count() > 0 ? left : std::chrono::milliseconds(0);
+}
+
+void CancellationState::cancel(CancelReason reason) {
+    if (reason == CancelReason::None) return;
+
+    std::lock_guard<std::mutex> lock(m_);
+    CancelReason expected = CancelReason::None;
+    if (!reason_.compare_exchange_strong(expected, reason, std::memory_order_acq_rel)) return;
+
+    for (auto& entry : callbacks_) {
+        entry.second();
+    }
+    callbacks_.clear();
+}
+
+uint64_t CancellationState::on_cancel(std::function<void()> callback) {
+    std::lock_guard<std::mutex> lock(m_);
+    // Un termen trecut contează deja ca anulare, chiar dacă timer-ul nu a ajuns încă
+    if (cancelled()) return 0;
+
+    uint64_t id = next_id_++;
+    callbacks_.emplace_back(id, std::move(callback));
+    return id;
+}
+
+void CancellationState::remove(uint64_t id) {
+    std::lock_guard<std::mutex> lock(m_);
+    for (size_t i = 0; i < callbacks_.size(); i++) {
+        if (callbacks_[i].first == id) {
+            callbacks_.erase(callbacks_.begin() + static_cast<long>(i));
+            return;
+        }
+    }
+}
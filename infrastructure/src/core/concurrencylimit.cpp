@@ -0,0 +1,189 @@
+#include "core/concurrencylimit.hpp"
+#include "http/router.hpp"
+#include "http/request.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Ponderea unui eșantion nou în media latenței (~ultimele 10 cereri)
+static constexpr double RTT_ALPHA = 0.1;
+
+ConcurrencyLimiter::ConcurrencyLimiter(std::vector<ConcurrencyLimitPolicy> policies)
+    : policies_(std::move(policies))
+{
+    if (policies_.size() > MAX_GROUPS) {
+        throw std::runtime_error("ConcurrencyLimiter: prea multe grupuri");
+    }
+    for (auto& policy : policies_) {
+        if (policy.min_limit < 1) policy.min_limit = 1;
+        if (policy.max_limit < policy.min_limit) policy.max_limit = policy.min_limit;
+        policy.initial_limit = std::clamp(policy.initial_limit, policy.min_limit, policy.max_limit);
+        if (policy.tolerance < 1.0) policy.tolerance = 1.0;
+        policy.smoothing = std::clamp(policy.smoothing, 0.01, 1.0);
+
+        auto group = std::make_unique<Group>();
+        group->limit = policy.initial_limit;
+        groups_.push_back(std::move(group));
+    }
+}
+
+int ConcurrencyLimiter::match_prefix(std::string_view path) const {
+    int best = -1;
+    size_t best_length = 0;
+    for (size_t i = 0; i < policies_.size(); i++) {
+        const std::string& prefix = policies_[i].prefix;
+        if (!path_under_prefix(path, prefix)) continue;
+        if (best < 0 || prefix.size() > best_length) {
+            best = static_cast<int>(i);
+            best_length = prefix.size();
+        }
+    }
+    return best;
+}
+
+void ConcurrencyLimiter::resolve(const Router& router) {
+    route_group_.assign(router.routeCount(), -1);
+    for (size_t i = 0; i < router.routeCount(); i++) {
+        route_group_[i] = match_prefix(router.routeAt(i).pattern);
+    }
+}
+
+int ConcurrencyLimiter::group_for(const Router& router, const Route* route, const HttpRequest& request) const {
+    if (route) {
+        size_t index = router.routeIndex(route);
+        if (index < route_group_.size()) return route_group_[index];
+    }
+    return match_prefix(request.path);
+}
+
+bool ConcurrencyLimiter::acquire(int index, bool* waited) {
+    Group& group = *groups_[static_cast<size_t>(index)];
+    const ConcurrencyLimitPolicy& policy = policies_[static_cast<size_t>(index)];
+    if (waited) *waited = false;
+
+    std::unique_lock<std::mutex> lock(group.m);
+    auto has_room = [&group]() { return group.in_flight < static_cast<int>(group.limit); };
+
+    if (!has_room()) {
+        if (group.waiting >= static_cast<int>(policy.max_queue)) {
+            if (stats_) stats_[index].shed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        group.waiting++;
+        publish(index, group);
+        bool admitted = group.cv.wait_for(lock, policy.queue_timeout, has_room);
+        group.waiting--;
+        if (!admitted) {
+            publish(index, group);
+            if (stats_) stats_[index].shed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (waited) *waited = true;
+        if (stats_) stats_[index].queued.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    group.in_flight++;
+    publish(index, group);
+    if (stats_) stats_[index].admitted.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void ConcurrencyLimiter::release(int index, std::chrono::nanoseconds latency, bool sample) {
+    Group& group = *groups_[static_cast<size_t>(index)];
+    bool grew = false;
+    {
+        std::lock_guard<std::mutex> lock(group.m);
+        int in_flight = group.in_flight;
+        group.in_flight--;
+        if (sample && latency.count() > 0) {
+            double before = group.limit;
+            update(group, policies_[static_cast<size_t>(index)], latency.count(), in_flight);
+            grew = static_cast<int>(group.limit) > static_cast<int>(before);
+        }
+        publish(index, group);
+        if (group.waiting == 0) return;
+    }
+    // Un loc eliberat; mai multe dacă limita a crescut
+    if (grew) {
+        group.cv.notify_all();
+    } else {
+        group.cv.notify_one();
+    }
+}
+
+// Gradient: limita nouă = limita * (tolerance * RTT minim / RTT recent), între
+// 0.5 și 1, plus o rezervă de sqrt(limita) cereri care pot sta la coadă. Cu
+// latența aproape de minim gradientul e 1 și limita crește cu rezerva; sub
+// sarcină latența urcă și limita scade. Rezultatul se aplică netezit.
+void ConcurrencyLimiter::update(Group& group, const ConcurrencyLimitPolicy& policy, int64_t latency_ns,
+                                int in_flight) {
+    int64_t now = now_ns();
+    int64_t window = std::chrono::duration_cast<std::chrono::nanoseconds>(policy.rtt_window).count();
+
+    // RTT-ul minim se reînnoiește pe ferestre: dacă baza crește (ex. mai multe
+    // date), minimul vechi nu ține limita jos la nesfârșit
+    if (group.window_start_ns == 0 || now - group.window_start_ns > window) {
+        group.previous_min_ns = group.window_min_ns;
+        group.window_min_ns = 0;
+        group.window_start_ns = now;
+    }
+    if (group.window_min_ns == 0 || latency_ns < group.window_min_ns) {
+        group.window_min_ns = latency_ns;
+    }
+    int64_t min_rtt = group.window_min_ns;
+    if (group.previous_min_ns > 0 && group.previous_min_ns < min_rtt) {
+        min_rtt = group.previous_min_ns;
+    }
+
+    group.rtt_ns = group.rtt_ns == 0 ? static_cast<double>(latency_ns)
+                                     : group.rtt_ns + RTT_ALPHA * (static_cast<double>(latency_ns) - group.rtt_ns);
+
+    double gradient = std::clamp(policy.tolerance * static_cast<double>(min_rtt) / group.rtt_ns, 0.5, 1.0);
+
+    // Sub jumătate din limită folosită, latența bună nu spune nimic despre o limită mai mare
+    if (gradient >= 1.0 && in_flight * 2 < group.limit) return;
+
+    double target = group.limit * gradient + std::sqrt(group.limit);
+    double limit = group.limit * (1.0 - policy.smoothing) + target * policy.smoothing;
+    group.limit = std::clamp(limit, static_cast<double>(policy.min_limit), static_cast<double>(policy.max_limit));
+}
+
+void ConcurrencyLimiter::publish(int index, const Group& group) {
+    if (!stats_) return;
+    ConcurrencyStats& stats = stats_[index];
+    stats.limit.store(static_cast<int>(group.limit), std::memory_order_relaxed);
+    stats.in_flight.store(group.in_flight, std::memory_order_relaxed);
+    stats.waiting.store(group.waiting, std::memory_order_relaxed);
+    int64_t min_rtt = group.window_min_ns;
+    if (group.previous_min_ns > 0 && (min_rtt == 0 || group.previous_min_ns < min_rtt)) {
+        min_rtt = group.previous_min_ns;
+    }
+    stats.min_rtt_us.store(min_rtt / 1000, std::memory_order_relaxed);
+    stats.rtt_us.store(static_cast<int64_t>(group.rtt_ns / 1000), std::memory_order_relaxed);
+}
+
+void ConcurrencyLimiter::set_stats(ConcurrencyStats* stats) {
+    stats_ = stats;
+    if (!stats_) return;
+    for (size_t i = 0; i < groups_.size(); i++) {
+        Group& group = *groups_[i];
+        std::lock_guard<std::mutex> lock(group.m);
+        // Slotul poate fi al unui worker anterior cu același index
+        stats_[i].admitted.store(0, std::memory_order_relaxed);
+        stats_[i].queued.store(0, std::memory_order_relaxed);
+        stats_[i].shed.store(0, std::memory_order_relaxed);
+        publish(static_cast<int>(i), group);
+    }
+}
+
+int ConcurrencyLimiter::limit(int index) const {
+    Group& group = *groups_[static_cast<size_t>(index)];
+    std::lock_guard<std::mutex> lock(group.m);
+    return static_cast<int>(group.limit);
+}
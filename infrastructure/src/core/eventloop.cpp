@@ -0,0 +1,218 @@
+#include "core/eventloop.hpp"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+EventLoop::EventLoop() : epoll_fd_(-1), wake_fd_(-1) {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ == -1) {
+        throw std::runtime_error("Failed to create epoll instance for EventLoop");
+    }
+
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ == -1) {
+        close(epoll_fd_);
+        throw std::runtime_error("Failed to create eventfd for EventLoop");
+    }
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = wake_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+}
+
+EventLoop::~EventLoop() {
+    stop();
+    if (wake_fd_ >= 0) close(wake_fd_);
+    if (epoll_fd_ >= 0) close(epoll_fd_);
+}
+
+EventLoop& EventLoop::instance() {
+    static std::mutex instance_mutex;
+    static std::unique_ptr<EventLoop> loop;
+    static pid_t owner = 0;
+
+    std::lock_guard<std::mutex> lock(instance_mutex);
+    if (!loop || owner != getpid()) {
+        // După fork thread-ul loop-ului nu mai există în copil:
+        // abandonăm instanța moștenită și creăm una nouă
+        if (loop && owner != getpid()) {
+            loop.release();
+        }
+        loop = std::make_unique<EventLoop>();
+        loop->start();
+        owner = getpid();
+    }
+    return *loop;
+}
+
+void EventLoop::start() {
+    if (running_.exchange(true)) {
+        return;  // Already running
+    }
+    thread_ = std::thread([this]() { loop(); });
+}
+
+void EventLoop::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    wakeup();
+    if (thread_.joinable()) {
+        if (thread_.get_id() == std::this_thread::get_id()) {
+            thread_.detach();
+        } else {
+            thread_.join();
+        }
+    }
+}
+
+bool EventLoop::in_loop_thread() const {
+    return thread_.get_id() == std::this_thread::get_id();
+}
+
+void EventLoop::post(Callback cb) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(std::move(cb));
+    }
+    wakeup();
+}
+
+void EventLoop::run_after(std::chrono::milliseconds delay, Callback cb) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timers_.push({std::chrono::steady_clock::now() + delay, timer_seq_++, std::move(cb)});
+    }
+    wakeup();
+}
+
+bool EventLoop::watch_once(int fd, uint32_t events, IoCallback cb) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    struct epoll_event ev;
+    ev.events = events | EPOLLONESHOT;
+    ev.data.fd = fd;
+
+    // fd-ul poate fi deja înregistrat (ONESHOT dezactivat) - îl rearmăm
+    int op = watches_.count(fd) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (epoll_ctl(epoll_fd_, op, fd, &ev) == -1) {
+        if (op == EPOLL_CTL_ADD && errno == EEXIST) {
+            op = EPOLL_CTL_MOD;
+            if (epoll_ctl(epoll_fd_, op, fd, &ev) == -1) return false;
+        } else {
+            perror("epoll_ctl");
+            return false;
+        }
+    }
+
+    watches_[fd] = Watch{events, std::move(cb)};
+    return true;
+}
+
+void EventLoop::unwatch(int fd) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (watches_.erase(fd)) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    }
+}
+
+void EventLoop::wakeup() {
+    uint64_t one = 1;
+    ssize_t n = write(wake_fd_, &one, sizeof(one));
+    (void)n;
+}
+
+int EventLoop::next_timeout_ms() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pending_.empty()) return 0;
+    if (timers_.empty()) return 1000;
+
+    auto delta = timers_.top().when - std::chrono::steady_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(delta).count();
+    if (ms < 0) return 0;
+    return ms > 1000 ? 1000 : static_cast<int>(ms) + 1;
+}
+
+void EventLoop::run_timers() {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<Callback> due;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (!timers_.empty() && timers_.top().when <= now) {
+            due.push_back(std::move(const_cast<Timer&>(timers_.top()).cb));
+            timers_.pop();
+        }
+    }
+    for (auto& cb : due) {
+        try {
+            cb();
+        } catch (const std::exception& e) {
+            std::cerr << "[EventLoop] Timer error: " << e.what() << "\n";
+        }
+    }
+}
+
+void EventLoop::run_pending() {
+    std::vector<Callback> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        batch.swap(pending_);
+    }
+    for (auto& cb : batch) {
+        try {
+            cb();
+        } catch (const std::exception& e) {
+            std::cerr << "[EventLoop] Task error: " << e.what() << "\n";
+        }
+    }
+}
+
+void EventLoop::loop() {
+    struct epoll_event events[64];
+
+    while (running_) {
+        int n = epoll_wait(epoll_fd_, events, 64, next_timeout_ms());
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+
+            if (fd == wake_fd_) {
+                uint64_t value;
+                while (read(wake_fd_, &value, sizeof(value)) > 0) {}
+                continue;
+            }
+
+            // Watch-urile sunt ONESHOT: le scoatem înainte de a apela callback-ul
+            IoCallback cb;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = watches_.find(fd);
+                if (it == watches_.end()) continue;
+                cb = std::move(it->second.cb);
+                watches_.erase(it);
+                epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+            }
+
+            try {
+                cb(events[i].events);
+            } catch (const std::exception& e) {
+                std::cerr << "[EventLoop] I/O callback error: " << e.what() << "\n";
+            }
+        }
+
+        run_timers();
+        run_pending();
+    }
+}
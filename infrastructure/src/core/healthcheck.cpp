@@ -86,24 +86,38 @@ HealthStatus HealthCheck::get_overall_status() {
     return HealthStatus::HEALTHY;
 }
 
+std::vector<HealthCheckResult> HealthCheck::last_results() const {
+    std::lock_guard<std::mutex> lock(results_mutex_);
+    return last_results_;
+}
+
 void HealthCheck::start_periodic_checks(std::chrono::seconds interval) {
     if (running_.exchange(true)) {
         return; // Already running
     }
 
     check_thread_ = std::thread([this, interval]() {
+        std::map<std::string, HealthStatus> logged;
         while (running_) {
             auto results = run_all();
 
-            // Log results
+            // Log results (doar la schimbarea stării, nu la fiecare rundă)
             for (const auto& r : results) {
+                auto previous = logged.find(r.component);
+                if (previous != logged.end() && previous->second == r.status) continue;
+                logged[r.component] = r.status;
+
                 const char* status_str = r.status == HealthStatus::HEALTHY ? "HEALTHY" :
                                        r.status == HealthStatus::DEGRADED ? "DEGRADED" : "UNHEALTHY";
                 std::cout << "[HealthCheck] " << r.component << ": " << status_str
                          << " (" << r.response_time.count() << "ms) - " << r.message << "\n";
             }
 
-            std::this_thread::sleep_for(interval);
+            // Pași scurți, ca stop_periodic_checks() să nu aștepte tot intervalul
+            auto next = std::chrono::steady_clock::now() + interval;
+            while (running_ && std::chrono::steady_clock::now() < next) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
         }
     });
 }
@@ -0,0 +1,139 @@
+#include "core/listener.hpp"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <stdexcept>
+
+ListenerConfig ListenerConfig::tcp(int port, const std::string& host) {
+    ListenerConfig config;
+    config.type = Type::TCP;
+    config.port = port;
+    config.host = host;
+    return config;
+}
+
+ListenerConfig ListenerConfig::unix_socket(const std::string& path, mode_t mode) {
+    ListenerConfig config;
+    config.type = Type::UNIX;
+    config.path = path;
+    config.mode = mode;
+    return config;
+}
+
+ListenerConfig ListenerConfig::tls_tcp(int port, const std::string& cert_file, const std::string& key_file,
+                                       const std::string& host) {
+    ListenerConfig config = tcp(port, host);
+    config.tls = true;
+    config.cert_file = cert_file;
+    config.key_file = key_file;
+    return config;
+}
+
+std::string ListenerConfig::describe() const {
+    if (type == Type::UNIX) {
+        return (tls ? "unix+tls:" : "unix:") + path;
+    }
+    return (tls ? "tls://" : "tcp://") + host + ":" + std::to_string(port);
+}
+
+static int open_tcp(const ListenerConfig& config) {
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(config.port);
+    if (inet_pton(AF_INET, config.host.c_str(), &addr.sin_addr) != 1) {
+        throw std::runtime_error("Invalid listen address: " + config.host);
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("socket");
+        throw std::runtime_error("Failed to create TCP socket");
+    }
+
+    int opt = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
+        perror("setsockopt");
+    }
+
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("bind");
+        ::close(fd);
+        throw std::runtime_error("Failed to bind " + config.describe());
+    }
+    return fd;
+}
+
+static int open_unix(const ListenerConfig& config) {
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (config.path.empty() || config.path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("Invalid unix socket path: " + config.path);
+    }
+    std::strncpy(addr.sun_path, config.path.c_str(), sizeof(addr.sun_path) - 1);
+
+    // Un socket rămas de la o rulare anterioară blochează bind-ul;
+    // ștergem doar dacă e într-adevăr un socket, nu un fișier obișnuit
+    struct stat st;
+    if (lstat(config.path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            throw std::runtime_error("Path exists and is not a socket: " + config.path);
+        }
+        unlink(config.path.c_str());
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("socket");
+        throw std::runtime_error("Failed to create unix socket");
+    }
+
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("bind");
+        ::close(fd);
+        throw std::runtime_error("Failed to bind " + config.describe());
+    }
+
+    if (chmod(config.path.c_str(), config.mode) < 0) {
+        perror("chmod");
+    }
+    return fd;
+}
+
+namespace Listener {
+
+int open(const ListenerConfig& config) {
+    int fd = (config.type == ListenerConfig::Type::UNIX) ? open_unix(config) : open_tcp(config);
+
+    // Non-blocking pentru accept în bucla epoll (edge-triggered)
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+    if (listen(fd, config.backlog) < 0) {
+        perror("listen");
+        ::close(fd);
+        if (config.type == ListenerConfig::Type::UNIX) unlink(config.path.c_str());
+        throw std::runtime_error("Failed to listen on " + config.describe());
+    }
+    return fd;
+}
+
+void close(int fd, const ListenerConfig& config) {
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    if (config.type == ListenerConfig::Type::UNIX && !config.path.empty()) {
+        unlink(config.path.c_str());
+    }
+}
+
+} // namespace Listener
@@ -1,6 +1,7 @@
 #include "core/master.hpp"
 #include "core/workerprocess.hpp"
 #include "core/worker.hpp"
+#include "core/trace.hpp"
 
 #include <unistd.h>
 #include <sys/socket.h>
@@ -8,28 +9,34 @@
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <cstring>
+#include <ctime>
 #include <iostream>
 #include <thread>
 
 // Signal handler global pentru graceful shutdown
 static volatile sig_atomic_t graceful_shutdown_requested = 0;
 
+// SIGUSR2 (doar cu tracing activ): dump al span-urilor în fișier, din accept loop
+static volatile sig_atomic_t trace_dump_requested = 0;
+
 static void signal_handler(int signum) {
     if (signum == SIGTERM || signum == SIGINT) {
         graceful_shutdown_requested = 1;
+    } else if (signum == SIGUSR2) {
+        trace_dump_requested = 1;
     }
 }
 
 MasterProcess::MasterProcess(int port, int num_workers)
     : port_(port),
       num_workers_(num_workers),
-      server_fd_(-1),
       epoll_fd_(-1),
       running_(false),
       shutdown_requested_(false),
       job_queue_(nullptr),
       worker_status_shm_(nullptr),
-      global_stats_(nullptr) {
+      global_stats_(nullptr),
+      route_stats_(nullptr) {
 
     if (num_workers_ > MAX_WORKERS) {
         num_workers_ = MAX_WORKERS;
@@ -45,8 +52,27 @@ void MasterProcess::setRouter(const Router& r) {
     router_ = r;
 }
 
+void MasterProcess::add_listener(const ListenerConfig& config) {
+    listener_configs_.push_back(config);
+}
+
 void MasterProcess::set_shutdown_timeout(std::chrono::seconds timeout) {
     shutdown_timeout_ = timeout;
+    if (global_stats_) {
+        global_stats_->drain_timeout_ms = drain_timeout_ms();
+    }
+}
+
+void MasterProcess::set_admin(const AdminConfig& config, HealthCheck* health) {
+    admin_config_ = config;
+    health_check_ = health;
+}
+
+int MasterProcess::drain_timeout_ms() const {
+    // Workers termină cererile în curs înainte de SIGKILL-ul de la shutdown_timeout_.
+    // Setat din start: Ctrl+C ajunge la workers în același timp cu Master-ul.
+    auto budget = std::chrono::duration_cast<std::chrono::milliseconds>(shutdown_timeout_).count() - 1000;
+    return budget < 500 ? 500 : static_cast<int>(budget);
 }
 
 void MasterProcess::setup_signals() {
@@ -57,6 +83,9 @@ void MasterProcess::setup_signals() {
 
     sigaction(SIGTERM, &sa, NULL);
     sigaction(SIGINT, &sa, NULL);
+    if (Trace::enabled()) {
+        sigaction(SIGUSR2, &sa, NULL);
+    }
 
     // Ignore SIGPIPE (broken pipe când client se deconectează)
     signal(SIGPIPE, SIG_IGN);
@@ -76,68 +105,78 @@ void MasterProcess::setup_epoll() {
         throw std::runtime_error("Failed to create epoll instance");
     }
 
-    struct epoll_event ev;
-    ev.events = EPOLLIN | EPOLLET;  // Edge-triggered mode
-    ev.data.fd = server_fd_;
+    for (int fd : listen_fds_) {
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLET;  // Edge-triggered mode
+        ev.data.fd = fd;
 
-    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, server_fd_, &ev) == -1) {
-        perror("epoll_ctl");
-        close(epoll_fd_);
-        throw std::runtime_error("Failed to add server_fd to epoll");
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == -1) {
+            perror("epoll_ctl");
+            close(epoll_fd_);
+            throw std::runtime_error("Failed to add listener to epoll");
+        }
     }
 
     std::cout << "[Master] epoll configured for non-blocking I/O\n";
 }
 
-void MasterProcess::start() {
-    // 1. Creează socket TCP
-    server_fd_ = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_fd_ < 0) {
-        perror("socket");
-        return;
-    }
-
-    // Set socket options
-    int opt = 1;
-    if (setsockopt(server_fd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
-        perror("setsockopt");
+bool MasterProcess::open_listeners() {
+    if (listener_configs_.empty()) {
+        listener_configs_.push_back(ListenerConfig::tcp(port_));
     }
 
-    // Set non-blocking mode pentru accept
-    int flags = fcntl(server_fd_, F_GETFL, 0);
-    fcntl(server_fd_, F_SETFL, flags | O_NONBLOCK);
+    // Certificatele se încarcă înainte de fork (o eroare oprește pornirea), iar
+    // cheile de ticket sunt comune tuturor worker-ilor, inclusiv celor reporniți
+    std::unique_ptr<TlsTicketKeys> ticket_keys;
 
-    // 2. Bind & Listen
-    struct sockaddr_in addr;
-    std::memset(&addr, 0, sizeof(addr));
-    addr.sin_family = AF_INET;
-    addr.sin_addr.s_addr = INADDR_ANY;
-    addr.sin_port = htons(port_);
+    for (const auto& config : listener_configs_) {
+        try {
+            std::shared_ptr<TlsContext> tls;
+            if (config.tls) {
+                if (!ticket_keys) {
+                    ticket_keys = std::make_unique<TlsTicketKeys>(TlsTicketKeys::generate());
+                }
+                tls = TlsContext::create(config.cert_file, config.key_file, *ticket_keys);
+            }
+            listen_fds_.push_back(Listener::open(config));
+            tls_contexts_.push_back(tls);
+            std::cout << "[Master] Listening on " << config.describe() << "\n";
+        } catch (const std::exception& e) {
+            std::cerr << "[Master] " << e.what() << "\n";
+            close_listeners(true);
+            return false;
+        }
+    }
+    return true;
+}
 
-    if (bind(server_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        perror("bind");
-        close(server_fd_);
-        return;
+void MasterProcess::close_listeners(bool remove_files) {
+    for (size_t i = 0; i < listen_fds_.size(); i++) {
+        if (remove_files) {
+            Listener::close(listen_fds_[i], listener_configs_[i]);
+        } else {
+            close(listen_fds_[i]);  // Worker: fișierul UDS rămâne al Master-ului
+        }
     }
+    listen_fds_.clear();
+}
 
-    if (listen(server_fd_, 128) < 0) {
-        perror("listen");
-        close(server_fd_);
+void MasterProcess::start() {
+    // 1-2. Socket-uri de ascultare (TCP și/sau Unix domain sockets)
+    if (!open_listeners()) {
         return;
     }
 
-    std::cout << "[Master] Socket listening on port " << port_ << "\n";
-
     // 3. Setup signal handlers
     setup_signals();
 
     // 4. Creează SharedQueue pentru job distribution
     try {
-        job_queue_ = new SharedQueue<int>("/rest_api_jobs", 1024, true);
+        job_queue_ = new SharedQueue<int>("/rest_api_jobs", JOB_QUEUE_CAPACITY, true);
         std::cout << "[Master] SharedQueue created for IPC\n";
     } catch (const std::exception& e) {
         std::cerr << "[Master] Failed to create SharedQueue: " << e.what() << "\n";
-        close(server_fd_);
+        close_listeners(true);
         return;
     }
 
@@ -151,12 +190,22 @@ void MasterProcess::start() {
         global_stats_->total_requests = 0;
         global_stats_->total_errors = 0;
         global_stats_->active_connections = 0;
+        global_stats_->drain_timeout_ms = drain_timeout_ms();
+        global_stats_->pending_connections = 0;
+        global_stats_->queue_capacity = JOB_QUEUE_CAPACITY;
+        global_stats_->num_workers = num_workers_;
+        global_stats_->worker_restarts = 0;
+        global_stats_->start_time = static_cast<int64_t>(time(nullptr));
 
         for (int i = 0; i < MAX_WORKERS; i++) {
             global_stats_->workers[i].pid = 0;
             global_stats_->workers[i].requests_handled = 0;
             global_stats_->workers[i].requests_failed = 0;
             global_stats_->workers[i].status = 0;
+            global_stats_->workers[i].in_flight = 0;
+            global_stats_->workers[i].drained = 0;
+            global_stats_->workers[i].aborted = 0;
+            global_stats_->workers[i].queued = 0;
             std::memset(global_stats_->workers[i].last_error, 0, 256);
         }
 
@@ -164,19 +213,58 @@ void MasterProcess::start() {
     } catch (const std::exception& e) {
         std::cerr << "[Master] Failed to create SharedMemory: " << e.what() << "\n";
         delete job_queue_;
-        close(server_fd_);
+        job_queue_ = nullptr;
+        close_listeners(true);
         return;
     }
 
+    // Statistici per rută: un rând per (worker, rută), scris fără lock-uri
+    try {
+        route_stats_ = new RouteStats(router_.routeCount(), num_workers_);
+        router_.setStats(route_stats_);
+    } catch (const std::exception& e) {
+        // Serverul merge și fără ele
+        std::cerr << "[Master] Route statistics disabled: " << e.what() << "\n";
+        route_stats_ = nullptr;
+    }
+
+    // Canalul prin care conexiunile ajung în procesele worker
+    try {
+        conn_channel_.create();
+    } catch (const std::exception& e) {
+        std::cerr << "[Master] " << e.what() << "\n";
+        close_listeners(true);
+        return;
+    }
+
+    // Portul de administrare se deschide înainte de fork: un port ocupat oprește pornirea
+    if (admin_config_.port > 0) {
+        try {
+            admin_ = std::make_unique<AdminServer>(admin_config_, global_stats_, route_stats_, &router_,
+                                                   health_check_);
+            admin_->open();
+        } catch (const std::exception& e) {
+            std::cerr << "[Master] Admin port: " << e.what() << "\n";
+            admin_.reset();
+            close_listeners(true);
+            return;
+        }
+    }
+
     // 6. Setup epoll
     setup_epoll();
 
     // 7. Fork workers
     create_workers();
 
+    // Thread-ul de administrare pornește după fork (worker-ii nu îl moștenesc)
+    if (admin_) {
+        admin_->start();
+    }
+
     // 8. Start accept loop
     running_ = true;
-    std::cout << "[Master] Starting on port " << port_
+    std::cout << "[Master] Starting " << listen_fds_.size() << " listener(s)"
               << " with " << num_workers_ << " worker processes\n";
     std::cout << "[Master] All workers ready. Accepting connections...\n";
 
@@ -189,6 +277,9 @@ void MasterProcess::create_workers() {
     for (int i = 0; i < num_workers_; i++) {
         std::cout << "[Master] Forking worker " << i << "...\n";
 
+        // Buffer-ul stdout ar fi moștenit și scris încă o dată de copil
+        std::cout.flush();
+
         pid_t pid = fork();
 
         if (pid < 0) {
@@ -200,9 +291,11 @@ void MasterProcess::create_workers() {
         if (pid == 0) {
             // ===== PROCES COPIL (WORKER) =====
 
-            // Închide epoll și server socket în worker (nu le folosește)
+            // Închide epoll și socket-urile de ascultare în worker (nu le folosește)
             if (epoll_fd_ >= 0) close(epoll_fd_);
-            if (server_fd_ >= 0) close(server_fd_);
+            close_listeners(false);
+            conn_channel_.close_sender();
+            if (admin_) admin_->close_in_child();
 
             // Worker nu e creator de SharedQueue/SharedMemory, le deschide
             // (sunt deja create de Master)
@@ -211,7 +304,7 @@ void MasterProcess::create_workers() {
                       << " started (parent PID=" << getppid() << ")\n";
 
             // Creează WorkerProcess și rulează-l
-            WorkerProcess worker(i, &router_, job_queue_, worker_status_shm_);
+            WorkerProcess worker(i, &router_, job_queue_, &conn_channel_, worker_status_shm_, tls_contexts_);
 
             // Update global stats cu PID worker
             global_stats_->workers[i].pid = getpid();
@@ -256,31 +349,47 @@ void MasterProcess::accept_loop_epoll() {
 
         // Process events
         for (int i = 0; i < n; i++) {
-            if (events[i].data.fd == server_fd_) {
-                // Acceptă toate conexiunile disponibile (edge-triggered)
-                while (true) {
-                    struct sockaddr_in client_addr;
-                    socklen_t client_len = sizeof(client_addr);
-
-                    int client_fd = accept(server_fd_,
-                                          (struct sockaddr*)&client_addr,
-                                          &client_len);
-
-                    if (client_fd < 0) {
-                        if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                            // Nu mai sunt conexiuni disponibile
-                            break;
-                        } else if (errno == EINTR) {
-                            continue;
-                        } else {
-                            perror("accept");
-                            break;
-                        }
+            int listener_index = -1;
+            for (size_t l = 0; l < listen_fds_.size(); l++) {
+                if (events[i].data.fd == listen_fds_[l]) {
+                    listener_index = static_cast<int>(l);
+                    break;
+                }
+            }
+            if (listener_index < 0) continue;
+
+            // Acceptă toate conexiunile disponibile (edge-triggered)
+            int listen_fd = listen_fds_[listener_index];
+            while (true) {
+                // Adresa clientului: worker-ul nu o mai poate afla după puntea TLS
+                struct sockaddr_storage addr;
+                socklen_t addr_len = sizeof(addr);
+                int client_fd = accept4(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), &addr_len,
+                                        SOCK_CLOEXEC);
+
+                if (client_fd < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                        // Nu mai sunt conexiuni disponibile
+                        break;
+                    } else if (errno == EINTR) {
+                        continue;
+                    } else {
+                        perror("accept");
+                        break;
                     }
-
-                    // Distribuie conexiunea către workers prin SharedQueue
-                    distribute_connection(client_fd);
                 }
+
+                // Distribuie conexiunea către workers
+                distribute_connection(client_fd, listener_index, PeerAddress::from(addr));
+            }
+        }
+
+        // Inelele sunt în shared memory: Master-ul vede span-urile tuturor worker-ilor
+        if (trace_dump_requested) {
+            trace_dump_requested = 0;
+            const std::string& path = Trace::config().dump_file;
+            if (Trace::write_chrome_json(path)) {
+                std::cout << "[Master] Trace written to " << path << "\n";
             }
         }
 
@@ -298,20 +407,38 @@ void MasterProcess::accept_loop_epoll() {
     }
 }
 
-void MasterProcess::distribute_connection(int client_fd) {
-    try {
-        // Pune file descriptor în SharedQueue pentru workers
-        job_queue_->enqueue(client_fd);
-
-        global_stats_->total_requests++;
-        global_stats_->active_connections++;
+void MasterProcess::distribute_connection(int client_fd, int listener_index, const PeerAddress& peer) {
+    int64_t accepted = Trace::enabled() ? Trace::now_ns() : 0;
 
-        // std::cout << "[Master] Connection FD=" << client_fd << " enqueued\n";
+    try {
+        // Tichet în SharedQueue: limitează conexiunile în așteptare (backpressure)
+        job_queue_->enqueue(listener_index);
     } catch (const std::exception& e) {
         std::cerr << "[Master] Failed to enqueue connection: " << e.what() << "\n";
         close(client_fd);  // Închide conexiunea dacă nu poate fi distribuită
         global_stats_->total_errors++;
+        return;
+    }
+    global_stats_->pending_connections++;
+
+    // fd-ul în sine trece prin kernel (SCM_RIGHTS); numărul nu e valid în alt proces
+    if (!conn_channel_.send(client_fd, static_cast<uint32_t>(listener_index), accepted, &peer)) {
+        std::cerr << "[Master] Failed to pass connection to workers\n";
+        try {
+            job_queue_->dequeue();  // Retrage tichetul
+            global_stats_->pending_connections--;
+        } catch (const std::exception&) {
+        }
+        close(client_fd);
+        global_stats_->total_errors++;
+        return;
     }
+
+    // Worker-ul are acum propria copie a conexiunii
+    close(client_fd);
+
+    global_stats_->total_requests++;
+    global_stats_->active_connections++;
 }
 
 void MasterProcess::monitor_workers() {
@@ -362,8 +489,14 @@ void MasterProcess::handle_worker_death(pid_t pid, int worker_index) {
 
     workers_[worker_index].status = 0;
     global_stats_->workers[worker_index].status = 0;
+    global_stats_->worker_restarts++;
+
+    // Conexiunile worker-ului mort nu se mai termină: nu le mai numărăm ca active
+    global_stats_->active_connections -= global_stats_->workers[worker_index].in_flight.exchange(0);
+    global_stats_->workers[worker_index].queued = 0;
 
     // Fork un worker nou
+    std::cout.flush();
     pid_t new_pid = fork();
 
     if (new_pid < 0) {
@@ -376,12 +509,14 @@ void MasterProcess::handle_worker_death(pid_t pid, int worker_index) {
         // ===== PROCES COPIL (WORKER NOU) =====
 
         if (epoll_fd_ >= 0) close(epoll_fd_);
-        if (server_fd_ >= 0) close(server_fd_);
+        close_listeners(false);
+        conn_channel_.close_sender();
+        if (admin_) admin_->close_in_child();
 
         std::cout << "[Worker " << worker_index << "] PID=" << getpid()
                   << " restarted after crash\n";
 
-        WorkerProcess worker(worker_index, &router_, job_queue_, worker_status_shm_);
+        WorkerProcess worker(worker_index, &router_, job_queue_, &conn_channel_, worker_status_shm_, tls_contexts_);
 
         global_stats_->workers[worker_index].pid = getpid();
         global_stats_->workers[worker_index].status = 1;
@@ -415,12 +550,16 @@ void MasterProcess::graceful_shutdown() {
 
     std::cout << "\n[Master] Graceful shutdown initiated\n";
 
-    // 1. Stop accepting new connections
-    running_ = false;
-    if (server_fd_ >= 0) {
-        close(server_fd_);
-        server_fd_ = -1;
+    // Readiness răspunde 503 cât timp worker-ii termină cererile
+    if (admin_) {
+        admin_->set_draining(true);
     }
+
+    // 1. Stop accepting new connections.
+    // Conexiunile deja trimise prin FdChannel sunt preluate de workers la drain.
+    running_ = false;
+    close_listeners(true);
+
     if (epoll_fd_ >= 0) {
         close(epoll_fd_);
         epoll_fd_ = -1;
@@ -483,6 +622,7 @@ void MasterProcess::graceful_shutdown() {
     }
 
     std::cout << "[Master] All workers terminated\n";
+    report_drain();
 
     // 4. Cleanup shared resources
     cleanup();
@@ -490,7 +630,29 @@ void MasterProcess::graceful_shutdown() {
     std::cout << "[Master] Shutdown complete\n";
 }
 
+void MasterProcess::report_drain() {
+    if (!global_stats_) return;
+
+    uint64_t total_drained = 0;
+    uint64_t total_aborted = 0;
+
+    std::cout << "[Master] Drain report:\n";
+    for (int i = 0; i < num_workers_; i++) {
+        uint64_t drained = global_stats_->workers[i].drained;
+        uint64_t aborted = global_stats_->workers[i].aborted;
+        total_drained += drained;
+        total_aborted += aborted;
+
+        std::cout << "  Worker " << i << ": " << drained << " drained, "
+                  << aborted << " aborted\n";
+    }
+    std::cout << "  Total: " << total_drained << " drained, " << total_aborted << " aborted\n";
+}
+
 void MasterProcess::cleanup() {
+    // Thread-ul de administrare citește din shared memory: se oprește primul
+    admin_.reset();
+
     // Cleanup SharedQueue
     if (job_queue_) {
         delete job_queue_;
@@ -505,6 +667,16 @@ void MasterProcess::cleanup() {
         std::cout << "[Master] SharedMemory cleanup complete\n";
     }
 
+    if (route_stats_) {
+        router_.setStats(nullptr);
+        delete route_stats_;
+        route_stats_ = nullptr;
+    }
+
+    conn_channel_.close();
+    close_listeners(true);
+    tls_contexts_.clear();
+
     // Unlink shared memory objects (master is creator)
     shm_unlink("/rest_api_jobs");
     shm_unlink("/rest_api_stats");
@@ -0,0 +1,28 @@
+#include "core/peeraddress.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <cstring>
+
+PeerAddress PeerAddress::from(const struct sockaddr_storage& addr) {
+    PeerAddress peer;
+    if (addr.ss_family == AF_INET) {
+        const auto* in = reinterpret_cast<const struct sockaddr_in*>(&addr);
+        peer.family = AF_INET;
+        peer.port = ntohs(in->sin_port);
+        std::memcpy(peer.bytes, &in->sin_addr, sizeof(in->sin_addr));
+    } else if (addr.ss_family == AF_INET6) {
+        const auto* in6 = reinterpret_cast<const struct sockaddr_in6*>(&addr);
+        peer.family = AF_INET6;
+        peer.port = ntohs(in6->sin6_port);
+        std::memcpy(peer.bytes, &in6->sin6_addr, sizeof(in6->sin6_addr));
+    }
+    return peer;
+}
+
+std::string PeerAddress::to_string() const {
+    if (!known()) return std::string();
+    char text[INET6_ADDRSTRLEN];
+    if (!inet_ntop(family, bytes, text, sizeof(text))) return std::string();
+    return text;
+}
@@ -22,6 +22,12 @@ void Server::setRouter(const Router& r) {
     }
 }
 
+void Server::add_listener(const ListenerConfig& config) {
+    if (master) {
+        master->add_listener(config);
+    }
+}
+
 void Server::start() {
     if (!master) {
         std::cerr << "[Server] MasterProcess not initialized!\n";
@@ -49,3 +55,9 @@ void Server::set_shutdown_timeout(std::chrono::seconds timeout) {
         master->set_shutdown_timeout(timeout);
     }
 }
+
+void Server::set_admin(const AdminConfig& config, HealthCheck* health) {
+    if (master) {
+        master->set_admin(config, health);
+    }
+}
@@ -1,13 +1,19 @@
-
 #include "core/threadpool.hpp"
 
 ThreadPool::ThreadPool() {}
 ThreadPool::ThreadPool(int n){ init(n); }
 ThreadPool::~ThreadPool(){ stop(); }
 
-void ThreadPool::init(int n){
+void ThreadPool::init(int n, size_t max_queue){
     if (!workers.empty()) return;
     stopping=false;
+    max_queue_ = max_queue;
+    if (stats_) {
+        stats_->threads = n;
+        stats_->busy = 0;
+        stats_->queued = 0;
+        stats_->queue_limit = static_cast<int>(max_queue);
+    }
     for (int i=0;i<n;i++){
         workers.emplace_back([this](){ this->worker_loop(); });
     }
@@ -16,9 +22,23 @@ void ThreadPool::enqueue(std::function<void()> f){
     {
         std::lock_guard<std::mutex> lk(m);
         tasks.push(std::move(f));
+        if (stats_) stats_->queued++;
     }
     cv.notify_one();
 }
+bool ThreadPool::try_enqueue(std::function<void()> f){
+    {
+        std::lock_guard<std::mutex> lk(m);
+        if (max_queue_ > 0 && tasks.size() >= max_queue_) {
+            if (stats_) stats_->rejected++;
+            return false;
+        }
+        tasks.push(std::move(f));
+        if (stats_) stats_->queued++;
+    }
+    cv.notify_one();
+    return true;
+}
 void ThreadPool::stop(){
     stopping = true;
     cv.notify_all();
@@ -26,6 +46,7 @@ void ThreadPool::stop(){
         if (t.joinable()) t.join();
     }
     workers.clear();
+    if (stats_) stats_->threads = 0;
 }
 void ThreadPool::worker_loop(){
     while(true){
@@ -37,6 +58,14 @@ void ThreadPool::worker_loop(){
             task = std::move(tasks.front());
             tasks.pop();
         }
+        if (stats_) {
+            stats_->queued--;
+            stats_->busy++;
+        }
         task();
+        if (stats_) {
+            stats_->busy--;
+            stats_->completed++;
+        }
     }
 }
@@ -0,0 +1,374 @@
+#include "core/tls.hpp"
+
+#include <openssl/err.h>
+#include <openssl/rand.h>
+#include <openssl/ssl.h>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+static std::string openssl_error() {
+    unsigned long code = ERR_get_error();
+    if (code == 0) return "unknown error";
+    char buf[256];
+    ERR_error_string_n(code, buf, sizeof(buf));
+    ERR_clear_error();
+    return buf;
+}
+
+static void set_nonblocking(int fd, bool enabled) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, enabled ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK));
+}
+
+// ===== TlsTicketKeys =====
+
+TlsTicketKeys TlsTicketKeys::generate() {
+    TlsTicketKeys keys;
+    if (RAND_bytes(keys.data, sizeof(keys.data)) != 1) {
+        throw std::runtime_error("Failed to generate TLS ticket keys: " + openssl_error());
+    }
+    return keys;
+}
+
+// ===== TlsContext =====
+
+// Doar HTTP/1.1: clienții care oferă și h2 (curl, browsere) cad pe http/1.1
+static int select_alpn(SSL*, const unsigned char** out, unsigned char* outlen,
+                       const unsigned char* in, unsigned int inlen, void*) {
+    static const unsigned char http11[] = "\x08http/1.1";
+    unsigned char* selected = nullptr;
+    if (SSL_select_next_proto(&selected, outlen, http11, sizeof(http11) - 1, in, inlen) != OPENSSL_NPN_NEGOTIATED) {
+        return SSL_TLSEXT_ERR_NOACK;
+    }
+    *out = selected;
+    return SSL_TLSEXT_ERR_OK;
+}
+
+std::shared_ptr<TlsContext> TlsContext::create(const std::string& cert_file, const std::string& key_file,
+                                               const TlsTicketKeys& keys) {
+    std::shared_ptr<TlsContext> context(new TlsContext());
+
+    context->ctx_ = SSL_CTX_new(TLS_server_method());
+    if (!context->ctx_) {
+        throw std::runtime_error("SSL_CTX_new failed: " + openssl_error());
+    }
+    SSL_CTX* ctx = context->ctx_;
+
+    SSL_CTX_set_min_proto_version(ctx, TLS1_3_VERSION);
+
+    // kTLS: după handshake, OpenSSL trece cheile în kernel (dacă modulul tls există)
+    SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+
+    // Puntea reîncearcă SSL_write cu restul buffer-ului, care se poate muta
+    SSL_CTX_set_mode(ctx, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+
+    if (SSL_CTX_use_certificate_chain_file(ctx, cert_file.c_str()) != 1) {
+        throw std::runtime_error("Cannot load TLS certificate " + cert_file + ": " + openssl_error());
+    }
+    if (SSL_CTX_use_PrivateKey_file(ctx, key_file.c_str(), SSL_FILETYPE_PEM) != 1) {
+        throw std::runtime_error("Cannot load TLS private key " + key_file + ": " + openssl_error());
+    }
+    if (SSL_CTX_check_private_key(ctx) != 1) {
+        throw std::runtime_error("TLS private key does not match certificate " + cert_file);
+    }
+
+    // Tickets stateless, criptate cu aceleași chei în toate procesele:
+    // reluarea sesiunii merge indiferent ce worker primește conexiunea.
+    // Cache-ul intern ar fi per proces, deci inutil.
+    if (SSL_CTX_set_tlsext_ticket_keys(ctx, const_cast<unsigned char*>(keys.data), sizeof(keys.data)) != 1) {
+        throw std::runtime_error("Cannot set TLS ticket keys: " + openssl_error());
+    }
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+    SSL_CTX_set_num_tickets(ctx, 1);
+
+    static const unsigned char session_context[] = "restapi";
+    SSL_CTX_set_session_id_context(ctx, session_context, sizeof(session_context) - 1);
+
+    SSL_CTX_set_alpn_select_cb(ctx, select_alpn, nullptr);
+
+    return context;
+}
+
+TlsContext::~TlsContext() {
+    if (ctx_) {
+        SSL_CTX_free(ctx_);
+    }
+}
+
+// ===== TlsSession =====
+
+// O conexiune TLS: handshake, apoi (fără kTLS) puntea între SSL și socketpair.
+// Rulează doar pe thread-ul loop-ului TlsAcceptor.
+class TlsSession : public std::enable_shared_from_this<TlsSession> {
+public:
+    TlsSession(TlsAcceptor* owner, int fd, SSL* ssl,
+               TlsAcceptor::ReadyCallback on_ready, TlsAcceptor::FailCallback on_fail)
+        : owner_(owner), fd_(fd), ssl_(ssl), on_ready_(std::move(on_ready)), on_fail_(std::move(on_fail)) {}
+
+    ~TlsSession() {
+        if (ssl_) SSL_free(ssl_);
+    }
+
+    void begin() {
+        std::weak_ptr<TlsSession> weak = shared_from_this();
+        owner_->loop_.run_after(std::chrono::milliseconds(TlsAcceptor::HANDSHAKE_TIMEOUT_MS), [weak]() {
+            auto session = weak.lock();
+            if (session && !session->handshake_done_ && !session->closed_) {
+                session->fail("handshake timeout");
+            }
+        });
+        handshake();
+    }
+
+private:
+    static constexpr size_t BUFFER_SIZE = 16 * 1024;   // Un record TLS
+
+    TlsAcceptor* owner_;
+    int fd_;
+    int peer_ = -1;              // Capătul punții dinspre server
+    SSL* ssl_;
+    TlsAcceptor::ReadyCallback on_ready_;
+    TlsAcceptor::FailCallback on_fail_;
+
+    bool handshake_done_ = false;
+    bool closed_ = false;
+
+    // Puntea: câte un buffer pe direcție; nu citim mai mult până nu e golit (backpressure)
+    std::string to_app_;
+    std::string to_client_;
+    bool client_eof_ = false;
+    bool app_eof_ = false;
+
+    void watch(int fd, uint32_t events) {
+        auto self = shared_from_this();
+        owner_->loop_.watch_once(fd, events, [self](uint32_t) {
+            if (self->handshake_done_) {
+                self->pump();
+            } else {
+                self->handshake();
+            }
+        });
+    }
+
+    void handshake() {
+        if (closed_) return;
+
+        ERR_clear_error();
+        int result = SSL_accept(ssl_);
+        if (result == 1) {
+            handshake_completed();
+            return;
+        }
+
+        int err = SSL_get_error(ssl_, result);
+        if (err == SSL_ERROR_WANT_READ) {
+            watch(fd_, EPOLLIN);
+        } else if (err == SSL_ERROR_WANT_WRITE) {
+            watch(fd_, EPOLLOUT);
+        } else {
+            fail(openssl_error());
+        }
+    }
+
+    void handshake_completed() {
+        handshake_done_ = true;
+        owner_->handshakes_++;
+        if (SSL_session_reused(ssl_)) {
+            owner_->resumed_++;
+        }
+
+        // kTLS în ambele direcții și nimic rămas în buffer-ul OpenSSL:
+        // socket-ul poate fi folosit direct, ca unul TCP obișnuit
+        if (BIO_get_ktls_send(SSL_get_wbio(ssl_)) && BIO_get_ktls_recv(SSL_get_rbio(ssl_)) &&
+            SSL_pending(ssl_) == 0) {
+            owner_->ktls_++;
+
+            int fd = fd_;
+            fd_ = -1;
+            SSL_free(ssl_);   // Nu închide fd-ul (BIO_NOCLOSE); cheile rămân în kernel
+            ssl_ = nullptr;
+            closed_ = true;
+            owner_->active_--;
+
+            set_nonblocking(fd, false);
+            on_ready_(fd);
+            return;
+        }
+
+        int pair[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair) < 0) {
+            perror("socketpair");
+            fail("socketpair failed");
+            return;
+        }
+        peer_ = pair[0];
+        set_nonblocking(peer_, true);
+
+        on_ready_(pair[1]);
+        pump();
+    }
+
+    // Mută date în ambele direcții până nu mai e progres, apoi rearmează watch-urile
+    void pump() {
+        if (closed_) return;
+
+        bool client_read = false, client_write = false;
+        bool peer_read = false, peer_write = false;
+        char buf[BUFFER_SIZE];
+
+        bool progress = true;
+        while (progress) {
+            progress = false;
+            client_read = client_write = peer_read = peer_write = false;
+
+            // Client -> aplicație
+            if (to_app_.empty() && !client_eof_) {
+                ERR_clear_error();
+                int n = SSL_read(ssl_, buf, sizeof(buf));
+                if (n > 0) {
+                    to_app_.assign(buf, static_cast<size_t>(n));
+                    progress = true;
+                } else {
+                    int err = SSL_get_error(ssl_, n);
+                    if (err == SSL_ERROR_WANT_READ) {
+                        client_read = true;
+                    } else if (err == SSL_ERROR_WANT_WRITE) {
+                        client_write = true;
+                    } else {
+                        // close_notify sau conexiune căzută: aplicația vede EOF
+                        client_eof_ = true;
+                        ::shutdown(peer_, SHUT_WR);
+                        progress = true;
+                    }
+                }
+            }
+
+            if (!to_app_.empty()) {
+                ssize_t n = ::send(peer_, to_app_.data(), to_app_.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+                if (n > 0) {
+                    to_app_.erase(0, static_cast<size_t>(n));
+                    progress = true;
+                } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    peer_write = true;
+                } else if (!(n < 0 && errno == EINTR)) {
+                    // Aplicația nu mai citește (a răspuns deja); restul cererii se aruncă
+                    to_app_.clear();
+                    client_eof_ = true;
+                }
+            }
+
+            // Aplicație -> client
+            if (to_client_.empty() && !app_eof_) {
+                ssize_t n = ::recv(peer_, buf, sizeof(buf), MSG_DONTWAIT);
+                if (n > 0) {
+                    to_client_.assign(buf, static_cast<size_t>(n));
+                    progress = true;
+                } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    peer_read = true;
+                } else if (!(n < 0 && errno == EINTR)) {
+                    app_eof_ = true;
+                    progress = true;
+                }
+            }
+
+            if (!to_client_.empty()) {
+                ERR_clear_error();
+                int n = SSL_write(ssl_, to_client_.data(), static_cast<int>(to_client_.size()));
+                if (n > 0) {
+                    to_client_.erase(0, static_cast<size_t>(n));
+                    progress = true;
+                } else {
+                    int err = SSL_get_error(ssl_, n);
+                    if (err == SSL_ERROR_WANT_WRITE) {
+                        client_write = true;
+                    } else if (err == SSL_ERROR_WANT_READ) {
+                        client_read = true;
+                    } else {
+                        finish();
+                        return;
+                    }
+                }
+            }
+        }
+
+        // Aplicația a închis și totul a ajuns la client
+        if (app_eof_ && to_client_.empty()) {
+            SSL_shutdown(ssl_);
+            finish();
+            return;
+        }
+
+        uint32_t client_events = 0;
+        if (client_read) client_events |= EPOLLIN;
+        if (client_write) client_events |= EPOLLOUT;
+        uint32_t peer_events = 0;
+        if (peer_read) peer_events |= EPOLLIN;
+        if (peer_write) peer_events |= EPOLLOUT;
+        if (client_events) watch(fd_, client_events);
+        if (peer_events) watch(peer_, peer_events);
+    }
+
+    void close_fds() {
+        closed_ = true;
+        if (fd_ >= 0) {
+            owner_->loop_.unwatch(fd_);
+            ::close(fd_);
+            fd_ = -1;
+        }
+        if (peer_ >= 0) {
+            owner_->loop_.unwatch(peer_);
+            ::close(peer_);
+            peer_ = -1;
+        }
+        owner_->active_--;
+    }
+
+    void fail(const std::string& reason) {
+        std::cerr << "[TLS] Handshake eșuat: " << reason << "\n";
+        close_fds();
+        if (on_fail_) on_fail_();
+    }
+
+    void finish() {
+        close_fds();
+    }
+};
+
+// ===== TlsAcceptor =====
+
+TlsAcceptor::~TlsAcceptor() {
+    stop();
+}
+
+void TlsAcceptor::start() {
+    loop_.start();
+}
+
+void TlsAcceptor::stop() {
+    loop_.stop();
+}
+
+void TlsAcceptor::accept(int client_fd, const std::shared_ptr<TlsContext>& context,
+                         ReadyCallback on_ready, FailCallback on_fail) {
+    SSL* ssl = SSL_new(context->get());
+    if (!ssl || SSL_set_fd(ssl, client_fd) != 1) {
+        std::cerr << "[TLS] SSL_new failed: " << openssl_error() << "\n";
+        if (ssl) SSL_free(ssl);
+        ::close(client_fd);
+        if (on_fail) on_fail();
+        return;
+    }
+
+    set_nonblocking(client_fd, true);
+    active_++;
+
+    auto session = std::make_shared<TlsSession>(this, client_fd, ssl, std::move(on_ready), std::move(on_fail));
+    loop_.post([session]() { session->begin(); });
+}
@@ -0,0 +1,379 @@
+#include "core/trace.hpp"
+#include "ipc/sharedmemory.hpp"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <time.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+namespace {
+
+// Un eveniment din inel. seq e impar cât timp scriitorul îl completează
+struct TraceEvent {
+    std::atomic<uint32_t> seq;
+    uint8_t kind;
+    uint8_t id_len;
+    uint8_t detail_len;
+    uint8_t reserved;
+    int32_t pid;
+    int32_t tid;
+    int64_t start_ns;
+    int64_t dur_ns;
+    char id[40];
+    char detail[48];
+};
+
+struct TraceRing {
+    std::atomic<int32_t> owner;     // pid-ul procesului care îl folosește; 0 = liber
+    std::atomic<uint64_t> head;     // Evenimente scrise de la început (indexul următorului)
+};
+
+struct TraceHeader {
+    std::atomic<uint64_t> dropped;
+};
+
+// Copia unui eveniment, citită consistent
+struct EventCopy {
+    uint8_t kind;
+    int32_t pid;
+    int32_t tid;
+    int64_t start_ns;
+    int64_t dur_ns;
+    std::string_view id;
+    std::string_view detail;
+    char id_buf[40];
+    char detail_buf[48];
+};
+
+const char* SHM_NAME = "/rest_api_trace";
+
+TraceConfig config_;
+SharedMemory* shm_ = nullptr;
+TraceHeader* header_ = nullptr;
+TraceRing* rings_ = nullptr;
+TraceEvent* events_ = nullptr;
+size_t ring_count_ = 0;
+size_t ring_size_ = 0;                      // Putere a lui 2
+uint64_t sample_threshold_ = 0;             // hash(id) < prag = eșantionat
+bool sample_all_ = false;
+uint64_t id_seed_ = 0;
+std::atomic<uint64_t> id_counter_{0};
+
+// Crește în copil la fork: inelul luat de thread-ul care a apelat fork aparține părintelui
+std::atomic<uint32_t> generation_{0};
+uint64_t process_pid_ = 0;                  // getpid() e un syscall; reîmprospătat la fork
+
+void on_fork_child() {
+    generation_.fetch_add(1, std::memory_order_relaxed);
+    process_pid_ = static_cast<uint64_t>(::getpid());
+}
+
+uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t hash_id(std::string_view id) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : id) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return mix64(hash);
+}
+
+// Inelul thread-ului curent; eliberat la ieșirea thread-ului
+struct ThreadRing {
+    int index = -1;
+    int32_t pid = 0;
+    int32_t tid = 0;
+    uint32_t generation = 0;
+    uint32_t misses = 0;
+
+    ~ThreadRing() {
+        if (index >= 0 && rings_ && generation == generation_.load(std::memory_order_relaxed)) {
+            rings_[index].owner.store(0, std::memory_order_release);
+        }
+    }
+
+    bool claim() {
+        // Întâi un inel liber, apoi unul rămas de la un proces mort (worker repornit)
+        for (size_t i = 0; i < ring_count_; i++) {
+            int32_t expected = 0;
+            if (rings_[i].owner.compare_exchange_strong(expected, pid, std::memory_order_acq_rel)) {
+                index = static_cast<int>(i);
+                return true;
+            }
+        }
+        for (size_t i = 0; i < ring_count_; i++) {
+            int32_t owner = rings_[i].owner.load(std::memory_order_relaxed);
+            if (owner == pid || owner == 0) continue;
+            if (::kill(owner, 0) == 0 || errno != ESRCH) continue;
+            if (rings_[i].owner.compare_exchange_strong(owner, pid, std::memory_order_acq_rel)) {
+                index = static_cast<int>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    TraceRing* ring() {
+        uint32_t current = generation_.load(std::memory_order_relaxed);
+        if (generation != current || pid == 0) {
+            index = -1;
+            misses = 0;
+            generation = current;
+            pid = static_cast<int32_t>(::getpid());
+            tid = static_cast<int32_t>(::syscall(SYS_gettid));
+        }
+        if (index < 0) {
+            // Toate inelele ocupate: se reîncearcă rar, căutarea e liniară
+            if (misses++ % 256 != 0 || !claim()) return nullptr;
+        }
+        return &rings_[index];
+    }
+};
+
+thread_local ThreadRing thread_ring_;
+
+void append_escaped(std::string& out, std::string_view value) {
+    for (unsigned char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+}
+
+bool read_event(const TraceEvent& ev, EventCopy& out) {
+    uint32_t before = ev.seq.load(std::memory_order_acquire);
+    if (before == 0 || (before & 1)) return false;
+
+    out.kind = ev.kind;
+    out.pid = ev.pid;
+    out.tid = ev.tid;
+    out.start_ns = ev.start_ns;
+    out.dur_ns = ev.dur_ns;
+    size_t id_len = ev.id_len < sizeof(out.id_buf) ? ev.id_len : sizeof(out.id_buf);
+    size_t detail_len = ev.detail_len < sizeof(out.detail_buf) ? ev.detail_len : sizeof(out.detail_buf);
+    std::memcpy(out.id_buf, ev.id, id_len);
+    std::memcpy(out.detail_buf, ev.detail, detail_len);
+
+    // Suprascris între timp de scriitor: copia nu e consistentă
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (ev.seq.load(std::memory_order_relaxed) != before) return false;
+
+    out.id = std::string_view(out.id_buf, id_len);
+    out.detail = std::string_view(out.detail_buf, detail_len);
+    return true;
+}
+
+} // namespace
+
+namespace Trace {
+
+bool enabled_ = false;
+
+void configure(const TraceConfig& config) {
+    config_ = config;
+    if (config_.rings == 0) config_.rings = 1;
+
+    if (config_.sample_rate >= 1.0) {
+        sample_all_ = true;
+    } else {
+        sample_all_ = false;
+        double rate = config_.sample_rate > 0 ? config_.sample_rate : 0;
+        sample_threshold_ = static_cast<uint64_t>(rate * 18446744073709551616.0);
+    }
+
+    if (!shm_) {
+        size_t size = 1;
+        while (size < config_.events_per_ring || size < 16) size <<= 1;
+        ring_size_ = size;
+        ring_count_ = config_.rings;
+
+        size_t bytes = sizeof(TraceHeader) + ring_count_ * sizeof(TraceRing) +
+                       ring_count_ * ring_size_ * sizeof(TraceEvent);
+
+        // Segment nou (nu unul rămas după un crash), zero de la ftruncate. Numele se
+        // șterge imediat: worker-ii moștenesc maparea la fork, nu mai rămâne nimic în
+        // /dev/shm. Paginile se alocă doar când sunt scrise.
+        ::shm_unlink(SHM_NAME);
+        shm_ = new SharedMemory(SHM_NAME, bytes, true);
+        ::shm_unlink(SHM_NAME);
+
+        char* base = static_cast<char*>(shm_->get_ptr());
+        header_ = new (base) TraceHeader();
+        rings_ = reinterpret_cast<TraceRing*>(base + sizeof(TraceHeader));
+        events_ = reinterpret_cast<TraceEvent*>(base + sizeof(TraceHeader) + ring_count_ * sizeof(TraceRing));
+
+        id_seed_ = mix64(static_cast<uint64_t>(now_ns()));
+        process_pid_ = static_cast<uint64_t>(::getpid());
+        pthread_atfork(nullptr, nullptr, on_fork_child);
+    }
+
+    enabled_ = true;
+}
+
+const TraceConfig& config() {
+    return config_;
+}
+
+int64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+void begin(TraceContext& ctx, std::string_view incoming_id) {
+    size_t length;
+    if (!incoming_id.empty()) {
+        length = incoming_id.size() < sizeof(ctx.id) - 1 ? incoming_id.size() : sizeof(ctx.id) - 1;
+        std::memcpy(ctx.id, incoming_id.data(), length);
+    } else {
+        // 16 cifre hex: unice între worker-i (pid) și între porniri (seed)
+        static const char HEX[] = "0123456789abcdef";
+        uint64_t n = id_counter_.fetch_add(1, std::memory_order_relaxed);
+        uint64_t value = mix64(id_seed_ ^ (process_pid_ << 40) ^ n);
+        for (int i = 15; i >= 0; i--) {
+            ctx.id[i] = HEX[value & 0xf];
+            value >>= 4;
+        }
+        length = 16;
+    }
+    ctx.id[length] = '\0';
+
+    ctx.sampled = enabled_ && (sample_all_ || hash_id(std::string_view(ctx.id, length)) < sample_threshold_);
+}
+
+void record(const TraceContext& ctx, SpanKind kind, int64_t start_ns, int64_t end_ns, std::string_view detail) {
+    if (!ctx.sampled || !rings_) return;
+
+    TraceRing* ring = thread_ring_.ring();
+    if (!ring) {
+        header_->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    TraceEvent& ev = events_[static_cast<size_t>(thread_ring_.index) * ring_size_ + (head & (ring_size_ - 1))];
+
+    uint32_t seq = ev.seq.load(std::memory_order_relaxed);
+    ev.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    ev.kind = static_cast<uint8_t>(kind);
+    ev.pid = thread_ring_.pid;
+    ev.tid = thread_ring_.tid;
+    ev.start_ns = start_ns;
+    ev.dur_ns = end_ns > start_ns ? end_ns - start_ns : 0;
+    size_t id_len = std::strlen(ctx.id);
+    ev.id_len = static_cast<uint8_t>(id_len);
+    std::memcpy(ev.id, ctx.id, id_len);
+    size_t detail_len = detail.size() < sizeof(ev.detail) ? detail.size() : sizeof(ev.detail);
+    ev.detail_len = static_cast<uint8_t>(detail_len);
+    std::memcpy(ev.detail, detail.data(), detail_len);
+
+    ev.seq.store(seq + 2, std::memory_order_release);
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+std::string chrome_json(std::string_view request_id) {
+    std::string out = "{\"traceEvents\":[";
+    bool first = true;
+
+    for (size_t r = 0; rings_ && r < ring_count_; r++) {
+        uint64_t head = rings_[r].head.load(std::memory_order_acquire);
+        uint64_t begin = head > ring_size_ ? head - ring_size_ : 0;
+
+        for (uint64_t i = begin; i < head; i++) {
+            EventCopy ev;
+            if (!read_event(events_[r * ring_size_ + (i & (ring_size_ - 1))], ev)) continue;
+            if (!request_id.empty() && ev.id != request_id) continue;
+
+            char numbers[160];
+            std::snprintf(numbers, sizeof(numbers),
+                          "\",\"cat\":\"http\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d",
+                          static_cast<double>(ev.start_ns) / 1e3, static_cast<double>(ev.dur_ns) / 1e3,
+                          static_cast<int>(ev.pid), static_cast<int>(ev.tid));
+
+            if (!first) out += ",\n";
+            first = false;
+            out += "{\"name\":\"";
+            out += span_name(static_cast<SpanKind>(ev.kind));
+            out += numbers;
+            out += ",\"args\":{\"request_id\":\"";
+            append_escaped(out, ev.id);
+            out += '"';
+            if (!ev.detail.empty()) {
+                out += ",\"detail\":\"";
+                append_escaped(out, ev.detail);
+                out += '"';
+            }
+            out += "}}";
+        }
+    }
+
+    out += "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":";
+    out += std::to_string(dropped());
+    out += "}}\n";
+    return out;
+}
+
+bool write_chrome_json(const std::string& path) {
+    std::string json = chrome_json();
+
+    // Fișier temporar + rename: cine citește nu vede un dump pe jumătate
+    std::string tmp = path + ".tmp";
+    FILE* file = std::fopen(tmp.c_str(), "w");
+    if (!file) {
+        perror("fopen trace");
+        return false;
+    }
+    bool ok = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        perror("write trace");
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+uint64_t dropped() {
+    return header_ ? header_->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+const char* span_name(SpanKind kind) {
+    switch (kind) {
+        case SpanKind::Request:    return "request";
+        case SpanKind::Accept:     return "accept";
+        case SpanKind::Queue:      return "queue";
+        case SpanKind::Read:       return "read";
+        case SpanKind::Parse:      return "parse";
+        case SpanKind::Middleware: return "middleware";
+        case SpanKind::Handler:    return "handler";
+        case SpanKind::After:      return "after";
+        case SpanKind::Db:         return "db";
+        case SpanKind::Send:       return "send";
+        case SpanKind::Custom:     return "custom";
+    }
+    return "span";
+}
+
+} // namespace Trace
@@ -2,22 +2,40 @@
 #include "http/request.hpp"
 #include "http/response.hpp"
 #include "http/router.hpp"
+#include "http/websocket.hpp"
+#include "http/sse.hpp"
+#include "http/body.hpp"
+#include "http/cors.hpp"
+#include "http/ratelimit.hpp"
+#include "core/trace.hpp"
+#include "core/threadpool.hpp"
+#include "core/concurrencylimit.hpp"
+#include "core/cancellation.hpp"
+#include "core/eventloop.hpp"
 #include <unistd.h>
+#include <sys/uio.h>
+#include <cerrno>
 #include <sys/socket.h>
+#include <sys/epoll.h>
 #include <vector>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <chrono>
 #include <iostream>
 #include <sstream>
 
 namespace Worker {
 
-// Helper simplu pentru parsarea primei linii din request
-static HttpRequest parse_simple_request(const std::string& raw) {
+// Helper simplu pentru parsarea primei linii din request.
+// raw se mută în req.raw la final (fără copie); până atunci se parsează din el.
+static HttpRequest parse_simple_request(std::string raw) {
     HttpRequest req;
-    req.raw = raw;  // Salvează raw request complet
 
     // Găsește prima linie (până la \r\n)
     size_t end_of_first_line = raw.find("\r\n");
     if (end_of_first_line == std::string::npos) {
+        req.raw = std::move(raw);
         return req;  // Request invalid
     }
 
@@ -27,6 +45,7 @@ static HttpRequest parse_simple_request(const std::string& raw) {
     std::istringstream iss(first_line);
     std::string method, target, version;
     if (!(iss >> method >> target >> version)) {
+        req.raw = std::move(raw);
         return req;  // Parsare eșuată
     }
 
@@ -47,57 +66,535 @@ static HttpRequest parse_simple_request(const std::string& raw) {
         req.body = raw.substr(body_start + 4);
     }
 
+    // Headere: "Nume: valoare" pe fiecare linie până la linia goală
+    size_t headers_end = (body_start == std::string::npos) ? raw.size() : body_start;
+    size_t line_start = end_of_first_line + 2;
+    while (line_start < headers_end) {
+        size_t line_end = raw.find("\r\n", line_start);
+        if (line_end == std::string::npos || line_end > headers_end) line_end = headers_end;
+
+        size_t colon = raw.find(':', line_start);
+        if (colon != std::string::npos && colon < line_end) {
+            std::string name = raw.substr(line_start, colon - line_start);
+            size_t value_start = raw.find_first_not_of(" \t", colon + 1);
+            std::string value = (value_start == std::string::npos || value_start >= line_end)
+                                    ? std::string()
+                                    : raw.substr(value_start, line_end - value_start);
+            while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) value.pop_back();
+            req.headers[name] = value;
+        }
+        line_start = line_end + 2;
+    }
+
+    req.raw = std::move(raw);  // Salvează raw request complet
     return req;
 }
 
+// Headere mai mari sunt trunchiate (cererea devine invalidă)
+static constexpr size_t MAX_HEADER_SIZE = 64 * 1024;
+
+static size_t max_body_size_ = 1024 * 1024;
+
+void set_max_body_size(size_t bytes) {
+    max_body_size_ = bytes;
+}
+
+size_t max_body_size() {
+    return max_body_size_;
+}
+
+static std::shared_ptr<const CorsPolicy> cors_policy_;
+
+void set_cors_policy(std::shared_ptr<const CorsPolicy> policy) {
+    cors_policy_ = std::move(policy);
+}
+
+static std::shared_ptr<RateLimiter> rate_limiter_;
+
+void set_rate_limiter(std::shared_ptr<RateLimiter> limiter) {
+    rate_limiter_ = std::move(limiter);
+}
+
+static int thread_pool_size_ = 8;
+static std::vector<ThreadPoolConfig> thread_pools_;
+static std::vector<ThreadPool*> route_pools_;
+
+void set_thread_pool_size(int threads) {
+    thread_pool_size_ = threads > 0 ? threads : 1;
+}
+
+int thread_pool_size() {
+    return thread_pool_size_;
+}
+
+void set_thread_pools(std::vector<ThreadPoolConfig> pools) {
+    thread_pools_ = std::move(pools);
+}
+
+const std::vector<ThreadPoolConfig>& thread_pools() {
+    return thread_pools_;
+}
+
+void attach_thread_pools(std::vector<ThreadPool*> pools) {
+    route_pools_ = std::move(pools);
+}
+
+static std::shared_ptr<ConcurrencyLimiter> concurrency_limiter_;
+
+void set_concurrency_limiter(std::shared_ptr<ConcurrencyLimiter> limiter) {
+    concurrency_limiter_ = std::move(limiter);
+}
+
+ConcurrencyLimiter* concurrency_limiter() {
+    return concurrency_limiter_.get();
+}
+
+static CancellationConfig cancellation_;
+
+void set_cancellation(CancellationConfig config) {
+    cancellation_ = std::move(config);
+}
+
 void initialize() {
     // Nu mai este nevoie - toate componentele sunt create în main.cpp
     // Această funcție este păstrată pentru compatibilitate
 }
 
 std::string read_request(int fd){
+    std::string raw;
     std::vector<char> buf(8192);
-    ssize_t n = ::recv(fd, buf.data(), buf.size()-1, 0);
-    if (n <= 0) return std::string();
-    buf[n]=0;
-    return std::string(buf.data());
+
+    // Headerele pot sosi în mai multe segmente TCP; restul corpului îl citește BodyReader
+    while (raw.size() < MAX_HEADER_SIZE) {
+        ssize_t n = ::recv(fd, buf.data(), buf.size(), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+
+        size_t scan_from = raw.size() > 3 ? raw.size() - 3 : 0;
+        // Lungimea explicită: body-ul poate conține octeți 0 (ex. frame-uri WebSocket)
+        raw.append(buf.data(), static_cast<size_t>(n));
+        if (raw.find("\r\n\r\n", scan_from) != std::string::npos) break;
+    }
+    return raw;
 }
 
 void send_response(int fd, const std::string& response){
     ::send(fd, response.data(), response.size(), 0);
 }
 
-void handle_client(int client_fd, Router* router){
+// Răspunsul cu un bloc de headere inserat după linia de status (ex. RateLimit-*),
+// trimis cu writev: răspunsul deja serializat nu se copiază
+static void send_response_with_headers(int fd, const std::string& response, const std::string& headers) {
+    size_t status_end = response.find("\r\n");
+    if (headers.empty() || status_end == std::string::npos) {
+        send_response(fd, response);
+        return;
+    }
+    status_end += 2;
+
+    struct iovec parts[3];
+    parts[0].iov_base = const_cast<char*>(response.data());
+    parts[0].iov_len = status_end;
+    parts[1].iov_base = const_cast<char*>(headers.data());
+    parts[1].iov_len = headers.size();
+    parts[2].iov_base = const_cast<char*>(response.data() + status_end);
+    parts[2].iov_len = response.size() - status_end;
+
+    size_t total = response.size() + headers.size();
+    size_t sent = 0;
+    int first = 0;
+    while (sent < total) {
+        ssize_t n = ::writev(fd, parts + first, 3 - first);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        sent += static_cast<size_t>(n);
+
+        // Scrieri parțiale: sare peste ce s-a trimis
+        size_t done = static_cast<size_t>(n);
+        while (first < 3 && done >= parts[first].iov_len) {
+            done -= parts[first].iov_len;
+            first++;
+        }
+        if (first < 3) {
+            parts[first].iov_base = static_cast<char*>(parts[first].iov_base) + done;
+            parts[first].iov_len -= done;
+        }
+    }
+}
+
+// Începe trace-ul cererii: ID-ul (primit sau generat, văzut și de handler) și
+// span-urile de până acum. Headerul cu ID-ul se adaugă la răspuns.
+static void begin_trace(TraceContext& trace, HttpRequest& req, const ConnectionTimes& times,
+                        int64_t read_start, int64_t parse_start, std::string& extra_headers) {
+    const std::string& header = Trace::config().header;
+    std::string incoming = req.getHeader(header);
+    Trace::begin(trace, incoming);
+    if (incoming.empty()) {
+        req.headers[header] = trace.id;
+    }
+    extra_headers += header;
+    extra_headers += ": ";
+    extra_headers += trace.id;
+    extra_headers += "\r\n";
+
+    if (!trace.sampled) return;
+    int64_t now = Trace::now_ns();
+    trace.start_ns = times.accepted_ns ? times.accepted_ns : read_start;
+    if (times.accepted_ns) {
+        Trace::record(trace, SpanKind::Accept, times.accepted_ns, times.received_ns);
+        Trace::record(trace, SpanKind::Queue, times.received_ns, read_start);
+    }
+    Trace::record(trace, SpanKind::Read, read_start, parse_start);
+    Trace::record(trace, SpanKind::Parse, parse_start, now);
+}
+
+// Span-urile send și request, după trimiterea răspunsului ("GET /users/:id 200")
+static void end_trace(const TraceContext& trace, const std::string& detail, const std::string& response,
+                      int64_t send_start) {
+    int64_t now = Trace::now_ns();
+    Trace::record(trace, SpanKind::Send, send_start, now);
+
+    std::string summary = detail;
+    if (response.size() >= 12 && response.compare(0, 5, "HTTP/") == 0) {
+        summary += ' ';
+        summary.append(response, 9, 3);
+    }
+    Trace::record(trace, SpanKind::Request, trace.start_ns, now, summary);
+}
+
+// Starea de anulare a cererii, dacă are un termen (al rutei, scurtat de cel
+// din header, socotit de la sosire) sau dacă se urmăresc deconectările
+static std::shared_ptr<CancellationState> begin_cancellation(const HttpRequest& req, const Route* route,
+                                                             const ConnectionTimes& times,
+                                                             std::chrono::steady_clock::time_point start) {
+    int64_t ms = route ? route->deadline_ms : 0;
+    if (!cancellation_.deadline_header.empty()) {
+        std::string value = req.getHeader(cancellation_.deadline_header);
+        int64_t client = 0;
+        const char* end = value.data() + value.size();
+        auto [ptr, ec] = std::from_chars(value.data(), end, client);
+        if (ec == std::errc() && ptr == end && client > 0) {
+            ms = ms > 0 ? std::min(ms, client) : client;
+        }
+    }
+    if (ms <= 0 && !cancellation_.watch_disconnects) return nullptr;
+
+    // Sosirea: acceptarea în Master, primirea în worker sau, necunoscute, începutul
+    // citirii (steady_clock și Trace::now_ns sunt amândouă CLOCK_MONOTONIC)
+    int64_t arrived_ns = times.accepted_ns ? times.accepted_ns : times.received_ns;
+    auto arrived = arrived_ns ? CancellationState::Clock::time_point(std::chrono::nanoseconds(arrived_ns)) : start;
+
+    CancellationState::Clock::time_point deadline;
+    if (ms > 0) deadline = arrived + std::chrono::milliseconds(ms);
+    auto state = std::make_shared<CancellationState>(deadline);
+
+    // La termen se apelează callback-urile (ex. interogarea în curs se întrerupe);
+    // cancelled() vede termenul trecut și fără timer
+    if (ms > 0 && !state->cancelled()) {
+        std::weak_ptr<CancellationState> weak = state;
+        EventLoop::instance().run_after(state->remaining(), [weak]() {
+            if (auto alive = weak.lock()) alive->cancel(CancelReason::Deadline);
+        });
+    }
+    return state;
+}
+
+// Cerere refuzată fără corp citit și fără handler ("503 Service Unavailable",
+// cu Retry-After, sau "504 Gateway Timeout"); conexiunea se închide.
+// headers = blocul adăugat după linia de status (ID-ul cererii, CORS...)
+static void send_refusal(int client_fd, Router* router, const HttpRequest& req, const Route* route,
+                         std::chrono::steady_clock::time_point start, const TraceContext& trace,
+                         const char* status, const std::string& headers, const std::function<void()>& on_done) {
+    std::string body = std::string("{\"error\":\"") + (status + 4) + "\"}";
+    std::string response = std::string("HTTP/1.1 ") + status + "\r\nContent-Type: application/json\r\n";
+    if (std::strncmp(status, "503", 3) == 0) response += "Retry-After: 1\r\n";
+    response += headers;
+    response += "Content-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+    response += body;
+
+    int64_t send_start = trace.sampled ? Trace::now_ns() : 0;
+    send_response(client_fd, response);
+    if (trace.sampled) {
+        end_trace(trace, req.method + " " + (route ? route->pattern : req.path), response, send_start);
+    }
+    router->recordRequest(route, response, start, req.raw.size());
+    ::shutdown(client_fd, SHUT_RDWR);
+    ::close(client_fd);
+    if (on_done) on_done();
+}
+
+// Restul cererii, după rutare: corpul, handler-ul și trimiterea răspunsului
+static void run_route(int client_fd, Router* router, HttpRequest& req, const Route* route,
+                      const RouteParams& params, std::chrono::steady_clock::time_point start,
+                      const TraceContext& trace, std::string extra_headers, std::function<void()> on_done) {
+    // Limita de concurență a grupului: un loc până la trimiterea răspunsului
+    std::shared_ptr<ConcurrencyPermit> permit;
+    if (concurrency_limiter_ && route) {
+        int group = concurrency_limiter_->group_for(*router, route, req);
+        if (group >= 0) {
+            int64_t wait_start = trace.sampled ? Trace::now_ns() : 0;
+            bool waited = false;
+            if (!concurrency_limiter_->acquire(group, &waited)) {
+                std::cout << "[Worker] 503 (limita de concurență)\n";
+                send_refusal(client_fd, router, req, route, start, trace, "503 Service Unavailable",
+                             extra_headers + (cors_policy_ ? cors_policy_->headers_for(req) : std::string()),
+                             on_done);
+                return;
+            }
+            if (waited && trace.sampled) {
+                Trace::record(trace, SpanKind::Queue, wait_start, Trace::now_ns(), "concurrency");
+            }
+            permit = std::make_shared<ConcurrencyPermit>(concurrency_limiter_.get(), group);
+        }
+    }
+
+    // Termenul poate fi trecut deja (cererea a stat la coadă): handler-ul nu mai rulează
+    std::shared_ptr<CancellationState> cancellation = req.cancellation;
+    if (cancellation && cancellation->cancelled()) {
+        std::cout << "[Worker] 504 (termen depășit înainte de handler)\n";
+        send_refusal(client_fd, router, req, route, start, trace, "504 Gateway Timeout",
+                     extra_headers + (cors_policy_ ? cors_policy_->headers_for(req) : std::string()), on_done);
+        return;
+    }
+
+    // Clientul care închide conexiunea anulează cererea (handler-ul o vede, interogarea se întrerupe).
+    // Watch-ul se scoate înainte de close, ca fd-ul să poată fi refolosit
+    bool watching = false;
+    if (cancellation && cancellation_.watch_disconnects) {
+        std::weak_ptr<CancellationState> weak = cancellation;
+        watching = EventLoop::instance().watch_once(client_fd, EPOLLRDHUP, [weak](uint32_t) {
+            if (auto alive = weak.lock()) alive->cancel(CancelReason::Disconnected);
+        });
+    }
+    Cancellation::CurrentScope current_cancellation(cancellation.get());
+
+    // Corpul: rutele cu flux îl citesc singure, celelalte îl primesc întreg (până la limită)
+    size_t limit = (route && route->streaming) ? BodyReader::UNLIMITED : max_body_size_;
+    BodyReader body(client_fd, std::move(req.body), req, limit);
+    req.body.clear();
+
+    // Octeți primiți: headerele plus corpul anunțat (chunked: doar ce a venit cu headerele)
+    size_t headers_end = req.raw.find("\r\n\r\n");
+    uint64_t bytes_in = (headers_end == std::string::npos) ? req.raw.size() : headers_end + 4;
+    bytes_in += body.content_length() > 0 ? static_cast<uint64_t>(body.content_length())
+                                          : req.raw.size() - std::min<uint64_t>(bytes_in, req.raw.size());
+
+    // Metoda și ruta, pentru span-ul request (cererea nu mai există la un răspuns async)
+    std::string trace_detail;
+    if (trace.sampled) {
+        trace_detail = req.method + " " + (route ? route->pattern : req.path);
+    }
+
+    // Completion: trimite răspunsul și închide conexiunea,
+    // imediat (rută sync) sau mai târziu din alt thread (rută async)
+    ResponseCompletion completion([client_fd, on_done, router, route, start, bytes_in, trace, permit,
+                                   cancellation, watching, trace_detail = std::move(trace_detail),
+                                   extra_headers = std::move(extra_headers)](const std::string& response) {
+        if (watching) EventLoop::instance().unwatch(client_fd);
+
+        // Clientul a plecat: nu mai are cine citi răspunsul
+        int64_t send_start = trace.sampled ? Trace::now_ns() : 0;
+        if (cancellation && cancellation->reason() == CancelReason::Disconnected) {
+            std::cout << "[Worker] Client deconectat, răspuns abandonat\n";
+        } else {
+            send_response_with_headers(client_fd, response, extra_headers);
+        }
+        if (permit) permit->release(true);
+        if (trace.sampled) {
+            end_trace(trace, trace_detail, response, send_start);
+        }
+        router->recordRequest(route, response, start, bytes_in);
+
+        std::cout << "[Worker] Răspuns trimis\n";
+        std::cout << "[Worker] =====================================\n\n";
+
+        // Închide conexiunea
+        ::shutdown(client_fd, SHUT_RDWR);
+        ::close(client_fd);
+
+        if (on_done) on_done();
+    });
+
+    // Procesează prin router
+    router->dispatch(req, route, params, body, std::move(completion));
+}
+
+// O cerere mutată în pool-ul rutei ei
+struct PendingRequest {
+    int client_fd = -1;
+    Router* router = nullptr;
+    HttpRequest req;
+    const Route* route = nullptr;
+    RouteParams params;
+    std::chrono::steady_clock::time_point start;
+    TraceContext trace;
+    std::string extra_headers;
+    std::function<void()> on_done;
+    int64_t queued_ns = 0;
+};
+
+static void hand_off(ThreadPool& pool, int client_fd, Router* router, HttpRequest&& req, const Route* route,
+                     std::chrono::steady_clock::time_point start, const TraceContext& trace,
+                     std::string extra_headers, std::function<void()> on_done) {
+    // CORS pe 503, cât timp cererea e încă aici
+    std::string cors = cors_policy_ ? cors_policy_->headers_for(req) : std::string();
+
+    auto pending = std::make_shared<PendingRequest>();
+    pending->client_fd = client_fd;
+    pending->router = router;
+    pending->req = std::move(req);
+    pending->route = route;
+    pending->start = start;
+    pending->trace = trace;
+    pending->extra_headers = std::move(extra_headers);
+    pending->on_done = std::move(on_done);
+    pending->queued_ns = trace.sampled ? Trace::now_ns() : 0;
+
+    bool accepted = pool.try_enqueue([pending]() {
+        PendingRequest& p = *pending;
+        if (p.trace.sampled) {
+            const std::string& name = thread_pools_[static_cast<size_t>(p.route->pool)].name;
+            Trace::record(p.trace, SpanKind::Queue, p.queued_ns, Trace::now_ns(), name);
+        }
+        Trace::CurrentScope current_trace(p.trace.sampled ? &p.trace : nullptr);
+
+        // Parametrii sunt view-uri în path: se caută din nou, în cererea mutată
+        const Route* route = p.router->match(p.req.method, p.req.path, p.params);
+        run_route(p.client_fd, p.router, p.req, route ? route : p.route, p.params, p.start, p.trace,
+                  std::move(p.extra_headers), std::move(p.on_done));
+    });
+    if (accepted) return;
+
+    // Pool-ul e plin: cererea nu ocupă alt pool, clientul reîncearcă
+    std::cout << "[Worker] 503 (pool " << thread_pools_[static_cast<size_t>(route->pool)].name << " plin)\n";
+    send_refusal(client_fd, router, pending->req, route, start, trace, "503 Service Unavailable",
+                 pending->extra_headers + cors, pending->on_done);
+}
+
+void handle_client(int client_fd, Router* router, std::function<void()> on_done, ConnectionTimes times){
     if (!router) {
         std::cerr << "[Worker] EROARE: Router este nullptr!\n";
         ::close(client_fd);
+        if (on_done) on_done();
         return;
     }
 
+    // Latența pentru statistici include citirea cererii
+    auto start = std::chrono::steady_clock::now();
+
+    // Tracing: momentele etapelor se citesc doar când e activ
+    bool tracing = Trace::enabled();
+    int64_t read_start = tracing ? Trace::now_ns() : 0;
+
     // Citește cererea
     std::string raw = read_request(client_fd);
     if (raw.empty()){
         ::close(client_fd);
+        if (on_done) on_done();
         return;
     }
 
     std::cout << "\n[Worker] ========== CERERE NOUĂ ==========\n";
 
     // Parsează cererea
-    HttpRequest req = parse_simple_request(raw);
+    int64_t parse_start = tracing ? Trace::now_ns() : 0;
+    HttpRequest req = parse_simple_request(std::move(raw));
     std::cout << "[Worker] " << req.method << " " << req.path << "\n";
 
-    // Procesează prin router
-    std::string response = router->handle(req);
+    // Headere adăugate răspunsului după linia de status (ID-ul cererii, RateLimit-*)
+    std::string extra_headers;
 
-    // Trimite răspunsul
-    send_response(client_fd, response);
+    // Span-urile din middleware, handler și DB se leagă de cerere prin thread-ul curent
+    TraceContext trace;
+    if (tracing) {
+        begin_trace(trace, req, times, read_start, parse_start, extra_headers);
+    }
+    Trace::CurrentScope current_trace(trace.sampled ? &trace : nullptr);
 
-    std::cout << "[Worker] Răspuns trimis\n";
-    std::cout << "[Worker] =====================================\n\n";
+    // Preflight CORS: răspuns precalculat, fără router și fără corp
+    if (cors_policy_ && CorsPolicy::is_preflight(req)) {
+        send_response(client_fd, cors_policy_->preflight_response(req));
+        ::shutdown(client_fd, SHUT_RDWR);
+        ::close(client_fd);
+        if (on_done) on_done();
+        return;
+    }
 
-    // Închide conexiunea
-    ::shutdown(client_fd, SHUT_RDWR);
-    ::close(client_fd);
+    RouteParams params;
+    const Route* route = router->findRoute(req, params);
+
+    // Limitare de rată: 429 înainte de corp și de handler; altfel headerele
+    // RateLimit-* se adaugă la răspuns
+    if (rate_limiter_) {
+        int policy = rate_limiter_->policy_for(*router, route, req);
+        if (policy >= 0) {
+            RateLimitDecision decision = rate_limiter_->take(policy, rate_limiter_->client_key(policy, req, client_fd, times.peer));
+            if (!decision.allowed) {
+                std::string response = rate_limiter_->rejection(
+                    decision, extra_headers + (cors_policy_ ? cors_policy_->headers_for(req) : std::string()));
+                int64_t send_start = trace.sampled ? Trace::now_ns() : 0;
+                send_response(client_fd, response);
+                if (trace.sampled) {
+                    end_trace(trace, req.method + " " + req.path, response, send_start);
+                }
+                router->recordRequest(route, response, start, req.raw.size());
+                std::cout << "[Worker] 429 (rate limit)\n";
+                ::shutdown(client_fd, SHUT_RDWR);
+                ::close(client_fd);
+                if (on_done) on_done();
+                return;
+            }
+            extra_headers += rate_limiter_->headers(decision);
+        }
+    }
+
+    // Upgrade la WebSocket: conexiunea trece în event loop și rămâne deschisă
+    if (route && route->websocket && WebSocketProtocol::is_upgrade_request(req)) {
+        std::string handshake;
+        bool accepted = WebSocketProtocol::build_handshake_response(req, handshake);
+        send_response(client_fd, handshake);
+
+        if (!accepted) {
+            ::shutdown(client_fd, SHUT_RDWR);
+            ::close(client_fd);
+            if (on_done) on_done();
+            return;
+        }
+
+        std::cout << "[Worker] Upgrade WebSocket: " << req.path << "\n";
+        WebSocketConnection::accept(client_fd, route->websocket, req, params, on_done);
+        return;
+    }
+
+    // Server-Sent Events: abonatul rămâne conectat la canal
+    if (route && route->sse) {
+        SseSubscription subscription = route->sse(req, params);
+        if (subscription.channel) {
+            std::cout << "[Worker] Abonat SSE: " << req.path << "\n";
+            subscription.channel->subscribe(client_fd, req, on_done, subscription.extra_headers);
+            return;
+        }
+        if (!subscription.rejection.empty()) {
+            send_response(client_fd, subscription.rejection);
+            ::shutdown(client_fd, SHUT_RDWR);
+            ::close(client_fd);
+            if (on_done) on_done();
+            return;
+        }
+    }
+
+    // Termenul curge de la sosire, inclusiv cât cererea așteaptă un pool sau un loc
+    if (route) {
+        req.cancellation = begin_cancellation(req, route, times, start);
+    }
+
+    // Bulkhead: ruta are pool-ul ei, cererea continuă acolo
+    if (route && route->pool >= 0 && static_cast<size_t>(route->pool) < route_pools_.size()) {
+        hand_off(*route_pools_[static_cast<size_t>(route->pool)], client_fd, router, std::move(req), route,
+                 start, trace, std::move(extra_headers), std::move(on_done));
+        return;
+    }
+
+    run_route(client_fd, router, req, route, params, start, trace, std::move(extra_headers), std::move(on_done));
 }
 }
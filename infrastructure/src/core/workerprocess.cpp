@@ -1,6 +1,10 @@
 #include "core/workerprocess.hpp"
 #include "core/worker.hpp"
 #include "core/master.hpp"  // Pentru GlobalStats
+#include "core/eventloop.hpp"
+#include "core/trace.hpp"
+#include "http/websocket.hpp"
+#include "http/sse.hpp"
 
 #include <iostream>
 #include <unistd.h>
@@ -16,14 +20,17 @@ static void worker_signal_handler(int signum) {
     }
 }
 
-WorkerProcess::WorkerProcess(int id, Router* r, SharedQueue<int>* queue, SharedMemory* shm)
+WorkerProcess::WorkerProcess(int id, Router* r, SharedQueue<int>* queue, FdChannel* channel, SharedMemory* shm,
+                             std::vector<std::shared_ptr<TlsContext>> tls_contexts)
     : worker_id_(id),
       pid_(getpid()),
       thread_pool_(),
       router_(r),
       job_queue_(queue),
+      conn_channel_(channel),
       worker_status_shm_(shm),
-      global_stats_(nullptr) {
+      global_stats_(nullptr),
+      tls_contexts_(std::move(tls_contexts)) {
 
     // Map shared memory pentru statistici
     if (worker_status_shm_) {
@@ -56,10 +63,49 @@ void WorkerProcess::start() {
     // Setup signal handlers
     setup_signals();
 
-    // Inițializează ThreadPool cu 8 threads per worker
-    thread_pool_.init(8);
+    // Statisticile per rută se scriu în rândul acestui worker
+    if (router_ && router_->stats()) {
+        router_->stats()->set_worker(worker_id_);
+    }
+
+    // ThreadPool implicit (mărimea din set_thread_pool_size), apoi pool-urile cu nume
+    ThreadPoolStats* pool_stats = global_stats_ ? global_stats_->workers[worker_id_].pools : nullptr;
+    thread_pool_.set_stats(pool_stats);
+    thread_pool_.init(Worker::thread_pool_size());
+
+    const auto& configs = Worker::thread_pools();
+    std::vector<ThreadPool*> route_pools;
+    for (size_t i = 0; i < configs.size() && i + 1 < MAX_THREAD_POOLS; i++) {
+        auto pool = std::make_unique<ThreadPool>();
+        pool->set_stats(pool_stats ? &pool_stats[i + 1] : nullptr);
+        pool->init(configs[i].threads, configs[i].queue_limit);
+        route_pools.push_back(pool.get());
+        route_pools_.push_back(std::move(pool));
+    }
+    Worker::attach_thread_pools(std::move(route_pools));
+
+    // Limitele de concurență (copiate la fork, proprii acestui worker) se publică în rândul lui
+    if (ConcurrencyLimiter* limiter = Worker::concurrency_limiter()) {
+        limiter->set_stats(global_stats_ ? global_stats_->workers[worker_id_].concurrency : nullptr);
+    }
+
+    std::cout << "[Worker " << worker_id_ << "] Started with ThreadPool (" << thread_pool_.size() << " threads";
+    for (size_t i = 0; i < route_pools_.size(); i++) {
+        std::cout << ", " << configs[i].name << ": " << route_pools_[i]->size();
+    }
+    std::cout << ")\n";
 
-    std::cout << "[Worker " << worker_id_ << "] Started with ThreadPool (8 threads)\n";
+    // Event loop-ul worker-ului (timere, I/O async, reluare coroutine)
+    EventLoop::instance();
+
+    // Thread-ul de handshake TLS, doar dacă există listener-e TLS
+    bool has_tls = false;
+    for (const auto& tls : tls_contexts_) {
+        if (tls) has_tls = true;
+    }
+    if (has_tls) {
+        tls_acceptor_.start();
+    }
 
     // Update status
     if (global_stats_) {
@@ -69,8 +115,18 @@ void WorkerProcess::start() {
     // Start work loop
     work_loop();
 
+    // Termină cererile în curs înainte de a opri thread-urile
+    drain();
+
     // Cleanup când ieșim din loop
     thread_pool_.stop();
+    Worker::attach_thread_pools({});
+    for (auto& pool : route_pools_) {
+        pool->stop();
+    }
+    route_pools_.clear();
+    tls_acceptor_.stop();
+    EventLoop::instance().stop();
 
     if (global_stats_) {
         global_stats_->workers[worker_id_].status = 0;  // dead
@@ -82,35 +138,17 @@ void WorkerProcess::start() {
 void WorkerProcess::work_loop() {
     while (running_ && !worker_shutdown_requested) {
         try {
-            // DEQUEUE file descriptor din SharedQueue (IPC!)
-            // Dacă coada e goală, asta va arunca excepție
-
-            // Check dacă avem ceva în coadă
-            if (job_queue_->is_empty()) {
-                // Așteptăm puțin
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            // Conexiunea vine prin FdChannel (SCM_RIGHTS): kernel-ul o duplică
+            // în acest proces. Timeout scurt pentru a verifica semnalul de oprire.
+            uint32_t listener_index = 0;
+            int64_t accepted_ns = 0;
+            PeerAddress peer;
+            int client_fd = conn_channel_->receive(listener_index, 100, &accepted_ns, &peer);
+            if (client_fd < 0) {
                 continue;
             }
 
-            int client_fd = job_queue_->dequeue();
-
-            // std::cout << "[Worker " << worker_id_ << "] Got FD=" << client_fd << "\n";
-
-            // Update status - busy
-            if (global_stats_) {
-                global_stats_->workers[worker_id_].status = 2;  // busy
-            }
-
-            // Procesare în ThreadPool
-            thread_pool_.enqueue([this, client_fd]() {
-                process_request(client_fd);
-            });
-
-            // Update status - idle
-            if (global_stats_) {
-                global_stats_->workers[worker_id_].status = 1;  // idle
-                global_stats_->workers[worker_id_].requests_handled++;
-            }
+            dispatch_connection(client_fd, listener_index, accepted_ns, peer);
 
         } catch (const std::runtime_error& e) {
             // Coada goală sau altă eroare
@@ -134,15 +172,125 @@ void WorkerProcess::work_loop() {
     std::cout << "[Worker " << worker_id_ << "] Shutdown signal received, exiting work loop\n";
 }
 
-void WorkerProcess::process_request(int client_fd) {
+void WorkerProcess::dispatch_connection(int client_fd, uint32_t listener_index, int64_t accepted_ns,
+                                        const PeerAddress& peer) {
+    // Sosirea la worker se notează mereu: de aici se socotește și termenul cererii
+    Worker::ConnectionTimes times;
+    times.accepted_ns = accepted_ns;
+    times.received_ns = Trace::now_ns();
+    times.peer = peer;
+
+    // Consumă tichetul pus de Master în SharedQueue (IPC!)
     try {
-        // Folosește Worker::handle_client pentru procesarea efectivă
-        Worker::handle_client(client_fd, router_);
+        job_queue_->dequeue();
+        if (global_stats_) global_stats_->pending_connections--;
+    } catch (const std::runtime_error&) {
+        // Tichet lipsă: conexiunea e deja aici, o procesăm oricum
+    }
 
-        // Decrement active connections
-        if (global_stats_) {
-            global_stats_->active_connections--;
+    in_flight_++;
+    if (global_stats_) {
+        global_stats_->workers[worker_id_].in_flight++;
+        global_stats_->workers[worker_id_].status = 2;  // busy
+    }
+
+    std::shared_ptr<TlsContext> tls;
+    if (listener_index < tls_contexts_.size()) {
+        tls = tls_contexts_[listener_index];
+    }
+
+    if (tls) {
+        // Handshake-ul pe thread-ul TLS; cererea ajunge în ThreadPool cu fd-ul în clar
+        tls_acceptor_.accept(client_fd, tls,
+            [this, times](int plain_fd) {
+                if (global_stats_) global_stats_->workers[worker_id_].queued++;
+                thread_pool_.enqueue([this, plain_fd, times]() {
+                    process_request(plain_fd, times);
+                });
+            },
+            [this]() {
+                connection_done();
+            });
+    } else {
+        // Procesare în ThreadPool
+        if (global_stats_) global_stats_->workers[worker_id_].queued++;
+        thread_pool_.enqueue([this, client_fd, times]() {
+            process_request(client_fd, times);
+        });
+    }
+
+    if (global_stats_) {
+        global_stats_->workers[worker_id_].status = draining_ ? 3 : 1;
+        global_stats_->workers[worker_id_].requests_handled++;
+    }
+}
+
+void WorkerProcess::connection_done() {
+    in_flight_--;
+    if (global_stats_) {
+        global_stats_->active_connections--;
+        global_stats_->workers[worker_id_].in_flight--;
+        if (draining_) {
+            global_stats_->workers[worker_id_].drained++;
         }
+    }
+}
+
+void WorkerProcess::drain() {
+    draining_ = true;
+    if (global_stats_) {
+        global_stats_->workers[worker_id_].status = 3;  // draining
+    }
+
+    int timeout_ms = global_stats_ ? global_stats_->drain_timeout_ms.load() : 5000;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    // 1. Conexiunile acceptate de Master înainte de oprire sunt încă în canal
+    uint32_t listener_index = 0;
+    int64_t accepted_ns = 0;
+    PeerAddress peer;
+    int client_fd;
+    while ((client_fd = conn_channel_->receive(listener_index, 0, &accepted_ns, &peer)) >= 0) {
+        dispatch_connection(client_fd, listener_index, accepted_ns, peer);
+    }
+
+    std::cout << "[Worker " << worker_id_ << "] Draining " << in_flight_ << " connection(s), timeout "
+              << timeout_ms << "ms\n";
+
+    // 2. Conexiunile long-lived nu se termină singure: le închidem curat
+    WebSocketConnection::close_all(WebSocketClose::GOING_AWAY, "Server shutting down");
+    SseChannel::close_all_channels();
+
+    // 3. Așteptăm cererile în curs (inclusiv cele async) și punțile TLS care încă trimit
+    while ((in_flight_ > 0 || tls_acceptor_.active() > 0) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    int aborted = in_flight_.load();
+    if (global_stats_) {
+        global_stats_->workers[worker_id_].aborted += aborted;
+    }
+
+    std::cout << "[Worker " << worker_id_ << "] Drain complete: "
+              << (global_stats_ ? global_stats_->workers[worker_id_].drained.load() : 0) << " drained, "
+              << aborted << " aborted\n";
+
+    if (tls_acceptor_.handshakes() > 0) {
+        std::cout << "[Worker " << worker_id_ << "] TLS: " << tls_acceptor_.handshakes() << " handshakes, "
+                  << tls_acceptor_.resumed() << " resumed, " << tls_acceptor_.ktls() << " kTLS\n";
+    }
+}
+
+void WorkerProcess::process_request(int client_fd, Worker::ConnectionTimes times) {
+    if (global_stats_) global_stats_->workers[worker_id_].queued--;
+
+    try {
+        // Folosește Worker::handle_client pentru procesarea efectivă.
+        // Pentru rute async, callback-ul rulează când handler-ul răspunde,
+        // nu ține thread-ul din pool ocupat.
+        Worker::handle_client(client_fd, router_, [this]() {
+            connection_done();
+        }, times);
     } catch (const std::exception& e) {
         std::cerr << "[Worker " << worker_id_ << "] Failed to process request: "
                  << e.what() << "\n";
@@ -153,6 +301,7 @@ void WorkerProcess::process_request(int client_fd) {
         }
 
         close(client_fd);
+        connection_done();
     }
 }
 
@@ -19,6 +19,7 @@ ConnectionPool::ConnectionPool(size_t min, size_t max,
             pool_.push_back(std::move(pc));
             current_size_++;
             total_created_++;
+            open_count_++;
         } catch (const std::exception& e) {
             std::cerr << "[ConnectionPool] Failed to create connection: " << e.what() << "\n";
         }
@@ -50,6 +51,7 @@ ConnectionPool::PooledConnectionGuard ConnectionPool::acquire(std::chrono::milli
 
     if (!acquired) {
         wait_count_++;
+        timeouts_++;
         throw std::runtime_error("Connection pool timeout");
     }
 
@@ -59,6 +61,7 @@ ConnectionPool::PooledConnectionGuard ConnectionPool::acquire(std::chrono::milli
             pc.in_use = true;
             pc.last_used = std::chrono::steady_clock::now();
             total_acquired_++;
+            in_use_count_++;
 
             auto wait_time = std::chrono::steady_clock::now() - start_wait;
             wait_time_ms_ += std::chrono::duration_cast<std::chrono::milliseconds>(wait_time).count();
@@ -80,6 +83,8 @@ ConnectionPool::PooledConnectionGuard ConnectionPool::acquire(std::chrono::milli
         current_size_++;
         total_created_++;
         total_acquired_++;
+        open_count_++;
+        in_use_count_++;
 
         return PooledConnectionGuard(this, &pool_.back());
     }
@@ -90,6 +95,7 @@ ConnectionPool::PooledConnectionGuard ConnectionPool::acquire(std::chrono::milli
 void ConnectionPool::release(PooledConnection* conn) {
     std::unique_lock<std::mutex> lock(pool_mutex_);
     conn->in_use = false;
+    in_use_count_--;
     conn->last_used = std::chrono::steady_clock::now();
     pool_cv_.notify_one();
 }
@@ -106,6 +112,7 @@ void ConnectionPool::prune_idle_connections() {
                 if (idle_time > idle_timeout_) {
                     current_size_--;
                     total_destroyed_++;
+                    open_count_--;
                     return true;
                 }
             }
@@ -116,23 +123,19 @@ void ConnectionPool::prune_idle_connections() {
 }
 
 ConnectionPool::Stats ConnectionPool::get_stats() const {
-    std::unique_lock<std::mutex> lock(pool_mutex_);
-
     Stats s;
-    s.total_connections = current_size_;
-    s.active_connections = 0;
-    s.idle_connections = 0;
-
-    for (const auto& pc : pool_) {
-        if (pc.in_use) s.active_connections++;
-        else s.idle_connections++;
-    }
+    s.total_connections = open_count_.load();
+    s.active_connections = std::min(in_use_count_.load(), s.total_connections);
+    s.idle_connections = s.total_connections - s.active_connections;
+    s.max_connections = max_size_;
 
     s.total_acquired = total_acquired_.load();
     s.total_created = total_created_.load();
     s.total_destroyed = total_destroyed_.load();
     s.wait_count = wait_count_.load();
-    s.avg_wait_time_ms = wait_count_ > 0 ? wait_time_ms_.load() / wait_count_.load() : 0;
+    uint64_t waits = wait_count_.load();
+    s.avg_wait_time_ms = waits > 0 ? wait_time_ms_.load() / waits : 0;
+    s.timeouts = timeouts_.load();
 
     return s;
 }
@@ -1,4 +1,6 @@
 #include "data/sqlitedatabase.hpp"
+#include "core/trace.hpp"
+#include "core/cancellation.hpp"
 #include <iostream>
 
 static int cb_rows(void* data, int argc, char** argv, char** colnames) {
@@ -11,6 +13,28 @@ static int cb_rows(void* data, int argc, char** argv, char** colnames) {
     return 0;
 }
 
+// Pe durata unei interogări: dacă cererea curentă e anulată (termen trecut,
+// client deconectat), sqlite3_interrupt o oprește cu SQLITE_INTERRUPT.
+// Înregistrarea se scoate înainte ca conexiunea să poată fi refolosită.
+class InterruptOnCancel {
+public:
+    explicit InterruptOnCancel(sqlite3* db) : state_(Cancellation::current()), id_(0) {
+        if (state_) id_ = state_->on_cancel([db]() { sqlite3_interrupt(db); });
+    }
+    ~InterruptOnCancel() {
+        if (id_) state_->remove(id_);
+    }
+    InterruptOnCancel(const InterruptOnCancel&) = delete;
+    InterruptOnCancel& operator=(const InterruptOnCancel&) = delete;
+
+    // Cererea era deja anulată: interogarea nu mai pornește
+    bool cancelled() const { return state_ && id_ == 0; }
+
+private:
+    CancellationState* state_;
+    uint64_t id_;
+};
+
 bool SqliteDatabase::connect(const std::map<std::string,std::string>& cfg) {
     auto it = cfg.find("file");
     if (it == cfg.end()) return false;
@@ -30,6 +54,12 @@ void SqliteDatabase::disconnect() {
 }
 
 bool SqliteDatabase::execute(const std::string& sql) {
+    Trace::Scope span(SpanKind::Db, sql);
+    InterruptOnCancel interrupt(db);
+    if (interrupt.cancelled()) {
+        std::cerr << "SQLite exec anulat: cererea a fost anulată\n";
+        return false;
+    }
     char* err = nullptr;
     if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &err) != SQLITE_OK) {
         std::cerr << "SQLite exec error: " << (err ? err : "") << "\n";
@@ -40,7 +70,13 @@ bool SqliteDatabase::execute(const std::string& sql) {
 }
 
 std::vector<std::map<std::string,std::string>> SqliteDatabase::query(const std::string& sql) {
+    Trace::Scope span(SpanKind::Db, sql);
     std::vector<std::map<std::string,std::string>> rows;
+    InterruptOnCancel interrupt(db);
+    if (interrupt.cancelled()) {
+        std::cerr << "SQLite query anulat: cererea a fost anulată\n";
+        return rows;
+    }
     char* err = nullptr;
     if (sqlite3_exec(db, sql.c_str(), cb_rows, &rows, &err) != SQLITE_OK) {
         std::cerr << "SQLite query error: " << (err ? err : "") << "\n";
@@ -0,0 +1,220 @@
+#include "http/body.hpp"
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
+static constexpr size_t READ_SIZE = 64 * 1024;
+static constexpr size_t MAX_LINE = 8 * 1024;   // Linie chunk-size sau trailer
+
+BodyReader::BodyReader(int fd, std::string prefetched, const HttpRequest& request, size_t max_size)
+    : fd_(fd), buf_(std::move(prefetched)), state_(State::DONE), max_size_(max_size) {
+    try {
+        init(request);
+    } catch (const BodyError& e) {
+        error_status_ = e.status();
+        error_ = e.what();
+        state_ = State::DONE;
+    }
+}
+
+void BodyReader::init(const HttpRequest& request) {
+    std::string encoding = request.getHeader("Transfer-Encoding");
+    std::string length = request.getHeader("Content-Length");
+
+    if (!encoding.empty()) {
+        // Singurul transfer-coding suportat; Content-Length e ignorat (RFC 9112)
+        if (strcasestr(encoding.c_str(), "chunked") == nullptr) {
+            throw BodyError(400, "Transfer-Encoding nesuportat: " + encoding);
+        }
+        chunked_ = true;
+        content_length_ = -1;
+        state_ = State::CHUNK_SIZE;
+    } else if (!length.empty()) {
+        char* end = nullptr;
+        errno = 0;
+        unsigned long long value = std::strtoull(length.c_str(), &end, 10);
+        if (errno != 0 || end == length.c_str() || *end != '\0' || length[0] == '-') {
+            throw BodyError(400, "Content-Length invalid: " + length);
+        }
+        if (value > max_size_) {
+            throw BodyError(413, "Corp prea mare: " + length + " octeți");
+        }
+        content_length_ = static_cast<int64_t>(value);
+        remaining_ = value;
+        state_ = (value > 0) ? State::DATA : State::DONE;
+
+        // Octeții de după corp nu aparțin cererii (fără keep-alive)
+        if (buf_.size() > value) buf_.resize(value);
+    } else {
+        // Fără Content-Length/chunked nu există corp
+        buf_.clear();
+    }
+
+    if (state_ == State::DONE || fd_ < 0) return;
+
+    // Clientul așteaptă "100 Continue" înainte să trimită corpul (ex. curl pentru upload-uri mari)
+    std::string expect = request.getHeader("Expect");
+    expect_continue_ = buf_.empty() && strcasecmp(expect.c_str(), "100-continue") == 0;
+
+    // Un client care nu mai trimite nu ține thread-ul ocupat la nesfârșit
+    struct timeval tv;
+    tv.tv_sec = IDLE_TIMEOUT_SECONDS;
+    tv.tv_usec = 0;
+    setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+}
+
+// recv cu tratarea erorilor; 0 = EOF
+static size_t recv_some(int fd, char* data, size_t len) {
+    while (true) {
+        ssize_t n = ::recv(fd, data, len, 0);
+        if (n >= 0) return static_cast<size_t>(n);
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            throw BodyError(408, "Timeout la citirea corpului");
+        }
+        throw BodyError(400, std::string("Eroare la citirea corpului: ") + strerror(errno));
+    }
+}
+
+bool BodyReader::fill() {
+    if (fd_ < 0) return false;
+
+    if (expect_continue_) {
+        static const char CONTINUE[] = "HTTP/1.1 100 Continue\r\n\r\n";
+        ::send(fd_, CONTINUE, sizeof(CONTINUE) - 1, MSG_NOSIGNAL);
+        expect_continue_ = false;
+    }
+
+    // Compactare: datele consumate nu mai sunt necesare
+    if (pos_ > 0) {
+        buf_.erase(0, pos_);
+        pos_ = 0;
+    }
+
+    size_t old_size = buf_.size();
+    buf_.resize(old_size + READ_SIZE);
+    size_t n = recv_some(fd_, &buf_[old_size], READ_SIZE);
+    buf_.resize(old_size + n);
+    return n > 0;
+}
+
+bool BodyReader::read_line(std::string& line) {
+    while (true) {
+        size_t end = buf_.find("\r\n", pos_);
+        if (end != std::string::npos) {
+            line.assign(buf_, pos_, end - pos_);
+            pos_ = end + 2;
+            return true;
+        }
+        if (buf_.size() - pos_ > MAX_LINE) {
+            throw BodyError(400, "Linie chunked prea lungă");
+        }
+        if (!fill()) return false;
+    }
+}
+
+void BodyReader::take(std::string& chunk, size_t max_chunk) {
+    size_t n = std::min<uint64_t>({buf_.size() - pos_, remaining_, max_chunk});
+    chunk.assign(buf_, pos_, n);
+    pos_ += n;
+    remaining_ -= n;
+    bytes_read_ += n;
+}
+
+bool BodyReader::next(std::string& chunk, size_t max_chunk) {
+    chunk.clear();
+    if (error_status_) throw BodyError(error_status_, error_);
+    if (max_chunk == 0) max_chunk = READ_SIZE;
+
+    std::string line;
+    while (true) {
+        switch (state_) {
+            case State::DONE:
+                return false;
+
+            case State::DATA:
+                if (pos_ < buf_.size()) {
+                    take(chunk, max_chunk);
+                } else {
+                    // Buffer gol: recv direct în fragmentul returnat, fără copie intermediară
+                    if (fd_ < 0) throw BodyError(400, "Corp incomplet");
+                    if (expect_continue_) {
+                        if (!fill()) throw BodyError(400, "Corp incomplet");
+                        continue;
+                    }
+                    chunk.resize(std::min<uint64_t>(remaining_, max_chunk));
+                    size_t n = recv_some(fd_, &chunk[0], chunk.size());
+                    if (n == 0) throw BodyError(400, "Corp incomplet");
+                    chunk.resize(n);
+                    remaining_ -= n;
+                    bytes_read_ += n;
+                }
+                if (remaining_ == 0) state_ = State::DONE;
+                return true;
+
+            case State::CHUNK_SIZE: {
+                if (!read_line(line)) throw BodyError(400, "Corp chunked incomplet");
+
+                // "1a2b;extensie=..." - extensiile sunt ignorate
+                char* end = nullptr;
+                errno = 0;
+                unsigned long long size = std::strtoull(line.c_str(), &end, 16);
+                if (errno != 0 || end == line.c_str() || (*end != '\0' && *end != ';' && *end != ' ')) {
+                    throw BodyError(400, "Dimensiune chunk invalidă");
+                }
+                if (size == 0) {
+                    state_ = State::TRAILERS;
+                    continue;
+                }
+                if (size > max_size_ || bytes_read_ + size > max_size_) {
+                    throw BodyError(413, "Corp prea mare");
+                }
+                remaining_ = size;
+                state_ = State::CHUNK_DATA;
+                continue;
+            }
+
+            case State::CHUNK_DATA:
+                if (pos_ == buf_.size() && !fill()) throw BodyError(400, "Corp chunked incomplet");
+                take(chunk, max_chunk);
+                if (remaining_ == 0) state_ = State::CHUNK_CRLF;
+                return true;
+
+            case State::CHUNK_CRLF:
+                if (!read_line(line) || !line.empty()) throw BodyError(400, "Chunk fără CRLF final");
+                state_ = State::CHUNK_SIZE;
+                continue;
+
+            case State::TRAILERS:
+                // Trailer-ele sunt ignorate; linia goală încheie corpul
+                if (!read_line(line)) throw BodyError(400, "Corp chunked incomplet");
+                if (line.empty()) {
+                    state_ = State::DONE;
+                    return false;
+                }
+                continue;
+        }
+    }
+}
+
+void BodyReader::read_all(std::string& out) {
+    if (content_length_ > 0) {
+        out.reserve(out.size() + static_cast<size_t>(content_length_));
+    }
+
+    std::string chunk;
+    while (next(chunk, READ_SIZE)) {
+        out += chunk;
+    }
+}
+
+void BodyReader::discard() {
+    std::string chunk;
+    while (next(chunk, READ_SIZE)) {
+    }
+}
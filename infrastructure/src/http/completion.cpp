@@ -0,0 +1,39 @@
+#include "http/completion.hpp"
+#include <atomic>
+#include <iostream>
+
+struct ResponseCompletion::State {
+    Sink sink;
+    std::atomic<bool> completed{false};
+
+    explicit State(Sink s) : sink(std::move(s)) {}
+
+    ~State() {
+        // Handler-ul a pierdut handle-ul fără să răspundă
+        if (!completed.load() && sink) {
+            std::cerr << "[Completion] Răspuns abandonat, trimit 500\n";
+            std::string body = "{\"error\":\"Response not completed\"}";
+            sink("HTTP/1.1 500 Internal Server Error\r\n"
+                 "Content-Type: application/json\r\n"
+                 "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                 "Connection: close\r\n\r\n" + body);
+        }
+    }
+};
+
+ResponseCompletion::ResponseCompletion(Sink sink)
+    : state_(std::make_shared<State>(std::move(sink))) {}
+
+bool ResponseCompletion::complete(const std::string& raw_response) const {
+    if (!state_ || state_->completed.exchange(true)) {
+        return false;
+    }
+    if (state_->sink) {
+        state_->sink(raw_response);
+    }
+    return true;
+}
+
+bool ResponseCompletion::is_completed() const {
+    return state_ && state_->completed.load();
+}
@@ -0,0 +1,70 @@
+#include "http/cors.hpp"
+
+static std::string trim(const std::string& s) {
+    size_t start = s.find_first_not_of(" \t");
+    if (start == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t");
+    return s.substr(start, end - start + 1);
+}
+
+CorsPolicy::CorsPolicy(const CorsConfig& config) {
+    // Lista de origini
+    size_t start = 0;
+    while (start <= config.allow_origins.size()) {
+        size_t comma = config.allow_origins.find(',', start);
+        if (comma == std::string::npos) comma = config.allow_origins.size();
+        std::string origin = trim(config.allow_origins.substr(start, comma - start));
+        if (!origin.empty()) origins_.push_back(origin);
+        start = comma + 1;
+    }
+    if (origins_.empty()) origins_.push_back("*");
+
+    // Cu credențiale browser-ul nu acceptă "*": originea e întoarsă din cerere
+    fixed_origin_ = origins_.size() == 1 && !(origins_[0] == "*" && config.allow_credentials);
+
+    common_headers_ = "Access-Control-Allow-Methods: " + config.allow_methods + "\r\n";
+    common_headers_ += "Access-Control-Allow-Headers: " + config.allow_headers + "\r\n";
+    if (!config.expose_headers.empty()) {
+        common_headers_ += "Access-Control-Expose-Headers: " + config.expose_headers + "\r\n";
+    }
+    if (config.allow_credentials) {
+        common_headers_ += "Access-Control-Allow-Credentials: true\r\n";
+    }
+
+    preflight_extra_ = "Access-Control-Max-Age: " + std::to_string(config.max_age) + "\r\n";
+
+    if (fixed_origin_) {
+        fixed_headers_ = "Access-Control-Allow-Origin: " + origins_[0] + "\r\n" + common_headers_;
+        fixed_preflight_ = "HTTP/1.1 204 No Content\r\n" + fixed_headers_ + preflight_extra_ +
+                           "Content-Length: 0\r\nConnection: close\r\n\r\n";
+    }
+}
+
+bool CorsPolicy::origin_allowed(const std::string& origin) const {
+    if (origin.empty()) return false;
+    for (const auto& allowed : origins_) {
+        if (allowed == "*" || allowed == origin) return true;
+    }
+    return false;
+}
+
+std::string CorsPolicy::headers_for(const HttpRequest& request) const {
+    if (fixed_origin_) {
+        return fixed_headers_;
+    }
+
+    std::string origin = request.getHeader("Origin");
+    if (!origin_allowed(origin)) {
+        // Fără Allow-Origin browser-ul blochează; Vary rămâne pentru cache-uri
+        return "Vary: Origin\r\n";
+    }
+    return "Access-Control-Allow-Origin: " + origin + "\r\nVary: Origin\r\n" + common_headers_;
+}
+
+std::string CorsPolicy::preflight_response(const HttpRequest& request) const {
+    if (fixed_origin_) {
+        return fixed_preflight_;
+    }
+    return "HTTP/1.1 204 No Content\r\n" + headers_for(request) + preflight_extra_ +
+           "Content-Length: 0\r\nConnection: close\r\n\r\n";
+}
@@ -0,0 +1,495 @@
+#include "http/metrics.hpp"
+#include "core/master.hpp"
+#include "core/worker.hpp"
+#include "http/router.hpp"
+#include "http/routestats.hpp"
+#include "data/connectionpool.hpp"
+#include "http/ratelimit.hpp"
+#include "core/concurrencylimit.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+// Limitele (în secunde) ale histogramei exportate. Histograma internă are
+// 8 bucket-uri pe putere a lui 2: un bucket intră sub limita `le` dacă tot
+// intervalul lui e sub ea, deci valorile sunt rotunjite cu ~12%.
+static const double LATENCY_BOUNDS[] = {
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025,
+    0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0
+};
+
+static const char* STATUS_CLASSES[] = {"1xx", "2xx", "3xx", "4xx", "5xx"};
+
+static void append_escaped(std::string& out, std::string_view value) {
+    for (char c : value) {
+        if (c == '\\') out += "\\\\";
+        else if (c == '"') out += "\\\"";
+        else if (c == '\n') out += "\\n";
+        else out += c;
+    }
+}
+
+static std::string format_double(double value) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", value);
+    return buf;
+}
+
+void MetricsWriter::family(std::string_view name, std::string_view help, std::string_view type) {
+    out_ += "# HELP ";
+    out_ += name;
+    out_ += ' ';
+    out_ += help;
+    out_ += "\n# TYPE ";
+    out_ += name;
+    out_ += ' ';
+    out_ += type;
+    out_ += '\n';
+}
+
+void MetricsWriter::begin_sample(std::string_view name, std::initializer_list<Label> labels) {
+    out_ += name;
+    if (labels.size() > 0) {
+        out_ += '{';
+        bool first = true;
+        for (const auto& label : labels) {
+            if (!first) out_ += ',';
+            first = false;
+            out_ += label.first;
+            out_ += "=\"";
+            append_escaped(out_, label.second);
+            out_ += '"';
+        }
+        out_ += '}';
+    }
+    out_ += ' ';
+}
+
+void MetricsWriter::sample(std::string_view name, std::initializer_list<Label> labels, double value) {
+    begin_sample(name, labels);
+    out_ += format_double(value);
+    out_ += '\n';
+}
+
+void MetricsWriter::sample(std::string_view name, std::initializer_list<Label> labels, uint64_t value) {
+    begin_sample(name, labels);
+    out_ += std::to_string(value);
+    out_ += '\n';
+}
+
+void MetricsWriter::sample(std::string_view name, std::initializer_list<Label> labels, int64_t value) {
+    begin_sample(name, labels);
+    out_ += std::to_string(value);
+    out_ += '\n';
+}
+
+namespace Metrics {
+
+void write_server(MetricsWriter& out, const GlobalStats& stats) {
+    int workers = stats.num_workers.load(std::memory_order_relaxed);
+    if (workers < 0) workers = 0;
+    if (workers > MAX_WORKERS) workers = MAX_WORKERS;
+
+    // Citite o singură dată: fiecare familie vede aceleași valori
+    struct WorkerRow {
+        std::string id;
+        int status;
+        uint64_t handled, failed, drained, aborted;
+        int in_flight, queued;
+    };
+    std::vector<WorkerRow> rows;
+    int alive = 0;
+    bool draining = false;
+    for (int i = 0; i < workers; i++) {
+        const WorkerStats& w = stats.workers[i];
+        WorkerRow row;
+        row.id = std::to_string(i);
+        row.status = w.status.load(std::memory_order_relaxed);
+        row.handled = w.requests_handled.load(std::memory_order_relaxed);
+        row.failed = w.requests_failed.load(std::memory_order_relaxed);
+        row.drained = w.drained.load(std::memory_order_relaxed);
+        row.aborted = w.aborted.load(std::memory_order_relaxed);
+        row.in_flight = w.in_flight.load(std::memory_order_relaxed);
+        row.queued = w.queued.load(std::memory_order_relaxed);
+        if (row.status != 0) alive++;
+        if (row.status == 3) draining = true;
+        rows.push_back(row);
+    }
+
+    // Sănătate
+    out.family("rest_api_healthy", "1 when every worker is alive and none is draining", "gauge");
+    out.sample("rest_api_healthy", {}, static_cast<int64_t>(alive == workers && !draining ? 1 : 0));
+
+    out.family("rest_api_start_time_seconds", "Unix time the master process started", "gauge");
+    out.sample("rest_api_start_time_seconds", {}, static_cast<int64_t>(stats.start_time.load(std::memory_order_relaxed)));
+
+    out.family("rest_api_workers", "Configured worker processes", "gauge");
+    out.sample("rest_api_workers", {}, static_cast<int64_t>(workers));
+
+    out.family("rest_api_worker_restarts_total", "Workers restarted after an unexpected exit", "counter");
+    out.sample("rest_api_worker_restarts_total", {}, stats.worker_restarts.load(std::memory_order_relaxed));
+
+    out.family("rest_api_worker_up", "1 while the worker process is running", "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_worker_up", {{"worker", row.id}}, static_cast<int64_t>(row.status != 0 ? 1 : 0));
+    }
+
+    out.family("rest_api_worker_draining", "1 while the worker finishes its requests before exiting", "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_worker_draining", {{"worker", row.id}}, static_cast<int64_t>(row.status == 3 ? 1 : 0));
+    }
+
+    // Conexiuni
+    out.family("rest_api_connections_total", "Connections accepted and passed to a worker", "counter");
+    out.sample("rest_api_connections_total", {}, stats.total_requests.load(std::memory_order_relaxed));
+
+    out.family("rest_api_connection_errors_total", "Connections dropped before or during processing", "counter");
+    out.sample("rest_api_connection_errors_total", {}, stats.total_errors.load(std::memory_order_relaxed));
+
+    out.family("rest_api_active_connections", "Connections passed to a worker and not finished", "gauge");
+    out.sample("rest_api_active_connections", {},
+               static_cast<int64_t>(stats.active_connections.load(std::memory_order_relaxed)));
+
+    out.family("rest_api_worker_connections_total", "Connections received per worker", "counter");
+    for (const auto& row : rows) {
+        out.sample("rest_api_worker_connections_total", {{"worker", row.id}}, row.handled);
+    }
+
+    out.family("rest_api_worker_failures_total", "Connections a worker failed to process", "counter");
+    for (const auto& row : rows) {
+        out.sample("rest_api_worker_failures_total", {{"worker", row.id}}, row.failed);
+    }
+
+    out.family("rest_api_worker_in_flight", "Connections a worker is processing", "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_worker_in_flight", {{"worker", row.id}}, static_cast<int64_t>(row.in_flight));
+    }
+
+    out.family("rest_api_worker_drained_total", "Connections finished while the worker was draining", "counter");
+    for (const auto& row : rows) {
+        out.sample("rest_api_worker_drained_total", {{"worker", row.id}}, row.drained);
+    }
+
+    out.family("rest_api_worker_aborted_total", "Connections still open when the drain timeout expired", "counter");
+    for (const auto& row : rows) {
+        out.sample("rest_api_worker_aborted_total", {{"worker", row.id}}, row.aborted);
+    }
+
+    // Cozi
+    out.family("rest_api_pending_connections", "Accepted connections not yet picked up by a worker", "gauge");
+    out.sample("rest_api_pending_connections", {},
+               static_cast<int64_t>(stats.pending_connections.load(std::memory_order_relaxed)));
+
+    out.family("rest_api_pending_connections_capacity", "Size of the master's connection queue", "gauge");
+    out.sample("rest_api_pending_connections_capacity", {},
+               static_cast<int64_t>(stats.queue_capacity.load(std::memory_order_relaxed)));
+
+    out.family("rest_api_worker_queued", "Connections waiting for a thread in the worker's pool", "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_worker_queued", {{"worker", row.id}}, static_cast<int64_t>(row.queued));
+    }
+}
+
+void write_routes(MetricsWriter& out, const RouteStats& stats, const Router& router) {
+    struct RouteRow {
+        std::string_view method;
+        std::string_view route;
+        RouteStatsSnapshot snapshot;
+    };
+
+    // Rutele fără cereri nu apar (ca la orice client Prometheus, seria apare la prima observație)
+    std::vector<RouteRow> rows;
+    size_t count = std::min(stats.route_count(), router.routeCount());
+    for (size_t i = 0; i <= count; i++) {
+        size_t index = i < count ? i : stats.other();
+        RouteRow row;
+        row.snapshot = stats.snapshot(index);
+        if (row.snapshot.requests == 0) continue;
+        if (i < count) {
+            row.method = router.routeAt(i).method;
+            row.route = router.routeAt(i).pattern;
+        } else {
+            row.method = "*";
+            row.route = "*";
+        }
+        rows.push_back(std::move(row));
+    }
+
+    out.family("rest_api_http_requests_total", "Requests answered, by route and status class", "counter");
+    for (const auto& row : rows) {
+        for (int c = 0; c < 5; c++) {
+            if (row.snapshot.status[c] == 0) continue;
+            out.sample("rest_api_http_requests_total",
+                       {{"method", row.method}, {"route", row.route}, {"code", STATUS_CLASSES[c]}},
+                       row.snapshot.status[c]);
+        }
+    }
+
+    out.family("rest_api_http_request_duration_seconds",
+               "Time from picking up the connection to writing the response", "histogram");
+    for (const auto& row : rows) {
+        const RouteStatsSnapshot& s = row.snapshot;
+        int bucket = 0;
+        uint64_t cumulative = 0;
+        for (double bound : LATENCY_BOUNDS) {
+            uint64_t bound_us = static_cast<uint64_t>(bound * 1e6);
+            while (bucket < LatencyHistogram::BUCKETS && LatencyHistogram::bucket_upper(bucket) <= bound_us) {
+                cumulative += s.histogram[bucket++];
+            }
+            std::string le = format_double(bound);
+            out.sample("rest_api_http_request_duration_seconds_bucket",
+                       {{"method", row.method}, {"route", row.route}, {"le", le}}, cumulative);
+        }
+        out.sample("rest_api_http_request_duration_seconds_bucket",
+                   {{"method", row.method}, {"route", row.route}, {"le", "+Inf"}}, s.requests);
+        out.sample("rest_api_http_request_duration_seconds_sum",
+                   {{"method", row.method}, {"route", row.route}}, static_cast<double>(s.latency_sum_us) / 1e6);
+        out.sample("rest_api_http_request_duration_seconds_count",
+                   {{"method", row.method}, {"route", row.route}}, s.requests);
+    }
+
+    out.family("rest_api_http_request_bytes_total", "Request bytes (headers + declared body)", "counter");
+    for (const auto& row : rows) {
+        out.sample("rest_api_http_request_bytes_total", {{"method", row.method}, {"route", row.route}},
+                   row.snapshot.bytes_in);
+    }
+
+    out.family("rest_api_http_response_bytes_total", "Response bytes written", "counter");
+    for (const auto& row : rows) {
+        out.sample("rest_api_http_response_bytes_total", {{"method", row.method}, {"route", row.route}},
+                   row.snapshot.bytes_out);
+    }
+}
+
+void write_pools(MetricsWriter& out, const std::vector<std::pair<std::string, const ConnectionPool*>>& pools,
+                 int worker) {
+    if (pools.empty()) return;
+
+    std::string worker_id = worker >= 0 ? std::to_string(worker) : std::string();
+    std::vector<std::pair<std::string_view, ConnectionPool::Stats>> rows;
+    for (const auto& pool : pools) {
+        if (pool.second) rows.emplace_back(pool.first, pool.second->get_stats());
+    }
+
+    out.family("rest_api_db_pool_connections", "Open database connections by state", "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_db_pool_connections", {{"pool", row.first}, {"worker", worker_id}, {"state", "active"}},
+                   static_cast<uint64_t>(row.second.active_connections));
+        out.sample("rest_api_db_pool_connections", {{"pool", row.first}, {"worker", worker_id}, {"state", "idle"}},
+                   static_cast<uint64_t>(row.second.idle_connections));
+    }
+
+    out.family("rest_api_db_pool_max_connections", "Largest number of connections the pool opens", "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_db_pool_max_connections", {{"pool", row.first}, {"worker", worker_id}},
+                   static_cast<uint64_t>(row.second.max_connections));
+    }
+
+    out.family("rest_api_db_pool_acquired_total", "Connections handed out by the pool", "counter");
+    for (const auto& row : rows) {
+        out.sample("rest_api_db_pool_acquired_total", {{"pool", row.first}, {"worker", worker_id}},
+                   row.second.total_acquired);
+    }
+
+    out.family("rest_api_db_pool_created_total", "Database connections opened", "counter");
+    for (const auto& row : rows) {
+        out.sample("rest_api_db_pool_created_total", {{"pool", row.first}, {"worker", worker_id}},
+                   row.second.total_created);
+    }
+
+    out.family("rest_api_db_pool_destroyed_total", "Idle database connections closed", "counter");
+    for (const auto& row : rows) {
+        out.sample("rest_api_db_pool_destroyed_total", {{"pool", row.first}, {"worker", worker_id}},
+                   row.second.total_destroyed);
+    }
+
+    out.family("rest_api_db_pool_timeouts_total", "Acquire calls that timed out waiting for a connection", "counter");
+    for (const auto& row : rows) {
+        out.sample("rest_api_db_pool_timeouts_total", {{"pool", row.first}, {"worker", worker_id}},
+                   row.second.timeouts);
+    }
+
+    out.family("rest_api_db_pool_wait_seconds_avg", "Average time acquire() waited for a connection", "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_db_pool_wait_seconds_avg", {{"pool", row.first}, {"worker", worker_id}},
+                   static_cast<double>(row.second.avg_wait_time_ms) / 1e3);
+    }
+}
+
+void write_thread_pools(MetricsWriter& out, const GlobalStats& stats) {
+    int workers = stats.num_workers.load(std::memory_order_relaxed);
+    if (workers < 0) workers = 0;
+    if (workers > MAX_WORKERS) workers = MAX_WORKERS;
+
+    // Numele vin din configurația setată înainte de fork, aceeași în toate procesele
+    std::vector<std::string> names = {"default"};
+    for (const auto& pool : Worker::thread_pools()) {
+        if (names.size() >= MAX_THREAD_POOLS) break;
+        names.push_back(pool.name);
+    }
+
+    struct PoolRow {
+        std::string worker;
+        std::string_view pool;
+        int threads, busy, queued, queue_limit;
+        uint64_t completed, rejected;
+    };
+    std::vector<PoolRow> rows;
+    for (int w = 0; w < workers; w++) {
+        if (stats.workers[w].status.load(std::memory_order_relaxed) == 0) continue;
+        for (size_t p = 0; p < names.size(); p++) {
+            const ThreadPoolStats& pool = stats.workers[w].pools[p];
+            PoolRow row;
+            row.worker = std::to_string(w);
+            row.pool = names[p];
+            row.threads = pool.threads.load(std::memory_order_relaxed);
+            row.busy = pool.busy.load(std::memory_order_relaxed);
+            row.queued = pool.queued.load(std::memory_order_relaxed);
+            row.queue_limit = pool.queue_limit.load(std::memory_order_relaxed);
+            row.completed = pool.completed.load(std::memory_order_relaxed);
+            row.rejected = pool.rejected.load(std::memory_order_relaxed);
+            rows.push_back(row);
+        }
+    }
+    if (rows.empty()) return;
+
+    out.family("rest_api_thread_pool_threads", "Threads in a worker's pool", "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_thread_pool_threads", {{"worker", row.worker}, {"pool", row.pool}},
+                   static_cast<int64_t>(row.threads));
+    }
+
+    out.family("rest_api_thread_pool_busy", "Pool threads running a request", "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_thread_pool_busy", {{"worker", row.worker}, {"pool", row.pool}},
+                   static_cast<int64_t>(row.busy));
+    }
+
+    out.family("rest_api_thread_pool_queued", "Requests waiting for a pool thread", "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_thread_pool_queued", {{"worker", row.worker}, {"pool", row.pool}},
+                   static_cast<int64_t>(row.queued));
+    }
+
+    out.family("rest_api_thread_pool_queue_limit", "Requests that may wait for a pool thread (0 = unbounded)",
+               "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_thread_pool_queue_limit", {{"worker", row.worker}, {"pool", row.pool}},
+                   static_cast<int64_t>(row.queue_limit));
+    }
+
+    out.family("rest_api_thread_pool_completed_total", "Requests run by a pool", "counter");
+    for (const auto& row : rows) {
+        out.sample("rest_api_thread_pool_completed_total", {{"worker", row.worker}, {"pool", row.pool}},
+                   row.completed);
+    }
+
+    out.family("rest_api_thread_pool_rejected_total", "Requests answered 503 because the pool queue was full",
+               "counter");
+    for (const auto& row : rows) {
+        out.sample("rest_api_thread_pool_rejected_total", {{"worker", row.worker}, {"pool", row.pool}},
+                   row.rejected);
+    }
+}
+
+static std::string_view policy_label(const RateLimitPolicy& policy) {
+    return policy.prefix.empty() ? std::string_view("default") : std::string_view(policy.prefix);
+}
+
+void write_rate_limits(MetricsWriter& out, const RateLimiter& limiter) {
+    const auto& policies = limiter.policies();
+    if (policies.empty()) return;
+
+    out.family("rest_api_rate_limit_allowed_total", "Requests admitted by a rate limit policy", "counter");
+    for (size_t i = 0; i < policies.size(); i++) {
+        out.sample("rest_api_rate_limit_allowed_total", {{"policy", policy_label(policies[i])}},
+                   limiter.allowed(static_cast<int>(i)));
+    }
+
+    out.family("rest_api_rate_limited_total", "Requests rejected with 429 by a rate limit policy", "counter");
+    for (size_t i = 0; i < policies.size(); i++) {
+        out.sample("rest_api_rate_limited_total", {{"policy", policy_label(policies[i])}},
+                   limiter.limited(static_cast<int>(i)));
+    }
+
+    out.family("rest_api_rate_limit_saturated_total",
+               "Requests let through because every bucket in the probe window was in use", "counter");
+    out.sample("rest_api_rate_limit_saturated_total", {}, limiter.saturated());
+}
+
+void write_concurrency_limits(MetricsWriter& out, const GlobalStats& stats, const ConcurrencyLimiter& limiter) {
+    const auto& policies = limiter.policies();
+    if (policies.empty()) return;
+
+    int workers = stats.num_workers.load(std::memory_order_relaxed);
+    if (workers < 0) workers = 0;
+    if (workers > MAX_WORKERS) workers = MAX_WORKERS;
+
+    struct GroupRow {
+        std::string worker;
+        std::string_view group;
+        const ConcurrencyStats* stats;
+    };
+    std::vector<GroupRow> rows;
+    for (int w = 0; w < workers; w++) {
+        if (stats.workers[w].status.load(std::memory_order_relaxed) == 0) continue;
+        for (size_t g = 0; g < policies.size() && g < ConcurrencyLimiter::MAX_GROUPS; g++) {
+            std::string_view group = policies[g].prefix.empty() ? std::string_view("default")
+                                                                : std::string_view(policies[g].prefix);
+            rows.push_back({std::to_string(w), group, &stats.workers[w].concurrency[g]});
+        }
+    }
+    if (rows.empty()) return;
+
+    out.family("rest_api_concurrency_limit", "Adaptive limit of concurrent requests in a worker's route group",
+               "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_concurrency_limit", {{"worker", row.worker}, {"group", row.group}},
+                   static_cast<int64_t>(row.stats->limit.load(std::memory_order_relaxed)));
+    }
+
+    out.family("rest_api_concurrency_in_flight", "Requests of the group running now", "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_concurrency_in_flight", {{"worker", row.worker}, {"group", row.group}},
+                   static_cast<int64_t>(row.stats->in_flight.load(std::memory_order_relaxed)));
+    }
+
+    out.family("rest_api_concurrency_waiting", "Requests waiting for room under the limit", "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_concurrency_waiting", {{"worker", row.worker}, {"group", row.group}},
+                   static_cast<int64_t>(row.stats->waiting.load(std::memory_order_relaxed)));
+    }
+
+    out.family("rest_api_concurrency_min_rtt_seconds", "Lowest recent request latency, the no-queueing baseline",
+               "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_concurrency_min_rtt_seconds", {{"worker", row.worker}, {"group", row.group}},
+                   static_cast<double>(row.stats->min_rtt_us.load(std::memory_order_relaxed)) / 1e6);
+    }
+
+    out.family("rest_api_concurrency_rtt_seconds", "Moving average of request latency", "gauge");
+    for (const auto& row : rows) {
+        out.sample("rest_api_concurrency_rtt_seconds", {{"worker", row.worker}, {"group", row.group}},
+                   static_cast<double>(row.stats->rtt_us.load(std::memory_order_relaxed)) / 1e6);
+    }
+
+    out.family("rest_api_concurrency_admitted_total", "Requests admitted under the limit", "counter");
+    for (const auto& row : rows) {
+        out.sample("rest_api_concurrency_admitted_total", {{"worker", row.worker}, {"group", row.group}},
+                   row.stats->admitted.load(std::memory_order_relaxed));
+    }
+
+    out.family("rest_api_concurrency_queued_total", "Requests admitted after waiting for room", "counter");
+    for (const auto& row : rows) {
+        out.sample("rest_api_concurrency_queued_total", {{"worker", row.worker}, {"group", row.group}},
+                   row.stats->queued.load(std::memory_order_relaxed));
+    }
+
+    out.family("rest_api_concurrency_shed_total", "Requests answered 503 over the limit", "counter");
+    for (const auto& row : rows) {
+        out.sample("rest_api_concurrency_shed_total", {{"worker", row.worker}, {"group", row.group}},
+                   row.stats->shed.load(std::memory_order_relaxed));
+    }
+}
+
+} // namespace Metrics
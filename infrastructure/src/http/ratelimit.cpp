@@ -0,0 +1,248 @@
+#include "http/ratelimit.hpp"
+#include "http/router.hpp"
+#include "http/request.hpp"
+
+#include <sys/socket.h>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+// FNV-1a 64 peste indexul politicii și cheia clientului; 0 e rezervat pentru "liber"
+static uint64_t bucket_key(int policy, std::string_view client) {
+    uint64_t hash = 14695981039346656037ULL;
+    hash ^= static_cast<uint64_t>(policy) + 1;
+    hash *= 1099511628211ULL;
+    for (unsigned char c : client) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash ? hash : 1;
+}
+
+// steady_clock = CLOCK_MONOTONIC, comun tuturor proceselor
+static int64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint32_t ceil_seconds(int64_t us) {
+    return us <= 0 ? 0 : static_cast<uint32_t>((us + 999999) / 1000000);
+}
+
+RateLimiter::RateLimiter(std::vector<RateLimitPolicy> policies, size_t capacity)
+    : policies_(std::move(policies)), shm_(nullptr), header_(nullptr), buckets_(nullptr), mask_(0)
+{
+    if (policies_.size() > MAX_POLICIES) {
+        throw std::runtime_error("RateLimiter: prea multe politici");
+    }
+    for (auto& policy : policies_) {
+        if (policy.limit == 0) policy.limit = 1;
+        if (policy.window_seconds == 0) policy.window_seconds = 1;
+    }
+
+    size_t slots = 1;
+    while (slots < capacity || slots < MAX_PROBE) slots <<= 1;
+    mask_ = slots - 1;
+
+    size_t bytes = sizeof(Header) + slots * sizeof(RateBucket);
+    shm_ = new SharedMemory("/rest_api_rate_limit", bytes, true);
+
+    // ftruncate dă zerouri, dar zona poate fi refolosită după un crash
+    std::memset(shm_->get_ptr(), 0, bytes);
+    header_ = new (shm_->get_ptr()) Header();
+    buckets_ = reinterpret_cast<RateBucket*>(static_cast<char*>(shm_->get_ptr()) + sizeof(Header));
+    for (size_t i = 0; i < slots; i++) {
+        new (&buckets_[i]) RateBucket();
+    }
+}
+
+RateLimiter::~RateLimiter() {
+    delete shm_;
+}
+
+int RateLimiter::match_prefix(std::string_view path) const {
+    int best = -1;
+    size_t best_length = 0;
+    for (size_t i = 0; i < policies_.size(); i++) {
+        const std::string& prefix = policies_[i].prefix;
+        if (!path_under_prefix(path, prefix)) continue;
+        if (best < 0 || prefix.size() > best_length) {
+            best = static_cast<int>(i);
+            best_length = prefix.size();
+        }
+    }
+    return best;
+}
+
+void RateLimiter::resolve(const Router& router) {
+    route_policy_.assign(router.routeCount(), -1);
+    for (size_t i = 0; i < router.routeCount(); i++) {
+        route_policy_[i] = match_prefix(router.routeAt(i).pattern);
+    }
+}
+
+int RateLimiter::policy_for(const Router& router, const Route* route, const HttpRequest& request) const {
+    if (route) {
+        size_t index = router.routeIndex(route);
+        if (index < route_policy_.size()) return route_policy_[index];
+    }
+    return match_prefix(request.path);
+}
+
+std::string RateLimiter::client_key(int policy, const HttpRequest& request, int client_fd,
+                                    const PeerAddress& peer) const {
+    const RateLimitPolicy& p = policies_[static_cast<size_t>(policy)];
+
+    if (!p.key_header.empty()) {
+        std::string key = request.getHeader(p.key_header);
+        if (!key.empty()) return "k:" + key;
+    }
+
+    if (p.trust_forwarded_for) {
+        // Primul element e clientul original
+        std::string forwarded = request.getHeader("X-Forwarded-For");
+        size_t comma = forwarded.find(',');
+        if (comma != std::string::npos) forwarded.resize(comma);
+        size_t start = forwarded.find_first_not_of(" \t");
+        size_t end = forwarded.find_last_not_of(" \t");
+        if (start != std::string::npos) return "a:" + forwarded.substr(start, end - start + 1);
+    }
+
+    // Adresa de la accept() e valabilă și după puntea TLS (socketpair), unde
+    // getpeername() pe fd-ul worker-ului nu mai vede clientul
+    PeerAddress address = peer;
+    if (!address.known()) {
+        struct sockaddr_storage addr;
+        socklen_t len = sizeof(addr);
+        if (getpeername(client_fd, reinterpret_cast<struct sockaddr*>(&addr), &len) == 0) {
+            address = PeerAddress::from(addr);
+        }
+    }
+
+    // Socket Unix: nu există adresă, clienții împart găleata
+    std::string text = address.to_string();
+    return "a:" + (text.empty() ? std::string("local") : text);
+}
+
+RateBucket* RateLimiter::find_or_claim(uint64_t key, int64_t now) {
+    size_t start = static_cast<size_t>(key) & mask_;
+    RateBucket* idle = nullptr;
+    uint64_t idle_key = 0;
+
+    for (size_t i = 0; i < MAX_PROBE; i++) {
+        RateBucket& bucket = buckets_[(start + i) & mask_];
+        uint64_t current = bucket.key.load(std::memory_order_acquire);
+        if (current == key) return &bucket;
+
+        if (current == 0) {
+            uint64_t expected = 0;
+            if (bucket.key.compare_exchange_strong(expected, key, std::memory_order_acq_rel)) {
+                return &bucket;   // TAT = 0: găleată plină
+            }
+            if (expected == key) return &bucket;   // Alt worker a luat locul pentru același client
+            continue;
+        }
+
+        // Găleată plină la loc: poate fi dată altui client fără pierdere
+        if (!idle && bucket.tat.load(std::memory_order_relaxed) <= now) {
+            idle = &bucket;
+            idle_key = current;
+        }
+    }
+
+    if (idle && idle->key.compare_exchange_strong(idle_key, key, std::memory_order_acq_rel)) {
+        idle->tat.store(0, std::memory_order_relaxed);
+        return idle;
+    }
+    return nullptr;
+}
+
+RateLimitDecision RateLimiter::take(int policy, std::string_view client) {
+    const RateLimitPolicy& p = policies_[static_cast<size_t>(policy)];
+    RateLimitDecision decision;
+    decision.policy = policy;
+    decision.limit = p.limit;
+
+    int64_t now = now_us();
+    int64_t window = static_cast<int64_t>(p.window_seconds) * 1000000;
+    int64_t interval = window / p.limit;          // Un token la fiecare interval
+    if (interval <= 0) interval = 1;
+
+    RateBucket* bucket = find_or_claim(bucket_key(policy, client), now);
+    if (!bucket) {
+        header_->saturated.fetch_add(1, std::memory_order_relaxed);
+        header_->counters[policy].allowed.fetch_add(1, std::memory_order_relaxed);
+        decision.remaining = p.limit - 1;
+        return decision;
+    }
+
+    int64_t tat = bucket->tat.load(std::memory_order_relaxed);
+    while (true) {
+        int64_t next = (tat > now ? tat : now) + interval;
+        if (next - now > window) {
+            // Găleata e goală: următorul token vine când TAT coboară sub fereastră
+            decision.allowed = false;
+            decision.remaining = 0;
+            decision.retry_after = ceil_seconds(next - window - now);
+            if (decision.retry_after == 0) decision.retry_after = 1;
+            decision.reset_seconds = ceil_seconds(tat - now);
+            header_->counters[policy].limited.fetch_add(1, std::memory_order_relaxed);
+            return decision;
+        }
+        if (bucket->tat.compare_exchange_weak(tat, next, std::memory_order_relaxed)) {
+            decision.remaining = static_cast<uint32_t>((window - (next - now)) / interval);
+            decision.reset_seconds = ceil_seconds(next - now);
+            header_->counters[policy].allowed.fetch_add(1, std::memory_order_relaxed);
+            return decision;
+        }
+    }
+}
+
+std::string RateLimiter::headers(const RateLimitDecision& decision) const {
+    const RateLimitPolicy& p = policies_[static_cast<size_t>(decision.policy)];
+    std::string out;
+    out.reserve(112);
+    out += "RateLimit-Limit: ";
+    out += std::to_string(decision.limit);
+    out += "\r\nRateLimit-Remaining: ";
+    out += std::to_string(decision.remaining);
+    out += "\r\nRateLimit-Reset: ";
+    out += std::to_string(decision.reset_seconds);
+    out += "\r\nRateLimit-Policy: ";
+    out += std::to_string(p.limit);
+    out += ";w=";
+    out += std::to_string(p.window_seconds);
+    out += "\r\n";
+    return out;
+}
+
+std::string RateLimiter::rejection(const RateLimitDecision& decision, const std::string& extra_headers) const {
+    static const std::string body = "{\"error\":\"Too Many Requests\"}";
+    std::string out;
+    out.reserve(256 + extra_headers.size());
+    out += "HTTP/1.1 429 Too Many Requests\r\n";
+    out += "Content-Type: application/json\r\n";
+    out += "Retry-After: ";
+    out += std::to_string(decision.retry_after);
+    out += "\r\n";
+    out += headers(decision);
+    out += extra_headers;
+    out += "Content-Length: ";
+    out += std::to_string(body.size());
+    out += "\r\nConnection: close\r\n\r\n";
+    out += body;
+    return out;
+}
+
+uint64_t RateLimiter::allowed(int policy) const {
+    return header_->counters[policy].allowed.load(std::memory_order_relaxed);
+}
+
+uint64_t RateLimiter::limited(int policy) const {
+    return header_->counters[policy].limited.load(std::memory_order_relaxed);
+}
+
+uint64_t RateLimiter::saturated() const {
+    return header_->saturated.load(std::memory_order_relaxed);
+}
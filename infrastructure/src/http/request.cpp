@@ -1,6 +1,7 @@
 // Exemplu generic – adaptează la numele funcției/fisierului tău:
 #include "http/request.hpp"
 #include <sstream>
+#include <strings.h>
 
 static void fill_target_and_path(HttpRequest& req, const std::string& uri) {
     req.target = uri; // EX: "/api/users/add?name=Ana"
@@ -23,3 +24,14 @@ bool parse_request_line(const std::string& line, HttpRequest& req) {
     fill_target_and_path(req, uri);
     return true;
 }
+
+std::string HttpRequest::getHeader(const std::string& name) const {
+    auto it = headers.find(name);
+    if (it != headers.end()) return it->second;
+
+    // Numele header-elor HTTP sunt case-insensitive
+    for (const auto& [key, value] : headers) {
+        if (strcasecmp(key.c_str(), name.c_str()) == 0) return value;
+    }
+    return "";
+}
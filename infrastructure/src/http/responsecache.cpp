@@ -0,0 +1,419 @@
+#include "http/responsecache.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+struct ResponseCache::Header {
+    pthread_mutex_t mutex;
+
+    uint32_t bucket_count;    // Putere a lui 2
+    uint32_t entry_capacity;
+    uint32_t block_capacity;
+
+    int32_t free_entry;       // Liste de libere, înlănțuite prin next_in_bucket / next
+    int32_t free_block;
+    uint32_t free_blocks;
+    uint32_t used_entries;
+
+    int32_t lru_head;         // Cea mai recent folosită
+    int32_t lru_tail;         // Prima evacuată
+
+    // Modificate doar sub mutex
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t stores;
+    uint64_t evictions;
+    uint64_t expirations;
+    uint64_t invalidations;
+};
+
+struct ResponseCache::Entry {
+    uint64_t hash;
+    int64_t expires_ms;
+    uint64_t tags[MAX_TAGS];  // Hash-uri de tag; o coliziune doar invalidează în plus
+    uint32_t tag_count;
+    uint32_t key_size;
+    uint32_t value_size;
+    int32_t first_block;      // Cheia, apoi valoarea, continuu peste blocuri
+    int32_t next_in_bucket;
+    int32_t lru_prev;
+    int32_t lru_next;
+};
+
+struct ResponseCache::Block {
+    int32_t next;
+    char data[BLOCK_SIZE - sizeof(int32_t)];
+};
+
+namespace {
+
+constexpr size_t BLOCK_DATA = ResponseCache::BLOCK_SIZE - sizeof(int32_t);
+
+size_t align8(size_t n) { return (n + 7) & ~static_cast<size_t>(7); }
+
+uint32_t next_pow2(size_t n) {
+    uint32_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+std::atomic<int> cache_counter{0};
+
+} // namespace
+
+ResponseCache::ResponseCache(const ResponseCacheOptions& options)
+    : shm_(nullptr), header_(nullptr), buckets_(nullptr), entries_(nullptr), blocks_(nullptr)
+{
+    size_t entry_capacity = std::max<size_t>(options.max_entries, 1);
+    size_t block_capacity = std::max<size_t>(options.max_bytes / BLOCK_SIZE, 1);
+    uint32_t bucket_count = next_pow2(entry_capacity);
+
+    size_t buckets_offset = align8(sizeof(Header));
+    size_t entries_offset = buckets_offset + align8(bucket_count * sizeof(int32_t));
+    size_t blocks_offset = entries_offset + entry_capacity * sizeof(Entry);
+    size_t total = blocks_offset + block_capacity * sizeof(Block);
+
+    // Nume unic per proces: mai multe instanțe (sau servere) nu se calcă
+    std::string name = "/rest_api_cache_" + std::to_string(getpid()) + "_" +
+                       std::to_string(cache_counter.fetch_add(1));
+    shm_ = new SharedMemory(name, total, true);
+
+    char* base = static_cast<char*>(shm_->get_ptr());
+    header_ = reinterpret_cast<Header*>(base);
+    buckets_ = reinterpret_cast<int32_t*>(base + buckets_offset);
+    entries_ = reinterpret_cast<Entry*>(base + entries_offset);
+    blocks_ = reinterpret_cast<Block*>(base + blocks_offset);
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    int rc = pthread_mutex_init(&header_->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    if (rc != 0) {
+        errno = rc;
+        perror("pthread_mutex_init");
+        delete shm_;
+        throw std::runtime_error("Nu pot inițializa mutex-ul cache-ului de răspunsuri");
+    }
+
+    header_->bucket_count = bucket_count;
+    header_->entry_capacity = static_cast<uint32_t>(entry_capacity);
+    header_->block_capacity = static_cast<uint32_t>(block_capacity);
+    header_->hits = 0;
+    header_->misses = 0;
+    header_->stores = 0;
+    header_->evictions = 0;
+    header_->expirations = 0;
+    header_->invalidations = 0;
+    reset_locked();
+}
+
+ResponseCache::~ResponseCache() {
+    delete shm_;
+}
+
+// ===== Lock =====
+
+void ResponseCache::lock() const {
+    int rc = pthread_mutex_lock(&header_->mutex);
+    if (rc == EOWNERDEAD) {
+        // Un worker a murit în mijlocul unei modificări: structura nu mai e de încredere
+        std::cerr << "[ResponseCache] Lock recuperat de la un proces mort, cache golit\n";
+        const_cast<ResponseCache*>(this)->reset_locked();
+        pthread_mutex_consistent(&header_->mutex);
+    } else if (rc != 0) {
+        errno = rc;
+        perror("pthread_mutex_lock");
+        throw std::runtime_error("Nu pot lua lock-ul cache-ului de răspunsuri");
+    }
+}
+
+void ResponseCache::unlock() const {
+    pthread_mutex_unlock(&header_->mutex);
+}
+
+// ===== Operații publice =====
+
+bool ResponseCache::lookup(std::string_view key, std::string& out) {
+    uint64_t hash = hash_bytes(key);
+
+    lock();
+    int32_t index = find_locked(hash, key);
+    if (index < 0) {
+        header_->misses++;
+        unlock();
+        return false;
+    }
+
+    Entry& entry = entries_[index];
+    if (entry.expires_ms <= now_ms()) {
+        remove_locked(index);
+        header_->expirations++;
+        header_->misses++;
+        unlock();
+        return false;
+    }
+
+    // Copiază valoarea (după cheie) din lanțul de blocuri
+    out.resize(entry.value_size);
+    size_t skip = entry.key_size;
+    size_t copied = 0;
+    for (int32_t b = entry.first_block; b >= 0 && copied < entry.value_size; b = blocks_[b].next) {
+        if (skip >= BLOCK_DATA) {
+            skip -= BLOCK_DATA;
+            continue;
+        }
+        size_t n = std::min(BLOCK_DATA - skip, entry.value_size - copied);
+        std::memcpy(&out[copied], blocks_[b].data + skip, n);
+        copied += n;
+        skip = 0;
+    }
+
+    lru_unlink(index);
+    lru_push_front(index);
+    header_->hits++;
+    unlock();
+    return true;
+}
+
+bool ResponseCache::store(std::string_view key, std::string_view value, std::chrono::milliseconds ttl,
+                          const std::vector<std::string>& tags) {
+    size_t total = key.size() + value.size();
+    size_t needed = (total + BLOCK_DATA - 1) / BLOCK_DATA;
+    if (needed == 0) needed = 1;
+    if (needed > header_->block_capacity || ttl.count() <= 0) {
+        return false;
+    }
+
+    uint64_t hash = hash_bytes(key);
+    uint64_t tag_hashes[MAX_TAGS];
+    uint32_t tag_count = 0;
+    for (const auto& tag : tags) {
+        if (tag_count == MAX_TAGS) break;
+        tag_hashes[tag_count++] = hash_bytes(tag);
+    }
+
+    lock();
+
+    int32_t existing = find_locked(hash, key);
+    if (existing >= 0) {
+        remove_locked(existing);
+    }
+
+    while (header_->free_blocks < needed || header_->free_entry < 0) {
+        evict_lru_locked();
+    }
+
+    int32_t index = header_->free_entry;
+    Entry& entry = entries_[index];
+    header_->free_entry = entry.next_in_bucket;
+
+    entry.hash = hash;
+    entry.expires_ms = now_ms() + ttl.count();
+    entry.tag_count = tag_count;
+    std::memcpy(entry.tags, tag_hashes, tag_count * sizeof(uint64_t));
+    entry.key_size = static_cast<uint32_t>(key.size());
+    entry.value_size = static_cast<uint32_t>(value.size());
+
+    // Ia blocurile din lista de libere și scrie cheia urmată de valoare
+    entry.first_block = header_->free_block;
+    int32_t last = -1;
+    size_t written = 0;
+    for (size_t i = 0; i < needed; i++) {
+        int32_t b = header_->free_block;
+        header_->free_block = blocks_[b].next;
+
+        size_t room = BLOCK_DATA;
+        char* dst = blocks_[b].data;
+        while (room > 0 && written < total) {
+            size_t n;
+            if (written < key.size()) {
+                n = std::min(room, key.size() - written);
+                std::memcpy(dst, key.data() + written, n);
+            } else {
+                n = std::min(room, total - written);
+                std::memcpy(dst, value.data() + (written - key.size()), n);
+            }
+            dst += n;
+            room -= n;
+            written += n;
+        }
+        last = b;
+    }
+    blocks_[last].next = -1;
+    header_->free_blocks -= static_cast<uint32_t>(needed);
+
+    uint32_t bucket = static_cast<uint32_t>(hash) & (header_->bucket_count - 1);
+    entry.next_in_bucket = buckets_[bucket];
+    buckets_[bucket] = index;
+    lru_push_front(index);
+
+    header_->used_entries++;
+    header_->stores++;
+    unlock();
+    return true;
+}
+
+size_t ResponseCache::invalidate_tag(std::string_view tag) {
+    uint64_t tag_hash = hash_bytes(tag);
+    size_t removed = 0;
+
+    lock();
+    // Parcurge lista LRU (doar intrările ocupate)
+    int32_t index = header_->lru_head;
+    while (index >= 0) {
+        int32_t next = entries_[index].lru_next;
+        const Entry& entry = entries_[index];
+        for (uint32_t t = 0; t < entry.tag_count; t++) {
+            if (entry.tags[t] == tag_hash) {
+                remove_locked(index);
+                removed++;
+                break;
+            }
+        }
+        index = next;
+    }
+    header_->invalidations += removed;
+    unlock();
+    return removed;
+}
+
+void ResponseCache::clear() {
+    lock();
+    header_->invalidations += header_->used_entries;
+    reset_locked();
+    unlock();
+}
+
+ResponseCacheStats ResponseCache::stats() const {
+    lock();
+    ResponseCacheStats s;
+    s.hits = header_->hits;
+    s.misses = header_->misses;
+    s.stores = header_->stores;
+    s.evictions = header_->evictions;
+    s.expirations = header_->expirations;
+    s.invalidations = header_->invalidations;
+    s.entries = header_->used_entries;
+    s.bytes_used = static_cast<size_t>(header_->block_capacity - header_->free_blocks) * BLOCK_SIZE;
+    unlock();
+    return s;
+}
+
+// ===== Structura internă (apelate cu lock-ul luat) =====
+
+int32_t ResponseCache::find_locked(uint64_t hash, std::string_view key) const {
+    uint32_t bucket = static_cast<uint32_t>(hash) & (header_->bucket_count - 1);
+    for (int32_t index = buckets_[bucket]; index >= 0; index = entries_[index].next_in_bucket) {
+        const Entry& entry = entries_[index];
+        if (entry.hash == hash && entry.key_size == key.size() && key_equals(entry, key)) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+bool ResponseCache::key_equals(const Entry& entry, std::string_view key) const {
+    size_t compared = 0;
+    for (int32_t b = entry.first_block; b >= 0 && compared < key.size(); b = blocks_[b].next) {
+        size_t n = std::min(BLOCK_DATA, key.size() - compared);
+        if (std::memcmp(blocks_[b].data, key.data() + compared, n) != 0) {
+            return false;
+        }
+        compared += n;
+    }
+    return compared == key.size();
+}
+
+void ResponseCache::remove_locked(int32_t index) {
+    Entry& entry = entries_[index];
+
+    // Scoate din bucket
+    uint32_t bucket = static_cast<uint32_t>(entry.hash) & (header_->bucket_count - 1);
+    int32_t* link = &buckets_[bucket];
+    while (*link >= 0 && *link != index) {
+        link = &entries_[*link].next_in_bucket;
+    }
+    if (*link == index) {
+        *link = entry.next_in_bucket;
+    }
+
+    lru_unlink(index);
+
+    // Blocurile se întorc în lista de libere, cu tot lanțul
+    int32_t last = entry.first_block;
+    uint32_t count = 1;
+    while (blocks_[last].next >= 0) {
+        last = blocks_[last].next;
+        count++;
+    }
+    blocks_[last].next = header_->free_block;
+    header_->free_block = entry.first_block;
+    header_->free_blocks += count;
+
+    entry.next_in_bucket = header_->free_entry;
+    header_->free_entry = index;
+    header_->used_entries--;
+}
+
+void ResponseCache::evict_lru_locked() {
+    // Apelată doar când lipsește spațiu, deci există cel puțin o intrare ocupată
+    remove_locked(header_->lru_tail);
+    header_->evictions++;
+}
+
+void ResponseCache::lru_unlink(int32_t index) {
+    Entry& entry = entries_[index];
+    if (entry.lru_prev >= 0) entries_[entry.lru_prev].lru_next = entry.lru_next;
+    else header_->lru_head = entry.lru_next;
+    if (entry.lru_next >= 0) entries_[entry.lru_next].lru_prev = entry.lru_prev;
+    else header_->lru_tail = entry.lru_prev;
+    entry.lru_prev = entry.lru_next = -1;
+}
+
+void ResponseCache::lru_push_front(int32_t index) {
+    Entry& entry = entries_[index];
+    entry.lru_prev = -1;
+    entry.lru_next = header_->lru_head;
+    if (header_->lru_head >= 0) entries_[header_->lru_head].lru_prev = index;
+    header_->lru_head = index;
+    if (header_->lru_tail < 0) header_->lru_tail = index;
+}
+
+void ResponseCache::reset_locked() {
+    for (uint32_t i = 0; i < header_->bucket_count; i++) {
+        buckets_[i] = -1;
+    }
+    for (uint32_t i = 0; i < header_->entry_capacity; i++) {
+        entries_[i].next_in_bucket = (i + 1 < header_->entry_capacity) ? static_cast<int32_t>(i + 1) : -1;
+        entries_[i].lru_prev = entries_[i].lru_next = -1;
+    }
+    for (uint32_t i = 0; i < header_->block_capacity; i++) {
+        blocks_[i].next = (i + 1 < header_->block_capacity) ? static_cast<int32_t>(i + 1) : -1;
+    }
+    header_->free_entry = 0;
+    header_->free_block = 0;
+    header_->free_blocks = header_->block_capacity;
+    header_->used_entries = 0;
+    header_->lru_head = header_->lru_tail = -1;
+}
+
+// FNV-1a 64
+uint64_t ResponseCache::hash_bytes(std::string_view data) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// steady_clock = CLOCK_MONOTONIC, comun tuturor proceselor
+int64_t ResponseCache::now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
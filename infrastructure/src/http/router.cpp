@@ -1,88 +1,481 @@
 #include "http/router.hpp"
+#include "http/routestats.hpp"
+#include "http/body.hpp"
 #include <iostream>
 #include <sstream>
+#include <future>
+#include <stdexcept>
+
+bool path_under_prefix(std::string_view path, std::string_view prefix) {
+    if (prefix.empty()) return true;
+    if (path.compare(0, prefix.size(), prefix) != 0) return false;
+    return path.size() == prefix.size() || path[prefix.size()] == '/';
+}
 
 void Router::addRoute(const std::string& method, const std::string& pattern, RouteHandler handler) {
-    routes.push_back({method, pattern, handler});
+    Route route;
+    route.method = method;
+    route.pattern = pattern;
+    route.handler = std::move(handler);
+    routes.push_back(std::move(route));
+    insertRoute(routes.size() - 1);
     std::cout << "[Router] Rută adăugată: " << method << " " << pattern << "\n";
 }
 
-std::string Router::handle(const HttpRequest& request) {
-    std::cout << "[Router] Procesare: " << request.method << " " << request.path << "\n";
-    
-    // Caută o rută potrivită
-    for (const auto& route : routes) {
-        if (route.method == request.method) {
-            std::map<std::string, std::string> params;
-            if (matchPattern(route.pattern, request.path, params)) {
-                std::cout << "[Router] Match găsit: " << route.pattern << "\n";
-                try {
-                    return route.handler(request, params);
-                } catch (const std::exception& e) {
-                    std::cerr << "[Router] Eroare în handler: " << e.what() << "\n";
-                    // Returnează răspuns de eroare
-                    std::ostringstream response;
-                    response << "HTTP/1.1 500 Internal Server Error\r\n";
-                    response << "Content-Type: application/json\r\n";
-                    response << "Connection: close\r\n\r\n";
-                    response << "{\"error\":\"" << e.what() << "\"}";
-                    return response.str();
-                }
-            }
-        }
-    }
-    
-    // Nicio rută nu a fost găsită
-    std::cout << "[Router] Nicio rută găsită pentru " << request.method << " " << request.path << "\n";
+void Router::addAsyncRoute(const std::string& method, const std::string& pattern, AsyncRouteHandler handler) {
+    Route route;
+    route.method = method;
+    route.pattern = pattern;
+    route.async_handler = std::move(handler);
+    routes.push_back(std::move(route));
+    insertRoute(routes.size() - 1);
+    std::cout << "[Router] Rută async adăugată: " << method << " " << pattern << "\n";
+}
+
+void Router::addWebSocketRoute(const std::string& pattern, std::shared_ptr<const WebSocketRoute> route) {
+    Route entry;
+    entry.method = "GET";
+    entry.pattern = pattern;
+    entry.websocket = std::move(route);
+    routes.push_back(std::move(entry));
+    insertRoute(routes.size() - 1);
+    std::cout << "[Router] Rută WebSocket adăugată: " << pattern << "\n";
+}
+
+void Router::addSseRoute(const std::string& pattern, SseRouteHandler handler) {
+    Route route;
+    route.method = "GET";
+    route.pattern = pattern;
+    route.sse = std::move(handler);
+    routes.push_back(std::move(route));
+    insertRoute(routes.size() - 1);
+    std::cout << "[Router] Rută SSE adăugată: " << pattern << "\n";
+}
+
+void Router::addStreamingRoute(const std::string& method, const std::string& pattern,
+                               StreamingRouteHandler handler) {
+    Route route;
+    route.method = method;
+    route.pattern = pattern;
+    route.streaming = std::move(handler);
+    routes.push_back(std::move(route));
+    insertRoute(routes.size() - 1);
+    std::cout << "[Router] Rută cu corp în flux adăugată: " << method << " " << pattern << "\n";
+}
+
+// Răspuns de eroare pentru excepții din handler
+static std::string error_response(const std::string& what) {
+    std::ostringstream response;
+    response << "HTTP/1.1 500 Internal Server Error\r\n";
+    response << "Content-Type: application/json\r\n";
+    response << "Connection: close\r\n\r\n";
+    response << "{\"error\":\"" << what << "\"}";
+    return response.str();
+}
+
+static std::string not_found_response(const std::string& path) {
     std::ostringstream response;
     response << "HTTP/1.1 404 Not Found\r\n";
     response << "Content-Type: application/json\r\n";
     response << "Connection: close\r\n\r\n";
-    response << "{\"error\":\"Not Found\",\"path\":\"" << request.path << "\"}";
+    response << "{\"error\":\"Not Found\",\"path\":\"" << path << "\"}";
     return response.str();
 }
 
-bool Router::matchPattern(const std::string& pattern, const std::string& path,
-                         std::map<std::string, std::string>& params) {
-    std::vector<std::string> pattern_parts = splitPath(pattern);
-    std::vector<std::string> path_parts = splitPath(path);
-    
-    if (pattern_parts.size() != path_parts.size()) {
-        return false;
+// Corp invalid, prea mare sau client care nu mai trimite
+static std::string body_error_response(int status, const std::string& what) {
+    const char* text = (status == 413) ? "Payload Too Large"
+                     : (status == 408) ? "Request Timeout"
+                     : "Bad Request";
+    std::string body = "{\"error\":\"" + std::string(text) + "\"}";
+    std::ostringstream response;
+    response << "HTTP/1.1 " << status << " " << text << "\r\n";
+    response << "Content-Type: application/json\r\n";
+    response << "Content-Length: " << body.size() << "\r\n";
+    response << "Connection: close\r\n\r\n";
+    response << body;
+    std::cerr << "[Router] " << status << ": " << what << "\n";
+    return response.str();
+}
+
+// GET simplu pe o rută WebSocket
+static std::string upgrade_required_response() {
+    std::ostringstream response;
+    response << "HTTP/1.1 426 Upgrade Required\r\n";
+    response << "Upgrade: websocket\r\n";
+    response << "Sec-WebSocket-Version: 13\r\n";
+    response << "Content-Type: application/json\r\n";
+    response << "Connection: close\r\n\r\n";
+    response << "{\"error\":\"WebSocket upgrade required\"}";
+    return response.str();
+}
+
+// "/api//users/" -> "/api/users"; "" -> "/"
+static std::string normalize_path(std::string_view path) {
+    std::string out;
+    out.reserve(path.size() + 1);
+    size_t i = 0;
+    while (i < path.size()) {
+        while (i < path.size() && path[i] == '/') i++;
+        if (i == path.size()) break;
+        size_t end = path.find('/', i);
+        if (end == std::string_view::npos) end = path.size();
+        out += '/';
+        out.append(path.data() + i, end - i);
+        i = end;
     }
-    
-    for (size_t i = 0; i < pattern_parts.size(); ++i) {
-        if (pattern_parts[i][0] == ':') {
-            // Parametru dinamic (ex: :id)
-            std::string param_name = pattern_parts[i].substr(1);
-            params[param_name] = path_parts[i];
-        } else if (pattern_parts[i] != path_parts[i]) {
-            // Segmentul nu match
-            return false;
+    if (out.empty()) out = "/";
+    return out;
+}
+
+static bool is_normalized(std::string_view path) {
+    if (path.empty() || path[0] != '/') return false;
+    if (path.size() > 1 && path.back() == '/') return false;
+    return path.find("//") == std::string_view::npos;
+}
+
+void Router::insertRoute(size_t route_index) {
+    Route& route = routes[route_index];
+    std::string pattern = normalize_path(route.pattern);
+
+    int node = -1;
+    for (const auto& tree : trees_) {
+        if (tree.method == route.method) node = tree.root;
+    }
+    if (node < 0) {
+        node = static_cast<int>(nodes_.size());
+        nodes_.push_back(Node());
+        trees_.push_back({route.method, node});
+    }
+
+    std::string_view rest = pattern;
+    while (!rest.empty()) {
+        if (rest[0] == ':') {
+            // Muchie wildcard: numele ține de rută, nodul e comun tuturor parametrilor de pe acest nivel
+            size_t end = rest.find('/');
+            if (end == std::string_view::npos) end = rest.size();
+            route.param_names.emplace_back(rest.substr(1, end - 1));
+            if (route.param_names.size() > RouteParams::MAX) {
+                throw std::runtime_error("Too many parameters in route pattern: " + route.pattern);
+            }
+
+            if (nodes_[node].param_child < 0) {
+                int child = static_cast<int>(nodes_.size());
+                nodes_.push_back(Node());
+                nodes_[node].param_child = child;
+            }
+            node = nodes_[node].param_child;
+            rest.remove_prefix(end);
+            continue;
         }
+
+        // Text static până la următorul "/:" (inclusiv "/")
+        size_t param = rest.find("/:");
+        std::string_view text = rest.substr(0, param == std::string_view::npos ? rest.size() : param + 1);
+
+        int match = -1;
+        for (int child : nodes_[node].children) {
+            if (nodes_[child].label[0] == text[0]) {
+                match = child;
+                break;
+            }
+        }
+
+        if (match < 0) {
+            int child = static_cast<int>(nodes_.size());
+            nodes_.push_back(Node());
+            nodes_[child].label = std::string(text);
+            nodes_[node].children.push_back(child);
+            node = child;
+            rest.remove_prefix(text.size());
+            continue;
+        }
+
+        // Prefixul comun cu eticheta existentă; restul etichetei coboară într-un nod nou
+        const std::string& label = nodes_[match].label;
+        size_t common = 0;
+        while (common < label.size() && common < text.size() && label[common] == text[common]) {
+            common++;
+        }
+
+        if (common < label.size()) {
+            Node tail;
+            tail.label = label.substr(common);
+            tail.children = std::move(nodes_[match].children);
+            tail.param_child = nodes_[match].param_child;
+            tail.route = nodes_[match].route;
+
+            int tail_index = static_cast<int>(nodes_.size());
+            nodes_.push_back(std::move(tail));
+
+            Node& split = nodes_[match];
+            split.label.resize(common);
+            split.children = {tail_index};
+            split.param_child = -1;
+            split.route = -1;
+        }
+
+        node = match;
+        rest.remove_prefix(common);
     }
-    
-    return true;
+
+    if (nodes_[node].route >= 0) {
+        std::cerr << "[Router] Rută duplicată ignorată: " << route.method << " " << route.pattern << "\n";
+        return;
+    }
+    nodes_[node].route = static_cast<int>(route_index);
+}
+
+int Router::matchNode(int node, std::string_view rest, RouteParams& params) const {
+    const Node& current = nodes_[node];
+    if (rest.empty()) {
+        return current.route;
+    }
+
+    // 1. Segment static (cel mult un copil poate începe cu rest[0])
+    for (int child : current.children) {
+        const std::string& label = nodes_[child].label;
+        if (label[0] != rest[0]) continue;
+        if (rest.compare(0, label.size(), label) == 0) {
+            int found = matchNode(child, rest.substr(label.size()), params);
+            if (found >= 0) return found;
+        }
+        break;
+    }
+
+    // 2. Parametru: un segment întreg, nevid
+    if (current.param_child >= 0 && params.count_ < RouteParams::MAX) {
+        size_t end = rest.find('/');
+        if (end == std::string_view::npos) end = rest.size();
+        if (end > 0) {
+            params.entries_[params.count_++].value = rest.substr(0, end);
+            int found = matchNode(current.param_child, rest.substr(end), params);
+            if (found >= 0) return found;
+            params.count_--;
+        }
+    }
+
+    return -1;
 }
 
-std::vector<std::string> Router::splitPath(const std::string& path) {
-    std::vector<std::string> parts;
-    std::string current;
+const Route* Router::match(const std::string& method, std::string_view path, RouteParams& params) const {
+    params.count_ = 0;
+
+    // Cazul obișnuit nu alocă; "//" sau "/" final se normalizează ca la înregistrare
+    if (!is_normalized(path)) {
+        params.normalized_ = normalize_path(path);
+        path = params.normalized_;
+    }
+
+    for (const auto& tree : trees_) {
+        if (tree.method != method) continue;
+
+        int found = matchNode(tree.root, path, params);
+        if (found < 0) {
+            params.count_ = 0;
+            return nullptr;
+        }
+
+        // Numele vin din rută (aceeași ordine ca valorile)
+        const Route& route = routes[found];
+        for (size_t i = 0; i < params.count_ && i < route.param_names.size(); i++) {
+            params.entries_[i].name = route.param_names[i];
+        }
+        return &route;
+    }
+    return nullptr;
+}
+
+const RouteParams::Entry* RouteParams::find(std::string_view name) const {
+    for (size_t i = 0; i < count_; i++) {
+        if (entries_[i].name == name) return &entries_[i];
+    }
+    return end();
+}
+
+std::string_view RouteParams::get(std::string_view name) const {
+    const Entry* entry = find(name);
+    return entry != end() ? entry->value : std::string_view();
+}
+
+void Router::addStaticTable(std::shared_ptr<const StaticRouteTable> table) {
+    static_tables_.push_back(std::move(table));
+    std::cout << "[Router] Tabel static de rute adăugat\n";
+}
+
+bool Router::dispatchStatic(const HttpRequest& request, ResponseCompletion& completion) const {
+    for (const auto& table : static_tables_) {
+        try {
+            if (table->dispatch(request, completion)) return true;
+        } catch (const std::exception& e) {
+            std::cerr << "[Router] Eroare în handler: " << e.what() << "\n";
+            completion.complete(error_response(e.what()));
+            return true;
+        }
+    }
+    return false;
+}
+
+const Route* Router::findRoute(const HttpRequest& request, RouteParams& params) {
+    const Route* route = match(request.method, request.path, params);
+    if (route) {
+        std::cout << "[Router] Match găsit: " << route->pattern << "\n";
+    }
+    return route;
+}
+
+std::string Router::handle(const HttpRequest& request) {
+    std::cout << "[Router] Procesare: " << request.method << " " << request.path << "\n";
     
-    for (char c : path) {
-        if (c == '/') {
-            if (!current.empty()) {
-                parts.push_back(current);
-                current.clear();
-            }
+    // Caută o rută potrivită
+    RouteParams params;
+    const Route* route = findRoute(request, params);
+
+    if (!route && !static_tables_.empty()) {
+        // Handler-ele din tabel sunt sincrone: răspunsul e gata la întoarcere
+        std::string response;
+        ResponseCompletion completion([&response](const std::string& r) { response = r; });
+        if (!dispatchStatic(request, completion)) {
+            completion.complete(not_found_response(request.path));
+        }
+        return response;
+    }
+
+    if (!route) {
+        // Nicio rută nu a fost găsită
+        std::cout << "[Router] Nicio rută găsită pentru " << request.method << " " << request.path << "\n";
+        return not_found_response(request.path);
+    }
+
+    if (route->websocket) {
+        return upgrade_required_response();
+    }
+
+    if (route->sse) {
+        // Stream-ul are nevoie de socket, nu încape într-un răspuns string
+        return not_found_response(request.path);
+    }
+
+    if (route->async_handler || route->streaming) {
+        // Rută asincronă (sau cu corp în flux) apelată sincron: așteptăm completarea
+        auto promise = std::make_shared<std::promise<std::string>>();
+        std::future<std::string> result = promise->get_future();
+        dispatch(request, ResponseCompletion([promise](const std::string& response) {
+            promise->set_value(response);
+        }));
+        return result.get();
+    }
+
+    try {
+        return route->handler(request, params);
+    } catch (const std::exception& e) {
+        std::cerr << "[Router] Eroare în handler: " << e.what() << "\n";
+        // Returnează răspuns de eroare
+        return error_response(e.what());
+    }
+}
+
+void Router::dispatch(const HttpRequest& request, ResponseCompletion completion) {
+    RouteParams params;
+    const Route* route = findRoute(request, params);
+    dispatch(request, route, params, std::move(completion));
+}
+
+void Router::dispatch(const HttpRequest& request, const Route* route,
+                      const RouteParams& params, ResponseCompletion completion) {
+    std::cout << "[Router] Procesare: " << request.method << " " << request.path << "\n";
+
+    if (!route) {
+        if (dispatchStatic(request, completion)) return;
+        std::cout << "[Router] Nicio rută găsită pentru " << request.method << " " << request.path << "\n";
+        completion.complete(not_found_response(request.path));
+        return;
+    }
+
+    if (route->websocket) {
+        completion.complete(upgrade_required_response());
+        return;
+    }
+
+    if (route->sse) {
+        // Worker-ul preia conexiunile SSE înainte de dispatch; aici doar canal inexistent
+        completion.complete(not_found_response(request.path));
+        return;
+    }
+
+    if (route->streaming) {
+        // Fără socket: corpul e doar cel deja primit (ex. Router::handle)
+        BodyReader body(-1, request.body, request);
+        dispatchStreaming(request, route, params, body, completion);
+        return;
+    }
+
+    try {
+        if (route->async_handler) {
+            // Handler-ul păstrează completion și răspunde când e gata
+            route->async_handler(request, params, completion);
         } else {
-            current += c;
+            completion.complete(route->handler(request, params));
         }
+    } catch (const std::exception& e) {
+        std::cerr << "[Router] Eroare în handler: " << e.what() << "\n";
+        // Dacă handler-ul a răspuns deja, complete() e ignorat
+        completion.complete(error_response(e.what()));
     }
-    
-    if (!current.empty()) {
-        parts.push_back(current);
+}
+
+void Router::dispatch(HttpRequest& request, const Route* route,
+                      const RouteParams& params, BodyReader& body,
+                      ResponseCompletion completion) {
+    if (!route && static_tables_.empty()) {
+        dispatch(request, route, params, std::move(completion));
+        return;
     }
-    
-    return parts;
+
+    if (!route || !route->streaming) {
+        // Rută obișnuită (sau din tabelul static): corpul e citit întreg înainte de handler
+        try {
+            body.read_all(request.body);
+        } catch (const BodyError& e) {
+            completion.complete(body_error_response(e.status(), e.what()));
+            return;
+        }
+        dispatch(request, route, params, std::move(completion));
+        return;
+    }
+
+    dispatchStreaming(request, route, params, body, completion);
+}
+
+void Router::dispatchStreaming(const HttpRequest& request, const Route* route, const RouteParams& params,
+                               BodyReader& body, ResponseCompletion& completion) {
+    std::cout << "[Router] Procesare (corp în flux): " << request.method << " " << request.path << "\n";
+
+    try {
+        route->streaming(request, params, body, completion);
+    } catch (const BodyError& e) {
+        std::cerr << "[Router] Corp invalid: " << e.what() << "\n";
+        completion.complete(body_error_response(e.status(), e.what()));
+    } catch (const std::exception& e) {
+        std::cerr << "[Router] Eroare în handler: " << e.what() << "\n";
+        completion.complete(error_response(e.what()));
+    }
+}
+
+void Router::recordRequest(const Route* route, const std::string& response,
+                           std::chrono::steady_clock::time_point start, uint64_t bytes_in) const {
+    if (!stats_) return;
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    uint64_t latency_us = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+    // "HTTP/1.1 200 ..."
+    int status = 0;
+    if (response.size() >= 12) {
+        status = (response[9] - '0') * 100 + (response[10] - '0') * 10 + (response[11] - '0');
+    }
+
+    size_t index = route ? static_cast<size_t>(route - routes.data()) : stats_->other();
+    stats_->record(index, status, latency_us, bytes_in, response.size());
 }
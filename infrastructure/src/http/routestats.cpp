@@ -0,0 +1,67 @@
+#include "http/routestats.hpp"
+#include <cstring>
+#include <new>
+
+RouteStats::RouteStats(size_t route_count, int worker_count)
+    : shm_(nullptr), rows_(nullptr), route_count_(route_count), stride_(route_count + 1),
+      worker_count_(worker_count > 0 ? worker_count : 1)
+{
+    size_t rows = stride_ * static_cast<size_t>(worker_count_);
+    shm_ = new SharedMemory("/rest_api_route_stats", rows * sizeof(RouteCounters), true);
+
+    // ftruncate dă zerouri, dar zona poate fi refolosită după un crash
+    std::memset(shm_->get_ptr(), 0, rows * sizeof(RouteCounters));
+    rows_ = static_cast<RouteCounters*>(shm_->get_ptr());
+    for (size_t i = 0; i < rows; i++) {
+        new (&rows_[i]) RouteCounters();
+    }
+}
+
+RouteStats::~RouteStats() {
+    delete shm_;
+}
+
+RouteStatsSnapshot RouteStats::snapshot(size_t route) const {
+    RouteStatsSnapshot s;
+    if (route > route_count_) return s;
+
+    for (int w = 0; w < worker_count_; w++) {
+        const RouteCounters& row = rows_[static_cast<size_t>(w) * stride_ + route];
+        for (int c = 0; c < 5; c++) {
+            s.status[c] += row.status[c].load(std::memory_order_relaxed);
+        }
+        s.bytes_in += row.bytes_in.load(std::memory_order_relaxed);
+        s.bytes_out += row.bytes_out.load(std::memory_order_relaxed);
+        s.latency_sum_us += row.latency_sum_us.load(std::memory_order_relaxed);
+        for (int b = 0; b < LatencyHistogram::BUCKETS; b++) {
+            s.histogram[b] += row.histogram[b].load(std::memory_order_relaxed);
+        }
+    }
+    for (uint64_t count : s.histogram) s.requests += count;
+    return s;
+}
+
+uint64_t RouteStatsSnapshot::percentile_us(double q) const {
+    uint64_t total = 0;
+    for (uint64_t count : histogram) total += count;
+    if (total == 0) return 0;
+
+    // Rangul cererii căutate (1..total)
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total) + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > total) rank = total;
+
+    uint64_t seen = 0;
+    for (int b = 0; b < LatencyHistogram::BUCKETS; b++) {
+        seen += histogram[b];
+        if (seen >= rank) return LatencyHistogram::bucket_upper(b);
+    }
+    return LatencyHistogram::bucket_upper(LatencyHistogram::BUCKETS - 1);
+}
+
+uint64_t RouteStatsSnapshot::max_us() const {
+    for (int b = LatencyHistogram::BUCKETS - 1; b >= 0; b--) {
+        if (histogram[b]) return LatencyHistogram::bucket_upper(b);
+    }
+    return 0;
+}
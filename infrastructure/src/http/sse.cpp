@@ -0,0 +1,392 @@
+#include "http/sse.hpp"
+#include "core/eventloop.hpp"
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+
+namespace SseProtocol {
+
+std::string format_event(uint64_t id, const std::string& event, const std::string& data) {
+    std::string out;
+    out.reserve(data.size() + event.size() + 32);
+
+    out += "id: ";
+    out += std::to_string(id);
+    out += '\n';
+
+    if (!event.empty()) {
+        out += "event: ";
+        for (char c : event) {
+            if (c != '\n' && c != '\r') out += c;
+        }
+        out += '\n';
+    }
+
+    // Fiecare linie din data devine o linie "data:"
+    size_t start = 0;
+    while (true) {
+        size_t nl = data.find('\n', start);
+        size_t end = (nl == std::string::npos) ? data.size() : nl;
+        size_t len = end - start;
+        if (len > 0 && data[end - 1] == '\r') len--;
+
+        out += "data: ";
+        out.append(data, start, len);
+        out += '\n';
+
+        if (nl == std::string::npos) break;
+        start = nl + 1;
+    }
+
+    out += '\n';
+    return out;
+}
+
+} // namespace SseProtocol
+
+// ===== SseSubscriber =====
+
+SseSubscriber::SseSubscriber(int fd, std::weak_ptr<SseChannel> channel, size_t max_queued_bytes,
+                             std::function<void()> on_done)
+    : fd_(fd),
+      channel_(std::move(channel)),
+      max_queued_bytes_(max_queued_bytes),
+      on_done_(std::move(on_done)),
+      last_write_(std::chrono::steady_clock::now()) {}
+
+SseSubscriber::~SseSubscriber() {
+    if (open_ && fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+bool SseSubscriber::push(const SseEvent& event) {
+    bool need_flush = false;
+    if (!enqueue(event, need_flush)) return false;
+    if (need_flush) schedule_flush();
+    return true;
+}
+
+bool SseSubscriber::enqueue(const SseEvent& event, bool& need_flush) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!open_) return false;
+
+        if (queued_bytes_.load() + event->size() <= max_queued_bytes_) {
+            queue_.push_back(event);  // Doar referința: buffer-ul e partajat
+            queued_bytes_ += event->size();
+            need_flush = !flush_scheduled_;
+            flush_scheduled_ = true;
+            return true;
+        }
+
+        // Abonat lent: nu acumulăm memorie pentru el, îl deconectăm
+        open_ = false;
+    }
+
+    if (auto channel = channel_.lock()) channel->evicted_++;
+    std::cerr << "[SSE] Abonat lent deconectat (" << queued_bytes_.load() << " octeți în coadă)\n";
+
+    auto self = shared_from_this();
+    EventLoop::instance().post([self]() { self->finish(); });
+    return false;
+}
+
+void SseSubscriber::close() {
+    auto self = shared_from_this();
+    EventLoop::instance().post([self]() {
+        self->open_ = false;
+        self->finish();
+    });
+}
+
+void SseSubscriber::schedule_flush() {
+    auto self = shared_from_this();
+    EventLoop::instance().post([self]() { self->flush(); });
+}
+
+void SseSubscriber::flush() {
+    if (!open_) return;
+
+    bool wrote = false;
+    bool want_write = false;
+    bool failed = false;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    flush_scheduled_ = false;
+
+    while (!queue_.empty()) {
+        // writev direct din buffer-ele partajate, fără copiere per abonat.
+        // Doar thread-ul loop-ului scoate din coadă, deci pointerii rămân valizi
+        // și după ce eliberăm lock-ul pe durata apelului de sistem.
+        struct iovec iov[64];
+        int count = 0;
+        for (auto it = queue_.begin(); it != queue_.end() && count < 64; ++it, ++count) {
+            size_t skip = (count == 0) ? front_offset_ : 0;
+            iov[count].iov_base = const_cast<char*>((*it)->data()) + skip;
+            iov[count].iov_len = (*it)->size() - skip;
+        }
+
+        lock.unlock();
+        struct msghdr msg = {};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = static_cast<size_t>(count);
+        ssize_t n = ::sendmsg(fd_, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        int err = errno;
+        lock.lock();
+
+        if (n < 0) {
+            if (err == EINTR) continue;
+            if (err == EAGAIN || err == EWOULDBLOCK) break;
+            failed = true;
+            break;
+        }
+
+        wrote = true;
+        size_t left = static_cast<size_t>(n);
+        queued_bytes_ -= left;
+        while (left > 0) {
+            size_t remaining = queue_.front()->size() - front_offset_;
+            if (left >= remaining) {
+                left -= remaining;
+                queue_.pop_front();
+                front_offset_ = 0;
+            } else {
+                front_offset_ += left;
+                left = 0;
+            }
+        }
+    }
+
+    want_write = !queue_.empty();
+    lock.unlock();
+
+    if (failed) {
+        open_ = false;
+        finish();
+        return;
+    }
+    if (wrote) last_write_ = std::chrono::steady_clock::now();
+    rearm(want_write);
+}
+
+void SseSubscriber::rearm(bool want_write) {
+    if (!open_) return;
+
+    // Clientul nu trimite nimic; EPOLLIN/EPOLLRDHUP detectează deconectarea
+    uint32_t interest = EPOLLIN | EPOLLRDHUP;
+    if (want_write) interest |= EPOLLOUT;
+
+    auto self = shared_from_this();
+    EventLoop::instance().watch_once(fd_, interest, [self](uint32_t events) {
+        self->on_events(events);
+    });
+}
+
+void SseSubscriber::on_events(uint32_t events) {
+    if (!open_) return;
+
+    if (events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) {
+        open_ = false;
+        finish();
+        return;
+    }
+
+    if (events & EPOLLIN) {
+        char discard[512];
+        ssize_t n = ::recv(fd_, discard, sizeof(discard), MSG_DONTWAIT);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            open_ = false;
+            finish();
+            return;
+        }
+    }
+
+    if (events & EPOLLOUT) {
+        flush();
+        return;
+    }
+
+    bool want_write;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        want_write = !queue_.empty();
+    }
+    rearm(want_write);
+}
+
+void SseSubscriber::finish() {
+    // Rulează o singură dată, pe thread-ul loop-ului
+    if (fd_ < 0) return;
+
+    EventLoop::instance().unwatch(fd_);
+    ::shutdown(fd_, SHUT_RDWR);
+    ::close(fd_);
+    fd_ = -1;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.clear();
+        queued_bytes_ = 0;
+    }
+
+    if (auto channel = channel_.lock()) {
+        channel->remove(this);
+    }
+
+    if (on_done_) on_done_();
+}
+
+void SseSubscriber::schedule_heartbeat(std::chrono::seconds interval) {
+    static const SseEvent heartbeat = std::make_shared<const std::string>(":\n\n");
+
+    std::weak_ptr<SseSubscriber> weak = shared_from_this();
+    EventLoop::instance().run_after(std::chrono::duration_cast<std::chrono::milliseconds>(interval),
+                                    [weak, interval]() {
+        auto sub = weak.lock();
+        if (!sub || !sub->open_) return;
+
+        // Doar dacă n-am scris nimic de un interval (proxy-urile închid conexiunile tăcute)
+        if (std::chrono::steady_clock::now() - sub->last_write_ >= interval) {
+            sub->push(heartbeat);
+        }
+        sub->schedule_heartbeat(interval);
+    });
+}
+
+// ===== SseChannel =====
+
+// Canalele existente în proces, pentru close_all_channels()
+static std::mutex channels_mutex;
+static std::set<SseChannel*> channels;
+
+SseChannel::SseChannel(const SseOptions& options) : options_(options) {
+    std::lock_guard<std::mutex> lock(channels_mutex);
+    channels.insert(this);
+}
+
+SseChannel::~SseChannel() {
+    std::lock_guard<std::mutex> lock(channels_mutex);
+    channels.erase(this);
+}
+
+void SseChannel::close_all_channels() {
+    std::lock_guard<std::mutex> lock(channels_mutex);
+    for (SseChannel* channel : channels) {
+        channel->close_all();
+    }
+}
+
+uint64_t SseChannel::publish(const std::string& data, const std::string& event) {
+    std::vector<std::shared_ptr<SseSubscriber>> to_flush;
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = next_id_++;
+
+        // Serializare o singură dată pentru toți abonații
+        SseEvent serialized = std::make_shared<const std::string>(SseProtocol::format_event(id, event, data));
+
+        if (options_.replay_capacity > 0) {
+            ring_.emplace_back(id, serialized);
+            while (ring_.size() > options_.replay_capacity) {
+                ring_.pop_front();
+            }
+        }
+
+        // Sub lock: ordinea evenimentelor e aceeași pentru toți abonații
+        for (const auto& sub : subscribers_) {
+            bool need_flush = false;
+            if (sub->enqueue(serialized, need_flush) && need_flush) {
+                to_flush.push_back(sub);
+            }
+        }
+    }
+
+    // Un singur task pe event loop pentru toți abonații, nu unul per abonat
+    if (!to_flush.empty()) {
+        EventLoop::instance().post([to_flush = std::move(to_flush)]() {
+            for (const auto& sub : to_flush) sub->flush();
+        });
+    }
+    return id;
+}
+
+void SseChannel::subscribe(int fd, const HttpRequest& request, std::function<void()> on_done,
+                           const std::string& extra_headers) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+    // Reconectare EventSource: reluăm evenimentele ratate din ring
+    uint64_t last_id = 0;
+    std::string last_header = request.getHeader("Last-Event-ID");
+    if (!last_header.empty()) {
+        last_id = std::strtoull(last_header.c_str(), nullptr, 10);
+    }
+
+    auto sub = std::make_shared<SseSubscriber>(fd, weak_from_this(), options_.max_queued_bytes, std::move(on_done));
+
+    std::string head = "HTTP/1.1 200 OK\r\n"
+                       "Content-Type: text/event-stream\r\n"
+                       "Cache-Control: no-cache\r\n"
+                       "Connection: keep-alive\r\n"
+                       "X-Accel-Buffering: no\r\n" +
+                       extra_headers +
+                       "\r\n"
+                       "retry: " + std::to_string(options_.retry_ms) + "\n\n";
+    sub->push(std::make_shared<const std::string>(std::move(head)));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (last_id > 0) {
+            for (const auto& [id, event] : ring_) {
+                if (id > last_id && !sub->push(event)) break;
+            }
+        }
+        if (sub->is_open()) {
+            subscribers_.push_back(sub);
+        }
+    }
+
+    if (sub->is_open() && options_.heartbeat.count() > 0) {
+        sub->schedule_heartbeat(options_.heartbeat);
+    }
+}
+
+void SseChannel::close_all() {
+    std::vector<std::shared_ptr<SseSubscriber>> subs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        subs = subscribers_;
+    }
+    for (auto& sub : subs) {
+        sub->close();
+    }
+}
+
+size_t SseChannel::subscriber_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return subscribers_.size();
+}
+
+uint64_t SseChannel::last_event_id() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_id_ - 1;
+}
+
+void SseChannel::remove(const SseSubscriber* subscriber) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscribers_.erase(std::remove_if(subscribers_.begin(), subscribers_.end(),
+                                      [subscriber](const std::shared_ptr<SseSubscriber>& s) {
+                                          return s.get() == subscriber;
+                                      }),
+                       subscribers_.end());
+}
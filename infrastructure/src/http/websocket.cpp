@@ -0,0 +1,641 @@
+#include "http/websocket.hpp"
+#include "core/eventloop.hpp"
+
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <strings.h>
+#include <cerrno>
+#include <iostream>
+#include <vector>
+
+static std::atomic<uint64_t> next_connection_id{1};
+
+// Conexiunile deschise din proces, pentru close_all()
+static std::mutex registry_mutex;
+static std::map<uint64_t, std::weak_ptr<WebSocketConnection>> registry;
+
+// Caută un token într-o listă separată prin virgule (case-insensitive)
+static bool header_has_token(const std::string& value, const char* token) {
+    size_t start = 0;
+    while (start <= value.size()) {
+        size_t comma = value.find(',', start);
+        if (comma == std::string::npos) comma = value.size();
+
+        size_t b = value.find_first_not_of(" \t", start);
+        size_t e = comma;
+        while (e > b && b != std::string::npos && (value[e - 1] == ' ' || value[e - 1] == '\t')) e--;
+
+        if (b != std::string::npos && b < e &&
+            strncasecmp(value.c_str() + b, token, e - b) == 0 && token[e - b] == '\0') {
+            return true;
+        }
+        start = comma + 1;
+    }
+    return false;
+}
+
+namespace WebSocketProtocol {
+
+bool is_upgrade_request(const HttpRequest& req) {
+    return header_has_token(req.getHeader("Upgrade"), "websocket") &&
+           header_has_token(req.getHeader("Connection"), "upgrade");
+}
+
+std::string accept_key(const std::string& client_key) {
+    static const char* GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    std::string source = client_key + GUID;
+
+    unsigned char digest[SHA_DIGEST_LENGTH];
+    SHA1(reinterpret_cast<const unsigned char*>(source.data()), source.size(), digest);
+
+    unsigned char encoded[4 * ((SHA_DIGEST_LENGTH + 2) / 3) + 1];
+    int n = EVP_EncodeBlock(encoded, digest, SHA_DIGEST_LENGTH);
+    return std::string(reinterpret_cast<char*>(encoded), n);
+}
+
+bool build_handshake_response(const HttpRequest& req, std::string& response) {
+    std::string key = req.getHeader("Sec-WebSocket-Key");
+
+    if (req.method != "GET" || key.empty()) {
+        response = "HTTP/1.1 400 Bad Request\r\n"
+                   "Content-Length: 0\r\n"
+                   "Connection: close\r\n\r\n";
+        return false;
+    }
+
+    if (req.getHeader("Sec-WebSocket-Version") != "13") {
+        response = "HTTP/1.1 426 Upgrade Required\r\n"
+                   "Sec-WebSocket-Version: 13\r\n"
+                   "Content-Length: 0\r\n"
+                   "Connection: close\r\n\r\n";
+        return false;
+    }
+
+    response = "HTTP/1.1 101 Switching Protocols\r\n"
+               "Upgrade: websocket\r\n"
+               "Connection: Upgrade\r\n"
+               "Sec-WebSocket-Accept: " + accept_key(key) + "\r\n\r\n";
+    return true;
+}
+
+std::string encode_frame(WebSocketOpcode opcode, const std::string& payload, bool fin) {
+    std::string frame;
+    frame.reserve(payload.size() + 10);
+    frame.push_back(static_cast<char>((fin ? 0x80 : 0x00) | static_cast<uint8_t>(opcode)));
+
+    uint64_t len = payload.size();
+    if (len < 126) {
+        frame.push_back(static_cast<char>(len));
+    } else if (len <= 0xFFFF) {
+        frame.push_back(static_cast<char>(126));
+        frame.push_back(static_cast<char>((len >> 8) & 0xFF));
+        frame.push_back(static_cast<char>(len & 0xFF));
+    } else {
+        frame.push_back(static_cast<char>(127));
+        for (int i = 7; i >= 0; --i) {
+            frame.push_back(static_cast<char>((len >> (8 * i)) & 0xFF));
+        }
+    }
+
+    frame += payload;
+    return frame;
+}
+
+bool is_valid_utf8(const std::string& data) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(data.data());
+    size_t n = data.size();
+    size_t i = 0;
+
+    while (i < n) {
+        unsigned char c = s[i];
+        size_t extra;
+        uint32_t cp;
+
+        if (c < 0x80) { i++; continue; }
+        else if ((c & 0xE0) == 0xC0) { extra = 1; cp = c & 0x1F; }
+        else if ((c & 0xF0) == 0xE0) { extra = 2; cp = c & 0x0F; }
+        else if ((c & 0xF8) == 0xF0) { extra = 3; cp = c & 0x07; }
+        else return false;
+
+        if (i + extra >= n) return false;
+        for (size_t k = 1; k <= extra; k++) {
+            if ((s[i + k] & 0xC0) != 0x80) return false;
+            cp = (cp << 6) | (s[i + k] & 0x3F);
+        }
+
+        // Overlong, surrogate sau peste U+10FFFF
+        if ((extra == 1 && cp < 0x80) || (extra == 2 && cp < 0x800) || (extra == 3 && cp < 0x10000) ||
+            (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+            return false;
+        }
+        i += extra + 1;
+    }
+    return true;
+}
+
+bool is_valid_close_code(uint16_t code) {
+    if (code >= 1000 && code <= 1003) return true;
+    if (code >= 1007 && code <= 1014) return true;
+    return code >= 3000 && code <= 4999;
+}
+
+} // namespace WebSocketProtocol
+
+// ===== WebSocketConnection =====
+
+WebSocketConnection::WebSocketConnection(int fd, std::shared_ptr<const WebSocketRoute> route,
+                                         std::function<void()> on_done)
+    : fd_(fd),
+      id_(next_connection_id++),
+      route_(std::move(route)),
+      on_done_(std::move(on_done)),
+      last_activity_(std::chrono::steady_clock::now()) {}
+
+WebSocketConnection::~WebSocketConnection() {
+    if (state_ != State::CLOSED && fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+WebSocketPtr WebSocketConnection::accept(int fd, std::shared_ptr<const WebSocketRoute> route,
+                                         const HttpRequest& request,
+                                         const RouteParams& params,
+                                         std::function<void()> on_done) {
+    // De aici socket-ul e gestionat de event loop
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+    auto conn = std::make_shared<WebSocketConnection>(fd, route, std::move(on_done));
+
+    // Clientul poate trimite frame-uri imediat după handshake (în același recv)
+    conn->in_buf_ = request.body;
+
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry[conn->id_] = conn;
+    }
+
+    if (route->handlers.on_open) {
+        try {
+            route->handlers.on_open(conn, request, params);
+        } catch (const std::exception& e) {
+            std::cerr << "[WebSocket] Eroare în on_open: " << e.what() << "\n";
+            conn->close(WebSocketClose::POLICY, "Open handler failed");
+        }
+    }
+
+    EventLoop::instance().post([conn]() {
+        if (conn->state_ == State::CLOSED) return;
+        conn->process_frames();
+        conn->rearm();
+        conn->schedule_ping();
+    });
+
+    return conn;
+}
+
+bool WebSocketConnection::send_text(const std::string& message) {
+    return enqueue(WebSocketProtocol::encode_frame(WebSocketOpcode::TEXT, message), false);
+}
+
+bool WebSocketConnection::send_binary(const std::string& data) {
+    return enqueue(WebSocketProtocol::encode_frame(WebSocketOpcode::BINARY, data), false);
+}
+
+bool WebSocketConnection::ping(const std::string& payload) {
+    return enqueue(WebSocketProtocol::encode_frame(WebSocketOpcode::PING, payload.substr(0, 125)), true);
+}
+
+bool WebSocketConnection::enqueue(const std::string& frame, bool control) {
+    bool over_limit = false;
+    bool backpressure = false;
+    {
+        std::lock_guard<std::mutex> lock(out_mutex_);
+        State state = state_.load();
+        if (state == State::CLOSED || (state == State::CLOSING && !control)) {
+            return false;
+        }
+
+        if (out_buf_.size() + frame.size() > route_->options.max_buffered) {
+            over_limit = true;
+        } else {
+            out_buf_ += frame;
+            buffered_ = out_buf_.size();
+            backpressure = out_buf_.size() > route_->options.high_water_mark;
+            if (backpressure) drain_pending_ = true;
+        }
+    }
+
+    if (over_limit) {
+        // Clientul nu citește: nu mai acumulăm, închidem conexiunea
+        auto self = shared_from_this();
+        EventLoop::instance().post([self]() { self->finish(WebSocketClose::POLICY); });
+        return false;
+    }
+
+    schedule_flush();
+    return !backpressure;
+}
+
+void WebSocketConnection::schedule_flush() {
+    {
+        std::lock_guard<std::mutex> lock(out_mutex_);
+        if (flush_scheduled_) return;
+        flush_scheduled_ = true;
+    }
+    // Mai multe send() consecutive ajung pe socket într-un singur flush
+    auto self = shared_from_this();
+    EventLoop::instance().post([self]() { self->flush(); });
+}
+
+void WebSocketConnection::flush() {
+    if (state_ == State::CLOSED) return;
+
+    bool failed = false;
+    bool drained = false;
+    bool close_now = false;
+    {
+        std::lock_guard<std::mutex> lock(out_mutex_);
+        flush_scheduled_ = false;
+
+        size_t sent = 0;
+        while (sent < out_buf_.size()) {
+            ssize_t n = ::send(fd_, out_buf_.data() + sent, out_buf_.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (n > 0) {
+                sent += static_cast<size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            failed = true;
+            break;
+        }
+        out_buf_.erase(0, sent);
+        buffered_ = out_buf_.size();
+
+        if (drain_pending_ && out_buf_.size() <= route_->options.low_water_mark) {
+            drain_pending_ = false;
+            drained = true;
+        }
+        close_now = close_after_flush_ && out_buf_.empty();
+    }
+
+    if (failed) {
+        finish(WebSocketClose::ABNORMAL);
+        return;
+    }
+    if (close_now) {
+        finish(close_code_);
+        return;
+    }
+    if (drained && route_->handlers.on_drain) {
+        try {
+            route_->handlers.on_drain(shared_from_this());
+        } catch (const std::exception& e) {
+            std::cerr << "[WebSocket] Eroare în on_drain: " << e.what() << "\n";
+        }
+    }
+    rearm();
+}
+
+void WebSocketConnection::rearm() {
+    if (state_ == State::CLOSED) return;
+
+    bool want_write;
+    {
+        std::lock_guard<std::mutex> lock(out_mutex_);
+        want_write = !out_buf_.empty();
+    }
+
+    // Backpressure: nu mai citim de la client cât timp are mult de primit
+    reading_paused_ = buffered_.load() > route_->options.high_water_mark;
+
+    uint32_t interest = 0;
+    if (!reading_paused_) interest |= EPOLLIN | EPOLLRDHUP;
+    if (want_write) interest |= EPOLLOUT;
+    if (interest == 0) return;
+
+    auto self = shared_from_this();
+    EventLoop::instance().watch_once(fd_, interest, [self](uint32_t events) {
+        self->on_events(events);
+    });
+}
+
+void WebSocketConnection::on_events(uint32_t events) {
+    if (state_ == State::CLOSED) return;
+
+    if (events & EPOLLERR) {
+        finish(WebSocketClose::ABNORMAL);
+        return;
+    }
+
+    if (events & EPOLLIN) {
+        read_available();
+        if (state_ == State::CLOSED) return;
+    } else if (events & (EPOLLHUP | EPOLLRDHUP)) {
+        // Peer-ul a dispărut fără close frame
+        finish(WebSocketClose::ABNORMAL);
+        return;
+    }
+
+    if (events & EPOLLOUT) {
+        flush();  // flush() rearmează
+    } else {
+        rearm();
+    }
+}
+
+void WebSocketConnection::read_available() {
+    char buffer[16384];
+    size_t budget = 256 * 1024;  // Nu monopolizăm loop-ul cu o singură conexiune
+
+    while (budget > 0) {
+        ssize_t n = ::recv(fd_, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n > 0) {
+            in_buf_.append(buffer, static_cast<size_t>(n));
+            budget = budget > static_cast<size_t>(n) ? budget - n : 0;
+            continue;
+        }
+        if (n == 0) {
+            process_frames();
+            if (state_ != State::CLOSED) finish(WebSocketClose::ABNORMAL);
+            return;
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+
+        finish(WebSocketClose::ABNORMAL);
+        return;
+    }
+
+    last_activity_ = std::chrono::steady_clock::now();
+    process_frames();
+}
+
+void WebSocketConnection::process_frames() {
+    size_t pos = 0;
+
+    while (state_ != State::CLOSED) {
+        size_t avail = in_buf_.size() - pos;
+        if (avail < 2) break;
+
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(in_buf_.data()) + pos;
+        bool fin = (p[0] & 0x80) != 0;
+        uint8_t rsv = p[0] & 0x70;
+        uint8_t opcode = p[0] & 0x0F;
+        bool masked = (p[1] & 0x80) != 0;
+        uint64_t len = p[1] & 0x7F;
+        size_t header = 2;
+
+        if (len == 126) {
+            if (avail < 4) break;
+            len = (static_cast<uint64_t>(p[2]) << 8) | p[3];
+            header = 4;
+        } else if (len == 127) {
+            if (avail < 10) break;
+            len = 0;
+            for (int i = 0; i < 8; i++) len = (len << 8) | p[2 + i];
+            header = 10;
+        }
+
+        if (rsv != 0) {
+            fail(WebSocketClose::PROTOCOL_ERROR, "Reserved bits set");
+            break;
+        }
+        if (!masked) {
+            fail(WebSocketClose::PROTOCOL_ERROR, "Client frames must be masked");
+            break;
+        }
+        // Frame-urile de control (close, ping, pong) nu se fragmentează și au cel mult 125 de octeți
+        if (opcode >= 0x8 && (!fin || len > 125)) {
+            fail(WebSocketClose::PROTOCOL_ERROR, "Invalid control frame");
+            break;
+        }
+        if (len > route_->options.max_message_size) {
+            fail(WebSocketClose::TOO_BIG, "Frame too large");
+            break;
+        }
+        if (avail < header + 4 + len) break;  // Frame incomplet, așteptăm
+
+        const uint8_t* mask = p + header;
+        std::string payload(reinterpret_cast<const char*>(p + header + 4), static_cast<size_t>(len));
+        for (size_t i = 0; i < payload.size(); i++) {
+            payload[i] = static_cast<char>(payload[i] ^ mask[i % 4]);
+        }
+
+        pos += header + 4 + static_cast<size_t>(len);
+        handle_frame(static_cast<WebSocketOpcode>(opcode), fin, std::move(payload));
+    }
+
+    if (state_ == State::CLOSED) {
+        in_buf_.clear();
+    } else {
+        in_buf_.erase(0, pos);
+    }
+}
+
+void WebSocketConnection::handle_frame(WebSocketOpcode opcode, bool fin, std::string payload) {
+    auto self = shared_from_this();
+
+    switch (opcode) {
+        case WebSocketOpcode::CLOSE: {
+            if (payload.size() == 1) {
+                fail(WebSocketClose::PROTOCOL_ERROR, "Invalid close frame");
+                return;
+            }
+            uint16_t code = WebSocketClose::NO_STATUS;
+            if (payload.size() >= 2) {
+                code = static_cast<uint16_t>((static_cast<uint8_t>(payload[0]) << 8) |
+                                             static_cast<uint8_t>(payload[1]));
+                // Un cod rezervat nu se trimite înapoi ca ecou
+                if (!WebSocketProtocol::is_valid_close_code(code)) {
+                    fail(WebSocketClose::PROTOCOL_ERROR, "Invalid close code");
+                    return;
+                }
+                if (!WebSocketProtocol::is_valid_utf8(payload.substr(2))) {
+                    fail(WebSocketClose::INVALID_DATA, "Invalid UTF-8 in close reason");
+                    return;
+                }
+            }
+
+            if (state_ == State::CLOSING) {
+                // Răspunsul la close-ul inițiat de noi
+                finish(code);
+                return;
+            }
+
+            // Close inițiat de client: răspundem cu același cod, apoi închidem
+            state_ = State::CLOSING;
+            std::string reply;
+            if (code != WebSocketClose::NO_STATUS) reply = payload.substr(0, 2);
+            {
+                std::lock_guard<std::mutex> lock(out_mutex_);
+                close_after_flush_ = true;
+                close_code_ = code;
+            }
+            enqueue(WebSocketProtocol::encode_frame(WebSocketOpcode::CLOSE, reply), true);
+            return;
+        }
+
+        case WebSocketOpcode::PING:
+            enqueue(WebSocketProtocol::encode_frame(WebSocketOpcode::PONG, payload), true);
+            return;
+
+        case WebSocketOpcode::PONG:
+            return;  // last_activity_ a fost deja actualizat
+
+        case WebSocketOpcode::TEXT:
+        case WebSocketOpcode::BINARY:
+            if (message_opcode_ != WebSocketOpcode::CONTINUATION) {
+                fail(WebSocketClose::PROTOCOL_ERROR, "Expected continuation frame");
+                return;
+            }
+            if (!fin) {
+                // Primul fragment: începem reasamblarea
+                message_ = std::move(payload);
+                message_opcode_ = opcode;
+                return;
+            }
+            break;
+
+        case WebSocketOpcode::CONTINUATION:
+            if (message_opcode_ == WebSocketOpcode::CONTINUATION) {
+                fail(WebSocketClose::PROTOCOL_ERROR, "Unexpected continuation frame");
+                return;
+            }
+            if (message_.size() + payload.size() > route_->options.max_message_size) {
+                fail(WebSocketClose::TOO_BIG, "Message too large");
+                return;
+            }
+            message_ += payload;
+            if (!fin) return;
+
+            payload = std::move(message_);
+            message_.clear();
+            opcode = message_opcode_;
+            message_opcode_ = WebSocketOpcode::CONTINUATION;
+            break;
+
+        default:
+            fail(WebSocketClose::PROTOCOL_ERROR, "Unknown opcode");
+            return;
+    }
+
+    // Mesaj complet
+    if (opcode == WebSocketOpcode::TEXT && !WebSocketProtocol::is_valid_utf8(payload)) {
+        fail(WebSocketClose::INVALID_DATA, "Invalid UTF-8");
+        return;
+    }
+
+    if (route_->handlers.on_message) {
+        try {
+            route_->handlers.on_message(self, payload, opcode == WebSocketOpcode::BINARY);
+        } catch (const std::exception& e) {
+            std::cerr << "[WebSocket] Eroare în on_message: " << e.what() << "\n";
+        }
+    }
+}
+
+void WebSocketConnection::close(uint16_t code, const std::string& reason) {
+    auto self = shared_from_this();
+
+    EventLoop::instance().post([self, code, reason]() {
+        State expected = State::OPEN;
+        if (!self->state_.compare_exchange_strong(expected, State::CLOSING)) return;
+
+        std::string payload;
+        payload.push_back(static_cast<char>((code >> 8) & 0xFF));
+        payload.push_back(static_cast<char>(code & 0xFF));
+        payload += reason.substr(0, 123);
+
+        {
+            std::lock_guard<std::mutex> lock(self->out_mutex_);
+            self->close_code_ = code;
+        }
+        self->enqueue(WebSocketProtocol::encode_frame(WebSocketOpcode::CLOSE, payload), true);
+
+        // Așteptăm close-ul clientului cel mult 5s
+        std::weak_ptr<WebSocketConnection> weak = self;
+        EventLoop::instance().run_after(std::chrono::seconds(5), [weak, code]() {
+            if (auto conn = weak.lock()) conn->finish(code);
+        });
+    });
+}
+
+void WebSocketConnection::close_all(uint16_t code, const std::string& reason) {
+    std::vector<WebSocketPtr> open;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for (const auto& [id, weak] : registry) {
+            if (auto conn = weak.lock()) open.push_back(conn);
+        }
+    }
+    for (const auto& conn : open) {
+        conn->close(code, reason);
+    }
+}
+
+void WebSocketConnection::fail(uint16_t code, const std::string& reason) {
+    if (state_ == State::CLOSED) return;
+    std::cerr << "[WebSocket] Conexiune " << id_ << " închisă: " << reason << "\n";
+
+    // Eroare de protocol: trimitem close și închidem fără să mai așteptăm răspuns
+    state_ = State::CLOSING;
+    std::string payload;
+    payload.push_back(static_cast<char>((code >> 8) & 0xFF));
+    payload.push_back(static_cast<char>(code & 0xFF));
+    payload += reason.substr(0, 123);
+    {
+        std::lock_guard<std::mutex> lock(out_mutex_);
+        close_after_flush_ = true;
+        close_code_ = code;
+    }
+    enqueue(WebSocketProtocol::encode_frame(WebSocketOpcode::CLOSE, payload), true);
+}
+
+void WebSocketConnection::finish(uint16_t code) {
+    if (state_.exchange(State::CLOSED) == State::CLOSED) return;
+
+    auto self = shared_from_this();
+    EventLoop::instance().unwatch(fd_);
+    ::shutdown(fd_, SHUT_RDWR);
+    ::close(fd_);
+
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.erase(id_);
+    }
+
+    if (route_->handlers.on_close) {
+        try {
+            route_->handlers.on_close(self, code);
+        } catch (const std::exception& e) {
+            std::cerr << "[WebSocket] Eroare în on_close: " << e.what() << "\n";
+        }
+    }
+
+    if (on_done_) on_done_();
+}
+
+void WebSocketConnection::schedule_ping() {
+    auto interval = route_->options.ping_interval;
+    if (interval.count() <= 0) return;
+
+    std::weak_ptr<WebSocketConnection> weak = shared_from_this();
+    EventLoop::instance().run_after(std::chrono::duration_cast<std::chrono::milliseconds>(interval), [weak, interval]() {
+        auto conn = weak.lock();
+        if (!conn || conn->state_ != State::OPEN) return;
+
+        // Niciun frame (nici pong) în două intervale: clientul e mort
+        if (std::chrono::steady_clock::now() - conn->last_activity_ > 2 * interval) {
+            conn->finish(WebSocketClose::ABNORMAL);
+            return;
+        }
+        conn->ping();
+        conn->schedule_ping();
+    });
+}
@@ -0,0 +1,122 @@
+#include "ipc/fdchannel.hpp"
+
+#include <sys/socket.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <stdexcept>
+
+FdChannel::FdChannel() : send_fd_(-1), recv_fd_(-1) {}
+
+FdChannel::~FdChannel() {
+    close();
+}
+
+void FdChannel::create() {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, fds) < 0) {
+        perror("socketpair");
+        throw std::runtime_error("Failed to create fd channel");
+    }
+    send_fd_ = fds[0];
+    recv_fd_ = fds[1];
+
+    // Loc pentru rafale de conexiuni cât timp workers sunt ocupați
+    int size = 1024 * 1024;
+    setsockopt(send_fd_, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    setsockopt(recv_fd_, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+}
+
+bool FdChannel::send(int fd, uint32_t tag, int64_t stamp, const PeerAddress* peer) {
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+
+    Message message;
+    std::memset(static_cast<void*>(&message), 0, sizeof(message));
+    message.tag = tag;
+    message.stamp = stamp;
+    if (peer) message.peer = *peer;
+
+    struct iovec iov;
+    iov.iov_base = &message;
+    iov.iov_len = sizeof(message);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    std::memset(control, 0, sizeof(control));
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+    while (true) {
+        ssize_t n = sendmsg(send_fd_, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n >= 0) return true;
+        if (errno == EINTR) continue;
+        return false;
+    }
+}
+
+int FdChannel::receive(uint32_t& tag, int timeout_ms, int64_t* stamp, PeerAddress* peer) {
+    struct pollfd pfd;
+    pfd.fd = recv_fd_;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int ready = poll(&pfd, 1, timeout_ms);
+    if (ready <= 0) return -1;
+
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+
+    Message message;
+    std::memset(static_cast<void*>(&message), 0, sizeof(message));
+
+    struct iovec iov;
+    iov.iov_base = &message;
+    iov.iov_len = sizeof(message);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    // Mai mulți workers pot fi treziți de același mesaj: doar unul îl primește
+    ssize_t n = recvmsg(recv_fd_, &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+    if (n <= 0) return -1;
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+        return -1;
+    }
+
+    int fd;
+    std::memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+    tag = message.tag;
+    if (stamp) *stamp = message.stamp;
+    if (peer) *peer = message.peer;
+    return fd;
+}
+
+void FdChannel::close_sender() {
+    if (send_fd_ >= 0) {
+        ::close(send_fd_);
+        send_fd_ = -1;
+    }
+}
+
+void FdChannel::close() {
+    close_sender();
+    if (recv_fd_ >= 0) {
+        ::close(recv_fd_);
+        recv_fd_ = -1;
+    }
+}
@@ -0,0 +1,60 @@
+#include "sync/singleflight.hpp"
+
+std::string SingleFlight::run(const std::string& key, const std::function<std::string()>& compute,
+                              bool* shared) {
+    std::shared_ptr<Call> call;
+    bool leader = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = calls_.find(key);
+        if (it == calls_.end()) {
+            call = std::make_shared<Call>();
+            calls_.emplace(key, call);
+            leader = true;
+        } else {
+            call = it->second;
+            call->waiters++;
+        }
+    }
+
+    if (!leader) {
+        // Așteaptă rezultatul leader-ului
+        std::unique_lock<std::mutex> lock(call->mutex);
+        call->done_cv.wait(lock, [&] { return call->done; });
+        if (shared) *shared = true;
+        if (call->error) std::rethrow_exception(call->error);
+        return call->result;
+    }
+
+    std::string result;
+    std::exception_ptr error;
+    try {
+        result = compute();
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    // Scoate cheia înainte de notificare: cine vine de acum calculează din nou
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        calls_.erase(key);
+    }
+    {
+        std::lock_guard<std::mutex> lock(call->mutex);
+        if (call->waiters > 0) {
+            call->result = result;  // Copie doar dacă cineva așteaptă
+        }
+        call->error = error;
+        call->done = true;
+    }
+    call->done_cv.notify_all();
+
+    if (shared) *shared = false;
+    if (error) std::rethrow_exception(error);
+    return result;
+}
+
+size_t SingleFlight::in_flight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return calls_.size();
+}